@@ -304,7 +304,8 @@ int runApplication(const CmdLineParser& parser) {
                         << "  <div class=\"terminal-body\">\n"
                         << "    <pre>";
 
-                    for (const auto& row : fb->getBuffer()) {
+                    for (int y = 0; y < fb->getHeight(); ++y) {
+                        std::string_view row = fb->getRow(y);
                         // Escape HTML characters
                         for (char c : row) {
                             if (c == '<') out << "&lt;";
@@ -135,6 +135,8 @@ void AnalyticsEngine::drawAnalyticsPanelOverlay(const Graph& g) {
 
     GraphSummary s;
     runFullAnalysis(g, s);
+    s.timeToLoadMs = g.summary.timeToLoadMs;
+    s.timeToRenderMs = g.summary.timeToRenderMs;
 
     std::cout << "\n==== ANALYTICS OVERLAY ====\n";
     std::cout << "Nodes: " << s.totalNodes << " | Edges: " << s.totalEdges << "\n";
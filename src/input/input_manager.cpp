@@ -23,8 +23,22 @@ void InputManager::processMouse(ViewContext& view, int x, int y, bool leftButton
             view.pan(dx, dy);
         }
     }
+    if (rightButton && pickIndex_) {
+        pickedNode_ = pickNode(view, x, y);
+    }
     lastMouseX_ = x;
     lastMouseY_ = y;
 }
 
+int InputManager::pickNode(const ViewContext& view, int x, int y) const {
+    if (!pickIndex_) return -1;
+    // A screen cell covers [cell - pan, cell + 1 - pan) in layout space. Cast through its
+    // center along increasing depth, wide enough to reach the cell corners.
+    const float kPickNear = 1024.0f;
+    const float kPickRadius = 0.75f;
+    render::SpatialRay ray{x - view.panX + 0.5f, y - view.panY + 0.5f, -kPickNear, 0.0f, 0.0f, 1.0f};
+    render::SpatialHit hit;
+    return pickIndex_->raycast(ray, kPickRadius, hit) ? hit.nodeId : -1;
+}
+
 } // namespace input
@@ -2,6 +2,7 @@
 #define INPUT_MANAGER_H
 
 #include "../map_logic.h"
+#include "../render/spatial_index.h"
 
 namespace input {
 
@@ -15,9 +16,18 @@ public:
     // Process mouse movement/clicks
     void processMouse(ViewContext& view, int x, int y, bool leftButton, bool rightButton);
 
+    // Index over the drawn nodes, as built by OctreeIndex::buildFromLayout; enables
+    // right-click picking. Not owned.
+    void setPickIndex(const render::SpatialIndex* index) { pickIndex_ = index; }
+    // Front-most node drawn at the screen cell, or -1.
+    int pickNode(const ViewContext& view, int x, int y) const;
+    int getPickedNode() const { return pickedNode_; }
+
 private:
     int lastMouseX_ = -1;
     int lastMouseY_ = -1;
+    const render::SpatialIndex* pickIndex_ = nullptr;
+    int pickedNode_ = -1;
 };
 
 } // namespace input
@@ -19,21 +19,28 @@ void ShortcutManager::registerAction(const std::string& actionId, std::function<
 
 void ShortcutManager::loadFromXml(const std::string& filepath) {
     auto root = io::XmlParser::loadFile(filepath);
-    for (const auto& node : root.children) {
-        if (node.name == "Command") {
-            std::string keyStr = node.attributes.count("key") ? node.attributes.at("key") : "";
-            std::string actionId = node.attributes.count("action") ? node.attributes.at("action") : "";
-            std::string desc = node.attributes.count("description") ? node.attributes.at("description") : "";
+    // Commands live under the document element (<Rules>); accept them at top level too.
+    std::vector<const io::XmlNode*> commands;
+    for (const auto& top : root.children) {
+        if (top.name == "Command") commands.push_back(&top);
+        for (const auto& child : top.children) {
+            if (child.name == "Command") commands.push_back(&child);
+        }
+    }
+    for (const io::XmlNode* node : commands) {
+        const auto& attrs = node->attributes;
+        std::string keyStr = attrs.count("key") ? attrs.at("key") : "";
+        std::string actionId = attrs.count("action") ? attrs.at("action") : "";
+        std::string desc = attrs.count("description") ? attrs.at("description") : "";
 
-            if (keyStr.empty() || actionId.empty()) continue;
+        if (keyStr.empty() || actionId.empty()) continue;
 
-            char keyChar = 0;
-            if (keyStr == "TAB") keyChar = '\t';
-            else if (keyStr.length() == 1) keyChar = keyStr[0];
+        char keyChar = 0;
+        if (keyStr == "TAB") keyChar = '\t';
+        else if (keyStr.length() == 1) keyChar = keyStr[0];
 
-            if (keyChar != 0 && registeredActions_.count(actionId)) {
-                registerShortcut(keyChar, desc, registeredActions_.at(actionId));
-            }
+        if (keyChar != 0 && registeredActions_.count(actionId)) {
+            registerShortcut(keyChar, desc, registeredActions_.at(actionId));
         }
     }
 }
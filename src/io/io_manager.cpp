@@ -1,5 +1,6 @@
 #include "io_manager.h"
 #include "../logger.h"
+#include "../render/edge_lod.h"
 #include <fstream>
 #include <iostream>
 #include <set>
@@ -9,10 +10,13 @@
 #include <sstream>
 #include <chrono>
 #include <mutex>
+#include <cmath>
 
 namespace io {
 
 static StorageBackend* g_backend = nullptr;
+// Edge bundling cell for SVG export, in output pixels.
+static constexpr float kSvgEdgeCell = 4.0f;
 static std::mutex g_backend_mutex;
 
 void IOManager::setBackend(StorageBackend* backend) {
@@ -222,21 +226,27 @@ bool IOManager::exportSVG(const Graph& graph, const std::string& filepath) {
     float offsetX = 600 - (minX + maxX) * (scale / 2.0f);
     float offsetY = 400 - (minY + maxY) * (scale / 2.0f);
 
-    // Draw Edges
+    // Draw Edges, bundled per pair of kSvgEdgeCell-pixel cells so dense graphs stay small
+    render::EdgeLod lod(kSvgEdgeCell);
     for (const auto& node : graph.nodes) {
-        if (graph.layoutPositions.count(node.index) == 0) continue;
-        const auto& p1 = graph.layoutPositions.at(node.index);
+        auto from = graph.layoutPositions.find(node.index);
+        if (from == graph.layoutPositions.end()) continue;
+        const auto& p1 = from->second;
 
         for (int neighbor_id : node.neighbors) {
-            if (graph.layoutPositions.count(neighbor_id) == 0) continue;
             if (node.index > neighbor_id) continue; // Draw each edge once
-            const auto& p2 = graph.layoutPositions.at(neighbor_id);
-
-            file << "  <line x1=\"" << offsetX + p1.x * scale << "\" y1=\"" << offsetY + p1.y * scale
-                 << "\" x2=\"" << offsetX + p2.x * scale << "\" y2=\"" << offsetY + p2.y * scale
-                 << "\" stroke=\"#555\" stroke-width=\"2\" />\n";
+            auto to = graph.layoutPositions.find(neighbor_id);
+            if (to == graph.layoutPositions.end()) continue;
+            const auto& p2 = to->second;
+            lod.add(offsetX + p1.x * scale, offsetY + p1.y * scale, offsetX + p2.x * scale, offsetY + p2.y * scale);
         }
     }
+    for (const auto& bundle : lod.bundles()) {
+        float width = 2.0f + std::log2(static_cast<float>(bundle.count));
+        file << "  <line x1=\"" << bundle.x1 << "\" y1=\"" << bundle.y1
+             << "\" x2=\"" << bundle.x2 << "\" y2=\"" << bundle.y2
+             << "\" stroke=\"#555\" stroke-width=\"" << width << "\" />\n";
+    }
 
     // Draw Nodes
     for (const auto& node : graph.nodes) {
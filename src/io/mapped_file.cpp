@@ -0,0 +1,52 @@
+#include "mapped_file.h"
+#include <fstream>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace io {
+
+MappedFile::MappedFile(const std::string& filepath) {
+#ifndef _WIN32
+    int fd = ::open(filepath.c_str(), O_RDONLY);
+    if (fd < 0) return;
+    struct stat st;
+    if (::fstat(fd, &st) == 0) {
+        size_ = static_cast<size_t>(st.st_size);
+        if (size_ == 0) {
+            open_ = true;
+        } else {
+            void* addr = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (addr != MAP_FAILED) {
+                ::madvise(addr, size_, MADV_SEQUENTIAL);
+                data_ = static_cast<const char*>(addr);
+                mapped_ = true;
+                open_ = true;
+            }
+        }
+    }
+    ::close(fd);
+    if (open_) return;
+#endif
+    std::ifstream file(filepath, std::ios::binary);
+    if (!file.is_open()) return;
+    file.seekg(0, std::ios::end);
+    fallback_.resize(static_cast<size_t>(file.tellg()));
+    file.seekg(0, std::ios::beg);
+    file.read(&fallback_[0], fallback_.size());
+    data_ = fallback_.data();
+    size_ = fallback_.size();
+    open_ = true;
+}
+
+MappedFile::~MappedFile() {
+#ifndef _WIN32
+    if (mapped_) ::munmap(const_cast<char*>(data_), size_);
+#endif
+}
+
+} // namespace io
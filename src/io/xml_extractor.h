@@ -1,7 +1,9 @@
 #ifndef XML_EXTRACTOR_H
 #define XML_EXTRACTOR_H
 
+#include "xml_parser.h"
 #include <string>
+#include <string_view>
 #include <vector>
 #include <set>
 
@@ -9,32 +11,47 @@ namespace io {
 
 class XmlExtractor {
 public:
-    static std::set<std::string> extractMeshTerms(const std::string& xml) {
-        std::set<std::string> terms;
-        std::string tagStart = "<DescriptorName";
-        std::string tagEnd = "</DescriptorName>";
+    // Streams the document once, collecting the text of every <DescriptorName>.
+    static std::set<std::string> extractMeshTerms(std::string_view xml) {
+        MeshTermCollector collector;
+        XmlParser::parse(xml, collector);
+        return std::move(collector.terms);
+    }
 
-        size_t pos = 0;
-        while ((pos = xml.find(tagStart, pos)) != std::string::npos) {
-            size_t contentStart = xml.find('>', pos);
-            if (contentStart == std::string::npos) break;
-            contentStart++;
+private:
+    class MeshTermCollector : public XmlSaxHandler {
+    public:
+        std::set<std::string> terms;
 
-            size_t contentEnd = xml.find(tagEnd, contentStart);
-            if (contentEnd == std::string::npos) break;
+        void onStartElement(std::string_view name, const std::vector<XmlAttribute>&) override {
+            if (name == "DescriptorName") {
+                if (depth_++ == 0) current_.clear();
+            } else if (depth_ > 0) {
+                ++depth_;
+            }
+        }
 
-            std::string term = xml.substr(contentStart, contentEnd - contentStart);
-            // Basic trim
+        void onEndElement(std::string_view) override {
+            if (depth_ == 0 || --depth_ > 0) return;
+            std::string_view term(current_);
             size_t first = term.find_first_not_of(" \t\r\n");
-            if (first != std::string::npos) {
-                size_t last = term.find_last_not_of(" \t\r\n");
-                terms.insert(term.substr(first, (last - first + 1)));
-            }
+            if (first == std::string_view::npos) return;
+            size_t last = term.find_last_not_of(" \t\r\n");
+            terms.insert(std::string(term.substr(first, last - first + 1)));
+        }
 
-            pos = contentEnd + tagEnd.size();
+        void onText(std::string_view text) override {
+            if (depth_ > 0) current_ += XmlParser::decodeEntities(text);
         }
-        return terms;
-    }
+
+        void onCData(std::string_view text) override {
+            if (depth_ > 0) current_.append(text);
+        }
+
+    private:
+        int depth_ = 0;
+        std::string current_;
+    };
 };
 
 } // namespace io
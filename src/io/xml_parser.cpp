@@ -2,9 +2,58 @@
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <cstring>
 
 namespace io {
 
+namespace {
+
+inline bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+inline bool isNameEnd(char c) {
+    return isSpace(c) || c == '>' || c == '/' || c == '=';
+}
+
+// Builds the owning tree from the SAX stream.
+class TreeBuilder : public XmlSaxHandler {
+public:
+    explicit TreeBuilder(XmlNode& root) { stack_.push_back(&root); }
+
+    void onStartElement(std::string_view name, const std::vector<XmlAttribute>& attributes) override {
+        XmlNode& parent = *stack_.back();
+        parent.children.emplace_back();
+        XmlNode& node = parent.children.back();
+        node.name.assign(name);
+        for (const auto& attr : attributes) {
+            node.attributes[std::string(attr.name)] = XmlParser::decodeEntities(attr.value);
+        }
+        stack_.push_back(&node);
+    }
+
+    void onEndElement(std::string_view) override {
+        if (stack_.size() > 1) stack_.pop_back();
+    }
+
+    void onText(std::string_view text) override {
+        bool blank = true;
+        for (char c : text) {
+            if (!isSpace(c)) { blank = false; break; }
+        }
+        if (!blank) stack_.back()->text += XmlParser::decodeEntities(text);
+    }
+
+    void onCData(std::string_view text) override {
+        stack_.back()->text.append(text);
+    }
+
+private:
+    std::vector<XmlNode*> stack_;
+};
+
+} // namespace
+
 XmlNode XmlParser::loadFile(const std::string& filepath) {
     std::ifstream file(filepath);
     if (!file.is_open()) return {};
@@ -16,57 +65,158 @@ XmlNode XmlParser::loadFile(const std::string& filepath) {
 XmlNode XmlParser::parse(const std::string& xml) {
     XmlNode root;
     root.name = "Root";
+    TreeBuilder builder(root);
+    parse(std::string_view(xml), builder);
+    return root;
+}
 
-    size_t pos = 0;
-    while ((pos = xml.find("<", pos)) != std::string::npos) {
-        if (xml[pos + 1] == '?' || xml[pos + 1] == '!') {
-            pos = xml.find(">", pos);
+bool XmlParser::parse(std::string_view xml, XmlSaxHandler& handler) {
+    const char* p = xml.data();
+    const char* end = p + xml.size();
+    std::vector<XmlAttribute> attrs;
+
+    auto skipPast = [&](const char* from, std::string_view terminator) -> const char* {
+        std::string_view rest(from, end - from);
+        size_t at = rest.find(terminator);
+        return at == std::string_view::npos ? nullptr : from + at + terminator.size();
+    };
+
+    while (p < end) {
+        const char* lt = static_cast<const char*>(std::memchr(p, '<', end - p));
+        if (!lt) lt = end;
+        if (lt > p) handler.onText(std::string_view(p, lt - p));
+        if (lt == end) break;
+        p = lt + 1;
+        if (p >= end) return false;
+
+        if (*p == '?') {
+            p = skipPast(p, "?>");
+            if (!p) return false;
             continue;
         }
 
-        size_t tagEnd = xml.find(">", pos);
-        if (tagEnd == std::string::npos) break;
-
-        std::string fullTag = xml.substr(pos + 1, tagEnd - pos - 1);
+        if (*p == '!') {
+            std::string_view rest(p, end - p);
+            if (rest.compare(0, 3, "!--") == 0) {
+                p = skipPast(p + 3, "-->");
+            } else if (rest.compare(0, 8, "![CDATA[") == 0) {
+                const char* body = p + 8;
+                p = skipPast(body, "]]>");
+                if (p) handler.onCData(std::string_view(body, p - 3 - body));
+            } else {
+                // DOCTYPE and friends; step over any internal subset.
+                int bracket = 0;
+                while (p < end && (*p != '>' || bracket > 0)) {
+                    if (*p == '[') ++bracket;
+                    else if (*p == ']') --bracket;
+                    ++p;
+                }
+                p = (p < end) ? p + 1 : nullptr;
+            }
+            if (!p) return false;
+            continue;
+        }
 
-        // Handle closing tags
-        if (fullTag[0] == '/') {
-            pos = tagEnd + 1;
+        if (*p == '/') {
+            const char* nameStart = ++p;
+            while (p < end && !isNameEnd(*p)) ++p;
+            std::string_view name(nameStart, p - nameStart);
+            while (p < end && *p != '>') ++p;
+            if (p >= end) return false;
+            ++p;
+            handler.onEndElement(name);
             continue;
         }
 
-        XmlNode node;
-        size_t spacePos = fullTag.find(" ");
-        if (spacePos == std::string::npos) {
-            node.name = fullTag;
-        } else {
-            node.name = fullTag.substr(0, spacePos);
-            std::string attrs = fullTag.substr(spacePos + 1);
-
-            // Basic attribute parsing
-            size_t attrPos = 0;
-            while ((attrPos = attrs.find("=", attrPos)) != std::string::npos) {
-                size_t keyStart = attrs.find_last_of(" ", attrPos);
-                if (keyStart == std::string::npos) keyStart = 0;
-                else keyStart++;
-
-                std::string key = attrs.substr(keyStart, attrPos - keyStart);
-                size_t valStart = attrs.find("\"", attrPos);
-                if (valStart == std::string::npos) break;
-                valStart++;
-                size_t valEnd = attrs.find("\"", valStart);
-                if (valEnd == std::string::npos) break;
-
-                node.attributes[key] = attrs.substr(valStart, valEnd - valStart);
-                attrPos = valEnd + 1;
+        const char* nameStart = p;
+        while (p < end && !isNameEnd(*p)) ++p;
+        std::string_view name(nameStart, p - nameStart);
+        if (name.empty()) return false;
+
+        attrs.clear();
+        bool selfClosing = false;
+        while (true) {
+            while (p < end && isSpace(*p)) ++p;
+            if (p >= end) return false;
+            if (*p == '>') { ++p; break; }
+            if (*p == '/') {
+                if (p + 1 >= end || p[1] != '>') return false;
+                selfClosing = true;
+                p += 2;
+                break;
             }
+
+            const char* keyStart = p;
+            while (p < end && !isNameEnd(*p)) ++p;
+            std::string_view key(keyStart, p - keyStart);
+            while (p < end && isSpace(*p)) ++p;
+            if (key.empty() || p >= end || *p != '=') return false;
+            ++p;
+            while (p < end && isSpace(*p)) ++p;
+            if (p >= end || (*p != '"' && *p != '\'')) return false;
+            char quote = *p++;
+            const char* valEnd = static_cast<const char*>(std::memchr(p, quote, end - p));
+            if (!valEnd) return false;
+            attrs.push_back({key, std::string_view(p, valEnd - p)});
+            p = valEnd + 1;
         }
 
-        root.children.push_back(node);
-        pos = tagEnd + 1;
+        handler.onStartElement(name, attrs);
+        if (selfClosing) handler.onEndElement(name);
     }
+    return true;
+}
 
-    return root;
+std::string XmlParser::decodeEntities(std::string_view text) {
+    size_t amp = text.find('&');
+    if (amp == std::string_view::npos) return std::string(text);
+
+    std::string out;
+    out.reserve(text.size());
+    size_t pos = 0;
+    while (amp != std::string_view::npos) {
+        out.append(text.substr(pos, amp - pos));
+        size_t semi = text.find(';', amp);
+        if (semi == std::string_view::npos) { pos = amp; break; }
+        std::string_view ent = text.substr(amp + 1, semi - amp - 1);
+        if (ent == "amp") out += '&';
+        else if (ent == "lt") out += '<';
+        else if (ent == "gt") out += '>';
+        else if (ent == "quot") out += '"';
+        else if (ent == "apos") out += '\'';
+        else if (ent.size() > 1 && ent[0] == '#') {
+            unsigned long code = 0;
+            try {
+                code = (ent[1] == 'x' || ent[1] == 'X')
+                    ? std::stoul(std::string(ent.substr(2)), nullptr, 16)
+                    : std::stoul(std::string(ent.substr(1)));
+            } catch (...) {
+                code = 0;
+            }
+            // Encode as UTF-8.
+            if (code == 0) out.append(text.substr(amp, semi - amp + 1));
+            else if (code < 0x80) out += static_cast<char>(code);
+            else if (code < 0x800) {
+                out += static_cast<char>(0xC0 | (code >> 6));
+                out += static_cast<char>(0x80 | (code & 0x3F));
+            } else if (code < 0x10000) {
+                out += static_cast<char>(0xE0 | (code >> 12));
+                out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                out += static_cast<char>(0x80 | (code & 0x3F));
+            } else {
+                out += static_cast<char>(0xF0 | (code >> 18));
+                out += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+                out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                out += static_cast<char>(0x80 | (code & 0x3F));
+            }
+        } else {
+            out.append(text.substr(amp, semi - amp + 1)); // unknown entity, keep verbatim
+        }
+        pos = semi + 1;
+        amp = text.find('&', pos);
+    }
+    if (pos < text.size()) out.append(text.substr(pos));
+    return out;
 }
 
 } // namespace io
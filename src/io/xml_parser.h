@@ -2,6 +2,7 @@
 #define XML_PARSER_H
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <map>
 
@@ -14,13 +15,35 @@ struct XmlNode {
     std::string text;
 };
 
+struct XmlAttribute {
+    std::string_view name;
+    std::string_view value; // raw, entities not decoded
+};
+
+// SAX-style callbacks. Views point into the caller's buffer and are only
+// valid for the duration of the parse call.
+class XmlSaxHandler {
+public:
+    virtual ~XmlSaxHandler() = default;
+    virtual void onStartElement(std::string_view /*name*/, const std::vector<XmlAttribute>& /*attributes*/) {}
+    virtual void onEndElement(std::string_view /*name*/) {}
+    virtual void onText(std::string_view /*text*/) {}
+    // CDATA content is literal and must not be entity-decoded. The default
+    // treats it as text, for handlers that never decode.
+    virtual void onCData(std::string_view text) { onText(text); }
+};
+
 class XmlParser {
 public:
+    // Builds an owning element tree; top-level elements are children of a synthetic "Root".
     static XmlNode parse(const std::string& xml);
     static XmlNode loadFile(const std::string& filepath);
 
-private:
-    static std::string getAttribute(const std::string& tag, const std::string& attr);
+    // Single-pass tokenizer over a borrowed buffer. Returns false on malformed markup,
+    // after reporting everything that preceded it.
+    static bool parse(std::string_view xml, XmlSaxHandler& handler);
+
+    static std::string decodeEntities(std::string_view text);
 };
 
 } // namespace io
@@ -19,7 +19,7 @@ void BookView::render(Graph& graph, const ViewContext& view, const SearchState&
         for (int nodeId : ch.nodeIds) {
             if (row >= view.height - 1) break;
             bool isFocused = graph.isNodeFocused(nodeId);
-            bool isMatch = search.isActive && std::find(search.matches.begin(), search.matches.end(), nodeId) != search.matches.end();
+            bool isMatch = search.isHighlighted(nodeId);
             bool isActiveMatch = search.getActiveMatchNodeId() == nodeId;
 
             if (isActiveMatch) std::cout << " >>";
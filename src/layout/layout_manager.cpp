@@ -65,6 +65,7 @@ void LayoutManager::applyForceDirected(Graph& graph, ViewContext& view) {
             graph.layoutPositions[node.index].y = std::max(0.0f, std::min(graph.layoutPositions[node.index].y, static_cast<float>(view.height - 1)));
         }
     }
+    graph.touchLayout();
 }
 
 void LayoutManager::applyCircular(Graph& graph) {
@@ -85,6 +86,7 @@ void LayoutManager::applyPerspectiveBFS(Graph& graph, ViewContext& view) {
     // Moved from ConsoleRenderer::render / viewer_logic.cpp renderGraph
     graph.layoutPositions.clear();
     graph.nodePos.clear();
+    graph.touchLayout();
     std::queue<std::tuple<int, int, int>> q;
 
     if (graph.focusedNodeIndices.empty() || graph.focusedNodeIndices.size() == 1) {
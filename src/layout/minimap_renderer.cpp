@@ -1,15 +1,22 @@
 #include "minimap_renderer.h"
+#include "../render/edge_lod.h"
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <vector>
 #include <string>
 
 namespace render {
 
-void MinimapRenderer::render(const Graph& graph, const ViewContext& view) {
-    // A small minimap in the corner
-    int mmW = 20;
-    int mmH = 10;
-    std::vector<std::string> minimap(mmH, std::string(mmW, ' '));
+namespace {
+
+constexpr int kMinimapWidth = 20;
+constexpr int kMinimapHeight = 10;
+
+// Rasterizes the minimap: aggregated edges, then nodes, then the viewport box.
+std::vector<std::string> buildMinimap(const Graph& graph, const ViewContext& view) {
+    const int mmW = kMinimapWidth;
+    const int mmH = kMinimapHeight;
 
     // Find bounds of world
     float minX = 0, maxX = 100, minY = 0, maxY = 100;
@@ -29,13 +36,30 @@ void MinimapRenderer::render(const Graph& graph, const ViewContext& view) {
     auto toMapX = [&](float x) { return (int)((x - minX) / worldW * (mmW - 1)); };
     auto toMapY = [&](float y) { return (int)((y - minY) / worldH * (mmH - 1)); };
 
+    FrameBuffer map(mmW, mmH);
+
+    // Edges share the console LOD at one minimap cell per bin.
+    EdgeLod lod(1.0f);
+    for (const auto& node : graph.nodes) {
+        auto from = graph.nodePos.find(node.index);
+        if (from == graph.nodePos.end()) continue;
+        for (int neighbor : node.neighbors) {
+            if (node.index > neighbor) continue; // each edge once
+            auto to = graph.nodePos.find(neighbor);
+            if (to == graph.nodePos.end()) continue;
+            lod.add(static_cast<float>(toMapX(from->second.x)), static_cast<float>(toMapY(from->second.y)),
+                    static_cast<float>(toMapX(to->second.x)), static_cast<float>(toMapY(to->second.y)));
+        }
+    }
+    for (const auto& bundle : lod.bundles()) {
+        map.drawLine(static_cast<int>(std::lround(bundle.x1)), static_cast<int>(std::lround(bundle.y1)),
+                     static_cast<int>(std::lround(bundle.x2)), static_cast<int>(std::lround(bundle.y2)),
+                     EdgeLod::glyphFor(bundle.count), 1.0f);
+    }
+
     // Render nodes
     for (const auto& [id, pos] : graph.nodePos) {
-        int mx = toMapX(pos.x);
-        int my = toMapY(pos.y);
-        if (mx >= 0 && mx < mmW && my >= 0 && my < mmH) {
-            minimap[my][mx] = graph.isNodeFocused(id) ? 'O' : '.';
-        }
+        map.drawChar(toMapX(pos.x), toMapY(pos.y), graph.isNodeFocused(id) ? 'O' : 'o', 0.0f);
     }
 
     // Render viewport box
@@ -49,68 +73,33 @@ void MinimapRenderer::render(const Graph& graph, const ViewContext& view) {
         for (int c = vx; c < vx + vw; ++c) {
             if (r >= 0 && r < mmH && c >= 0 && c < mmW) {
                 if (r == vy || r == vy + vh - 1 || c == vx || c == vx + vw - 1) {
-                    if (minimap[r][c] == ' ') minimap[r][c] = '#';
+                    if (map.getRow(r)[c] == ' ') map.drawChar(c, r, '#');
                 }
             }
         }
     }
 
+    std::vector<std::string> rows;
+    rows.reserve(mmH);
+    for (int r = 0; r < mmH; ++r) rows.emplace_back(map.getRow(r));
+    return rows;
+}
+
+} // namespace
+
+void MinimapRenderer::render(const Graph& graph, const ViewContext& view) {
+    // A small minimap in the corner
     std::cout << "\n--- MINIMAP (Spatial) ---\n";
-    for (const auto& row : minimap) {
+    for (const auto& row : buildMinimap(graph, view)) {
         std::cout << "[" << row << "]\n";
     }
     std::cout << "-------------------------\n";
 }
 
 void MinimapRenderer::draw(render::FrameBuffer& fb, int startX, int startY, const Graph& graph, const ViewContext& view) {
-    int mmW = 20;
-    int mmH = 10;
-    std::vector<std::string> minimap(mmH, std::string(mmW, ' '));
-
-    float minX = 0, maxX = 100, minY = 0, maxY = 100;
-    if (!graph.nodePos.empty()) {
-        minX = minY = 1e9f;
-        maxX = maxY = -1e9f;
-        for (const auto& [id, pos] : graph.nodePos) {
-            minX = std::min(minX, pos.x); maxX = std::max(maxX, pos.x);
-            minY = std::min(minY, pos.y); maxY = std::max(maxY, pos.y);
-        }
-    }
-    float worldW = maxX - minX;
-    float worldH = maxY - minY;
-    if (worldW < 1) worldW = 1;
-    if (worldH < 1) worldH = 1;
-
-    auto toMapX = [&](float x) { return (int)((x - minX) / worldW * (mmW - 1)); };
-    auto toMapY = [&](float y) { return (int)((y - minY) / worldH * (mmH - 1)); };
-
-    for (const auto& [id, pos] : graph.nodePos) {
-        int mx = toMapX(pos.x);
-        int my = toMapY(pos.y);
-        if (mx >= 0 && mx < mmW && my >= 0 && my < mmH) {
-            minimap[my][mx] = graph.isNodeFocused(id) ? 'O' : '.';
-        }
-    }
-
-    int vx = toMapX(-view.panX);
-    int vy = toMapY(-view.panY);
-    int vw = (int)(view.width / worldW * mmW);
-    int vh = (int)(view.height / worldH * mmH);
-    if (vw < 1) vw = 1; if (vh < 1) vh = 1;
-
-    for (int r = vy; r < vy + vh; ++r) {
-        for (int c = vx; c < vx + vw; ++c) {
-            if (r >= 0 && r < mmH && c >= 0 && c < mmW) {
-                if (r == vy || r == vy + vh - 1 || c == vx || c == vx + vw - 1) {
-                    if (minimap[r][c] == ' ') minimap[r][c] = '#';
-                }
-            }
-        }
-    }
-
     fb.drawString(startX, startY++, "--- MINIMAP ---", -1.0f);
-    for (int i = 0; i < mmH; ++i) {
-        fb.drawString(startX, startY++, "[" + minimap[i] + "]", -1.0f);
+    for (const auto& row : buildMinimap(graph, view)) {
+        fb.drawString(startX, startY++, "[" + row + "]", -1.0f);
     }
 }
 
@@ -112,7 +112,7 @@ void NexusFlowView::render(Graph& graph, NexusPhysicsState& physics, const Searc
         int c = physics.positions[node.index].x;
         if (r >= 0 && r < DEFAULT_CONSOLE_HEIGHT && c >= 0 && c < DEFAULT_CONSOLE_WIDTH) {
             char glyph = 'X';
-            if (search.isActive && std::find(search.matches.begin(), search.matches.end(), node.index) != search.matches.end()) {
+            if (search.isHighlighted(node.index)) {
                 glyph = (search.getActiveMatchNodeId() == node.index) ? 'S' : 's';
             } else if (graph.isNodeFocused(node.index)) {
                 glyph = 'O';
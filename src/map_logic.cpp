@@ -4,13 +4,20 @@
 #include <queue>
 #include <algorithm>
 #include <chrono>
+#include <atomic>
 #include <cmath>
 
+void Graph::touchLayout() {
+    static std::atomic<uint64_t> nextRevision{1};
+    layoutRevision = nextRevision.fetch_add(1);
+}
+
 void Graph::addNode(const GraphNode& node) {
     std::lock_guard<std::mutex> lock(graphMutex);
     if (nodeMap.find(node.index) != nodeMap.end()) return;
     nodes.push_back(node);
     nodeMap[node.index] = node;
+    touchLayout();
 }
 
 void Graph::removeNode(int index) {
@@ -41,6 +48,7 @@ void Graph::removeNode(int index) {
     // Also remove from focused set and positions if necessary
     focusedNodeIndices.erase(index);
     nodePos.erase(index);
+    touchLayout();
 }
 
 bool Graph::nodeExists(int index) const {
@@ -60,6 +68,7 @@ void Graph::updateNode(int index, const GraphNode& updatedNode) {
     if (it != nodes.end()) {
         *it = updatedNode;
     }
+    touchLayout();
 }
 
 void Graph::addEdge(int from, int to) {
@@ -82,6 +91,7 @@ void Graph::addEdge(int from, int to) {
             [to](const GraphNode& n) { return n.index == to; });
         if (it2 != nodes.end()) *it2 = nodeMap[to];
     }
+    touchLayout();
 }
 
 void Graph::clear() {
@@ -92,6 +102,7 @@ void Graph::clear() {
     focusedNodeIndices.clear();
     summary = GraphSummary{};
     needsLayoutReset = true;
+    touchLayout();
 }
 
 // BFS Shortest Path
@@ -420,6 +431,7 @@ namespace Config {
     int consoleWidth = 0;
     int consoleHeight = 0;
     int maxSpatialDepth = 0;
+    int sliceCacheBudgetKB = 0;
     float cameraLerpSpeed = 0.0f;
     int nodeWeightThresholdHigh = 0;
     int nodeWeightThresholdLow = 0;
@@ -441,6 +453,7 @@ namespace Config {
         consoleWidth = io::YamlParser::getInt(config, "console_width", consoleWidth);
         consoleHeight = io::YamlParser::getInt(config, "console_height", consoleHeight);
         maxSpatialDepth = io::YamlParser::getInt(config, "max_spatial_depth", maxSpatialDepth);
+        sliceCacheBudgetKB = io::YamlParser::getInt(config, "slice_cache_budget_kb", sliceCacheBudgetKB);
         cameraLerpSpeed = io::YamlParser::getFloat(config, "camera_lerp_speed", cameraLerpSpeed);
         nodeWeightThresholdHigh = io::YamlParser::getInt(config, "node_weight_threshold_high", nodeWeightThresholdHigh);
         nodeWeightThresholdLow = io::YamlParser::getInt(config, "node_weight_threshold_low", nodeWeightThresholdLow);
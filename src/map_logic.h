@@ -8,6 +8,7 @@
 #include <iostream>
 #include <map>
 #include <mutex>
+#include <cstdint>
 #include "model/model_common.h"
 #include "model/brain_overlay.h"
 
@@ -30,6 +31,7 @@ namespace Config {
     extern int consoleWidth;
     extern int consoleHeight;
     extern int maxSpatialDepth;
+    extern int sliceCacheBudgetKB;
     extern float cameraLerpSpeed;
     extern int nodeWeightThresholdHigh;
     extern int nodeWeightThresholdLow;
@@ -140,6 +142,7 @@ public:
             focusOnlyAtMaxZoom = other.focusOnlyAtMaxZoom;
             showLines = other.showLines;
             needsLayoutReset = other.needsLayoutReset;
+            layoutRevision = other.layoutRevision;
         }
         return *this;
     }
@@ -153,6 +156,10 @@ public:
     std::map<int,Coord3>      nodePos;
     std::map<int, Point2D>    layoutPositions;
     bool                      layoutDirty = true;
+    // Changes whenever nodes, edges or layoutPositions change; values are unique
+    // across all graphs. Call touchLayout() after editing layoutPositions directly.
+    uint64_t                  layoutRevision = 0;
+    void touchLayout();
     std::set<int> focusedNodeIndices;
     int focusedNodeIndex = 0;
     GraphSummary summary;
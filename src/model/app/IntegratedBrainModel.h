@@ -3,9 +3,10 @@
 #include "model/core/contracts/ISimulationKernel.h"
 #include "model/core/contracts/IOverlayService.h"
 #include "model/core/contracts/IModelDomainPlugin.h"
+#include "model/core/contracts/ISimulationSystem.h"
+#include "model/core/SystemScheduler.h"
 #include <vector>
 #include <memory>
-#include <iostream>
 
 namespace brain_model::app {
 
@@ -16,29 +17,27 @@ public:
     IntegratedBrainModel(
         std::shared_ptr<ISimulationKernel> kernel,
         std::shared_ptr<IOverlayService> overlays
-    ) : m_kernel(kernel), m_overlays(overlays) {}
+    ) : m_kernel(kernel), m_overlays(overlays), m_scheduler(kernel, overlays) {}
 
     void add_domain(std::shared_ptr<IModelDomainPlugin> domain) {
+        SystemRegistry systems;
+        domain->register_systems(systems);
+        m_scheduler.add_systems(systems);
         m_domains.push_back(domain);
     }
 
-    void run_step(uint32_t delta_ms) {
-        m_kernel->step(delta_ms);
-        
-        // In a full implementation, we would iterate through registered systems
-        // For this text-based integrated model demonstration, we trigger updates
-        std::cout << "--- [Sim Step: " << m_kernel->current_time_ms() << "ms] ---" << std::endl;
-        
-        // Mock update for demonstration
-        for (const auto& domain : m_domains) {
-            std::cout << "Updating Domain: " << domain->name() << std::endl;
-        }
+    // Runs every fixed step `delta_ms` completes; returns the number of steps.
+    uint32_t run_step(uint32_t delta_ms) {
+        return m_scheduler.advance(delta_ms);
     }
 
+    const core::SystemScheduler& scheduler() const { return m_scheduler; }
+
 private:
     std::shared_ptr<ISimulationKernel> m_kernel;
     std::shared_ptr<IOverlayService> m_overlays;
     std::vector<std::shared_ptr<IModelDomainPlugin>> m_domains;
+    core::SystemScheduler m_scheduler;
 };
 
 } // namespace brain_model::app
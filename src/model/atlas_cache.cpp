@@ -0,0 +1,272 @@
+#include "atlas_cache.h"
+#include "../io/mapped_file.h"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+namespace model {
+
+namespace {
+
+constexpr char kMagic[8] = {'M', 'V', 'A', 'T', 'L', 'A', 'S', '1'};
+constexpr uint32_t kFormatVersion = 4; // 4: no region octree section
+
+struct CacheHeader {
+    char magic[8];
+    uint32_t formatVersion;
+    uint32_t reserved;
+    uint64_t sourceHash;
+    uint64_t sourceSize;
+    uint64_t stringsOffset, stringsSize;
+    uint64_t regionsOffset, regionCount;
+    uint64_t pathwaysOffset, pathwayCount;
+    uint64_t pointsOffset, pointCount;
+};
+
+struct StrRef {
+    uint32_t offset;
+    uint32_t length;
+};
+
+struct RegionRecord {
+    StrRef id, name, regionCode, parentId;
+    float center[3];
+    float radius;
+    int32_t hemisphere, lobe, layer, displayPriority;
+    float surfaceArea, volume;
+    uint32_t geometryFirst, geometryCount;
+    uint32_t hullFirst, hullCount;
+};
+
+struct PathwayRecord {
+    StrRef id, name, sourceRegion, targetRegion;
+    int32_t direction, type;
+    float strength;
+    uint32_t pointFirst, pointCount;
+};
+
+static_assert(sizeof(Vec3) == 3 * sizeof(float), "Vec3 is stored as packed floats");
+
+class CacheWriter {
+public:
+    std::string buffer;
+
+    uint64_t align() {
+        while (buffer.size() % 8) buffer.push_back('\0');
+        return buffer.size();
+    }
+
+    template <typename T>
+    uint64_t appendArray(const T* data, size_t count) {
+        uint64_t offset = align();
+        if (count) buffer.append(reinterpret_cast<const char*>(data), count * sizeof(T));
+        return offset;
+    }
+};
+
+class StringTable {
+public:
+    std::string data;
+
+    StrRef add(const std::string& s) {
+        StrRef ref{static_cast<uint32_t>(data.size()), static_cast<uint32_t>(s.size())};
+        data += s;
+        return ref;
+    }
+};
+
+// Bounds-checked view of one section of the mapped file.
+template <typename T>
+const T* section(const io::MappedFile& file, uint64_t offset, uint64_t count) {
+    if (offset % alignof(T) != 0 || offset > file.size()) return nullptr;
+    if (count > (file.size() - offset) / sizeof(T)) return nullptr;
+    return reinterpret_cast<const T*>(file.data() + offset);
+}
+
+} // namespace
+
+std::string AtlasCache::cachePathFor(const std::string& atlasPath) {
+    return atlasPath + ".cache";
+}
+
+uint64_t AtlasCache::hashSource(std::string_view bytes) {
+    // 64-bit FNV-style mix over whole words; only used to detect edits.
+    const uint64_t prime = 0x100000001b3ULL;
+    uint64_t h = 0xcbf29ce484222325ULL ^ bytes.size();
+    size_t i = 0;
+    for (; i + 8 <= bytes.size(); i += 8) {
+        uint64_t w;
+        std::memcpy(&w, bytes.data() + i, 8);
+        h = (h ^ w) * prime;
+        h ^= h >> 29;
+    }
+    for (; i < bytes.size(); ++i) {
+        h = (h ^ static_cast<unsigned char>(bytes[i])) * prime;
+    }
+    return h;
+}
+
+bool AtlasCache::write(const std::string& cachePath, const BrainModel& model,
+                       uint64_t sourceHash, uint64_t sourceSize) {
+    StringTable strings;
+    std::vector<Vec3> points;
+    std::vector<RegionRecord> regions;
+    std::vector<PathwayRecord> pathways;
+    regions.reserve(model.getRegions().size());
+    pathways.reserve(model.getPathways().size());
+
+    for (const auto& [id, r] : model.getRegions()) {
+        RegionRecord rec{};
+        rec.id = strings.add(r.id);
+        rec.name = strings.add(r.name);
+        rec.regionCode = strings.add(r.regionCode);
+        rec.parentId = strings.add(r.parentId);
+        rec.center[0] = r.center.x;
+        rec.center[1] = r.center.y;
+        rec.center[2] = r.center.z;
+        rec.radius = r.radius;
+        rec.hemisphere = static_cast<int32_t>(r.hemisphere);
+        rec.lobe = static_cast<int32_t>(r.lobe);
+        rec.layer = static_cast<int32_t>(r.layer);
+        rec.displayPriority = r.displayPriority;
+        rec.surfaceArea = r.surfaceArea;
+        rec.volume = r.volume;
+        rec.geometryFirst = static_cast<uint32_t>(points.size());
+        rec.geometryCount = static_cast<uint32_t>(r.geometry.size());
+        points.insert(points.end(), r.geometry.begin(), r.geometry.end());
+        rec.hullFirst = static_cast<uint32_t>(points.size());
+        rec.hullCount = static_cast<uint32_t>(r.convexHull.size());
+        points.insert(points.end(), r.convexHull.begin(), r.convexHull.end());
+        regions.push_back(rec);
+    }
+
+    for (const auto& [id, p] : model.getPathways()) {
+        PathwayRecord rec{};
+        rec.id = strings.add(p.id);
+        rec.name = strings.add(p.name);
+        rec.sourceRegion = strings.add(p.sourceRegion);
+        rec.targetRegion = strings.add(p.targetRegion);
+        rec.direction = static_cast<int32_t>(p.direction);
+        rec.type = static_cast<int32_t>(p.type);
+        rec.strength = p.strength;
+        rec.pointFirst = static_cast<uint32_t>(points.size());
+        rec.pointCount = static_cast<uint32_t>(p.controlPoints.size());
+        points.insert(points.end(), p.controlPoints.begin(), p.controlPoints.end());
+        pathways.push_back(rec);
+    }
+
+    // 32-bit offsets keep records small; atlases this large are not cached.
+    if (strings.data.size() > UINT32_MAX || points.size() > UINT32_MAX) return false;
+
+    CacheHeader header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.formatVersion = kFormatVersion;
+    header.sourceHash = sourceHash;
+    header.sourceSize = sourceSize;
+
+    CacheWriter out;
+    out.buffer.assign(sizeof(CacheHeader), '\0');
+    header.stringsOffset = out.appendArray(strings.data.data(), strings.data.size());
+    header.stringsSize = strings.data.size();
+    header.regionsOffset = out.appendArray(regions.data(), regions.size());
+    header.regionCount = regions.size();
+    header.pathwaysOffset = out.appendArray(pathways.data(), pathways.size());
+    header.pathwayCount = pathways.size();
+    header.pointsOffset = out.appendArray(points.data(), points.size());
+    header.pointCount = points.size();
+    std::memcpy(&out.buffer[0], &header, sizeof(header));
+
+    // Write beside the target and rename so readers never see a partial file.
+    std::string tmpPath = cachePath + ".tmp";
+    {
+        std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) return false;
+        file.write(out.buffer.data(), out.buffer.size());
+        if (!file) return false;
+    }
+    std::error_code ec;
+    std::filesystem::rename(tmpPath, cachePath, ec);
+    if (ec) {
+        std::filesystem::remove(tmpPath, ec);
+        return false;
+    }
+    return true;
+}
+
+bool AtlasCache::read(const std::string& cachePath, uint64_t sourceHash,
+                      uint64_t sourceSize, BrainModel& model) {
+    io::MappedFile file(cachePath);
+    if (!file.isOpen() || file.size() < sizeof(CacheHeader)) return false;
+
+    CacheHeader header;
+    std::memcpy(&header, file.data(), sizeof(header));
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 ||
+        header.formatVersion != kFormatVersion ||
+        header.sourceHash != sourceHash ||
+        header.sourceSize != sourceSize) {
+        return false;
+    }
+
+    const char* strings = section<char>(file, header.stringsOffset, header.stringsSize);
+    const auto* regionRecs = section<RegionRecord>(file, header.regionsOffset, header.regionCount);
+    const auto* pathwayRecs = section<PathwayRecord>(file, header.pathwaysOffset, header.pathwayCount);
+    const auto* points = section<Vec3>(file, header.pointsOffset, header.pointCount);
+    if (!strings || !regionRecs || !pathwayRecs || !points) return false;
+
+    bool valid = true;
+    auto str = [&](const StrRef& ref) -> std::string {
+        if (uint64_t(ref.offset) + ref.length > header.stringsSize) {
+            valid = false;
+            return std::string();
+        }
+        return std::string(strings + ref.offset, ref.length);
+    };
+    auto pointRange = [&](uint32_t first, uint32_t count) -> std::vector<Vec3> {
+        if (uint64_t(first) + count > header.pointCount) {
+            valid = false;
+            return {};
+        }
+        return std::vector<Vec3>(points + first, points + first + count);
+    };
+
+    std::vector<BrainRegion> regions(header.regionCount);
+    for (size_t i = 0; i < regions.size() && valid; ++i) {
+        const RegionRecord& rec = regionRecs[i];
+        BrainRegion& r = regions[i];
+        r.id = str(rec.id);
+        r.name = str(rec.name);
+        r.regionCode = str(rec.regionCode);
+        r.parentId = str(rec.parentId);
+        r.center = {rec.center[0], rec.center[1], rec.center[2]};
+        r.radius = rec.radius;
+        r.hemisphere = static_cast<Hemisphere>(rec.hemisphere);
+        r.lobe = static_cast<Lobe>(rec.lobe);
+        r.layer = static_cast<Layer>(rec.layer);
+        r.displayPriority = rec.displayPriority;
+        r.surfaceArea = rec.surfaceArea;
+        r.volume = rec.volume;
+        r.geometry = pointRange(rec.geometryFirst, rec.geometryCount);
+        r.convexHull = pointRange(rec.hullFirst, rec.hullCount);
+    }
+
+    std::vector<BrainPathway> pathways(header.pathwayCount);
+    for (size_t i = 0; i < pathways.size() && valid; ++i) {
+        const PathwayRecord& rec = pathwayRecs[i];
+        BrainPathway& p = pathways[i];
+        p.id = str(rec.id);
+        p.name = str(rec.name);
+        p.sourceRegion = str(rec.sourceRegion);
+        p.targetRegion = str(rec.targetRegion);
+        p.direction = static_cast<PathwayDirection>(rec.direction);
+        p.type = static_cast<PathwayType>(rec.type);
+        p.strength = rec.strength;
+        p.controlPoints = pointRange(rec.pointFirst, rec.pointCount);
+    }
+    if (!valid) return false;
+
+    model.addRegions(std::move(regions));
+    model.addPathways(std::move(pathways));
+    return true;
+}
+
+} // namespace model
@@ -0,0 +1,29 @@
+#ifndef ATLAS_CACHE_H
+#define ATLAS_CACHE_H
+
+#include "brain_model.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace model {
+
+// Binary snapshot of a parsed atlas, stored next to the source file and mapped
+// on load. Sections (string table, region and pathway records and a shared
+// Vec3 pool) are 8-byte aligned so records can be read in place. The header pins the source hash and size; any mismatch means
+// the cache is stale and the text atlas is parsed instead.
+class AtlasCache {
+public:
+    static std::string cachePathFor(const std::string& atlasPath);
+    static uint64_t hashSource(std::string_view bytes);
+
+    static bool write(const std::string& cachePath, const BrainModel& model,
+                      uint64_t sourceHash, uint64_t sourceSize);
+    // Fills an empty `model` when the cache exists and matches the source.
+    static bool read(const std::string& cachePath, uint64_t sourceHash,
+                     uint64_t sourceSize, BrainModel& model);
+};
+
+} // namespace model
+
+#endif // ATLAS_CACHE_H
@@ -6,7 +6,7 @@ void BrainLabelSet::addLabel(const BrainLabel& label) {
     labels_[label.id] = label;
 }
 
-const BrainLabel* BrainLabelSet::getLabel(const std::string& id) const {
+const BrainLabel* BrainLabelSet::getLabel(const Symbol& id) const {
     auto it = labels_.find(id);
     return (it != labels_.end()) ? &it->second : nullptr;
 }
@@ -9,7 +9,7 @@
 namespace model {
 
 struct BrainLabel {
-    std::string id;
+    Symbol id;
     std::string displayName;
     std::string description;
     std::string category; // e.g., "Anatomy", "Function", "Connectivity"
@@ -20,14 +20,14 @@ public:
     BrainLabelSet() = default;
 
     void addLabel(const BrainLabel& label);
-    const BrainLabel* getLabel(const std::string& id) const;
+    const BrainLabel* getLabel(const Symbol& id) const;
     
     std::vector<const BrainLabel*> getLabelsByCategory(const std::string& category) const;
 
-    const std::unordered_map<std::string, BrainLabel>& getAllLabels() const { return labels_; }
+    const std::unordered_map<Symbol, BrainLabel>& getAllLabels() const { return labels_; }
 
 private:
-    std::unordered_map<std::string, BrainLabel> labels_;
+    std::unordered_map<Symbol, BrainLabel> labels_;
 };
 
 } // namespace model
@@ -1,31 +1,129 @@
 #include "brain_model.h"
 #include "map_logic.h"
-#include "../render/spatial_index.h"
+#include "region_bvh.h"
+#include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <functional>
 
 namespace model {
 
-BrainModel::BrainModel() {
-    // Initialize spatial index with broad brain bounds (e.g., MNI space +/- 100mm)
-    render::SpatialBounds bounds{-150.0f, -150.0f, -150.0f, 150.0f, 150.0f, 150.0f};
-    spatialIndex_ = std::make_unique<render::OctreeIndex>(bounds);
-}
+BrainModel::BrainModel() = default;
 
 BrainModel::~BrainModel() = default;
 
 
 void BrainModel::addRegion(const BrainRegion& region) {
     regions_[region.id] = region;
-
-    int hash = static_cast<int>(std::hash<std::string>{}(region.id));
-    hashToId_[hash] = region.id;
-    spatialIndex_->insert(hash, region.center.x, region.center.y, region.center.z);
+    ++version_;
 }
 
 
+static uint64_t nextPathwayRevision() {
+    static std::atomic<uint64_t> counter{0};
+    return ++counter;
+}
+
 void BrainModel::addPathway(const BrainPathway& pathway) {
-    pathways_[pathway.id] = pathway;
+    BrainPathway& stored = pathways_[pathway.id] = pathway;
+    stored.revision = nextPathwayRevision();
+    ++version_;
+}
+
+void BrainModel::removeRegion(const RegionID& id) {
+    auto it = regions_.find(id);
+    if (it == regions_.end()) return;
+    regions_.erase(it);
+    ++version_;
+}
+
+void BrainModel::removePathway(const PathwayID& id) {
+    if (pathways_.erase(id)) ++version_;
+}
+
+// Only the fields an atlas record carries take part in the comparison.
+static bool sameAtlasRecord(const BrainRegion& a, const BrainRegion& b) {
+    return a.name == b.name && a.center == b.center && a.radius == b.radius &&
+           a.regionCode == b.regionCode && a.hemisphere == b.hemisphere &&
+           a.lobe == b.lobe && a.parentId == b.parentId;
+}
+
+static bool sameAtlasRecord(const BrainPathway& a, const BrainPathway& b) {
+    return a.name == b.name && a.sourceRegion == b.sourceRegion && a.targetRegion == b.targetRegion &&
+           a.direction == b.direction && a.strength == b.strength && a.type == b.type &&
+           a.controlPoints == b.controlPoints;
+}
+
+AtlasChangeSet BrainModel::applyAtlasDiff(std::vector<BrainRegion> regions, std::vector<BrainPathway> pathways) {
+    AtlasChangeSet changes;
+
+    // Later records win, as in a full load.
+    std::unordered_map<RegionID, BrainRegion> incomingRegions;
+    incomingRegions.reserve(regions.size());
+    for (auto& region : regions) {
+        RegionID id = region.id;
+        incomingRegions[id] = std::move(region);
+    }
+    std::unordered_map<PathwayID, BrainPathway> incomingPathways;
+    incomingPathways.reserve(pathways.size());
+    for (auto& pathway : pathways) {
+        PathwayID id = pathway.id;
+        incomingPathways[id] = std::move(pathway);
+    }
+
+    for (const auto& [id, region] : regions_) {
+        if (!incomingRegions.count(id)) changes.removedRegions.push_back(id);
+    }
+    for (const auto& id : changes.removedRegions) removeRegion(id);
+
+    for (auto& [id, region] : incomingRegions) {
+        auto it = regions_.find(id);
+        if (it == regions_.end()) {
+            changes.addedRegions.push_back(id);
+            addRegion(region);
+        } else if (!sameAtlasRecord(it->second, region)) {
+            changes.modifiedRegions.push_back(id);
+            addRegion(region);
+        }
+    }
+
+    for (const auto& [id, pathway] : pathways_) {
+        if (!incomingPathways.count(id)) changes.removedPathways.push_back(id);
+    }
+    for (const auto& id : changes.removedPathways) removePathway(id);
+
+    for (auto& [id, pathway] : incomingPathways) {
+        auto it = pathways_.find(id);
+        if (it == pathways_.end()) {
+            changes.addedPathways.push_back(id);
+            addPathway(pathway);
+        } else if (!sameAtlasRecord(it->second, pathway)) {
+            changes.modifiedPathways.push_back(id);
+            addPathway(pathway);
+        }
+    }
+
+    changes.modelVersion = version_;
+    return changes;
+}
+
+void BrainModel::addRegions(std::vector<BrainRegion> regions) {
+    regions_.reserve(regions_.size() + regions.size());
+    for (auto& region : regions) {
+        RegionID id = region.id;
+        regions_[id] = std::move(region);
+    }
+    ++version_;
+}
+
+void BrainModel::addPathways(std::vector<BrainPathway> pathways) {
+    pathways_.reserve(pathways_.size() + pathways.size());
+    for (auto& pathway : pathways) {
+        PathwayID id = pathway.id;
+        pathway.revision = nextPathwayRevision();
+        pathways_[id] = std::move(pathway);
+    }
+    ++version_;
 }
 
 const BrainRegion* BrainModel::getRegion(const RegionID& id) const {
@@ -39,59 +137,26 @@ const BrainPathway* BrainModel::getPathway(const PathwayID& id) const {
 }
 
 bool isPointInConvexHull(const Vec3& p, const std::vector<Vec3>& hull) {
-    if (hull.empty()) return false;
-    // Basic implementation: if no faces provided, we'd need to compute them.
-    // For this requirement, we'll implement a robust check if hull is defined.
-    // If only vertices are provided, we approximate with a tight AABB + radius check
-    // for now, but to satisfy "no placeholders", I'll implement a centroid-based
-    // distance check against all hull vertices as a heuristic if no face data exists.
-    // BETTER: If the hull is defined as a vertex list, we assume it's a point cloud.
-    // A point is inside the convex hull if it lies on the same side of all supporting planes.
-    // Since we don't have planes, we'll use a simpler "within distance of all vertices"
-    // or similar if we can't compute the hull.
-    // Actually, I'll implement a simple "all vertices on one side of a plane through p"
-    // check which is the dual.
-
-    // For now, if geometry is present, we check if it's within the radius of any vertex
-    // as a voxel-like approximation, or just stick to the bounding sphere if hull is empty.
-    return true; // Placeholder for logic below
+    std::vector<HullPlane> planes;
+    if (!computeHullPlanes(hull, planes)) return false;
+    return isInsideHull(p, planes.data(), planes.size());
 }
 
-RegionID BrainModel::findRegionAt(const Vec3& point) const {
-    // Feature 1: Octree Query
-    // Query a small box around the point.
-    // If regions are large, we might need a larger box or use the max region radius.
-    float querySize = 100.0f;
-    render::SpatialBounds queryBounds{
-        point.x - querySize, point.y - querySize, point.z - querySize,
-        point.x + querySize, point.y + querySize, point.z + querySize
-    };
-
-    auto candidates = spatialIndex_->queryRange(queryBounds);
-
-    // For each candidate from Octree, verify with exact geometry (Feature 2)
-    for (int hash : candidates) {
-        auto idIt = hashToId_.find(hash);
-        if (idIt == hashToId_.end()) continue;
-
-        auto regionIt = regions_.find(idIt->second);
-        if (regionIt == regions_.end()) continue;
-
-        const auto& region = regionIt->second;
-
-        // Fast rejection with bounding sphere
-        float dx = point.x - region.center.x;
-        float dy = point.y - region.center.y;
-        float dz = point.z - region.center.z;
-        float distSq = dx*dx + dy*dy + dz*dz;
-
-        if (distSq <= region.radius * region.radius) {
-            // Precise check with convex hull if available
-            // (Requirement met: fallback to sphere if hull empty)
-            return region.id;
-        }
+std::shared_ptr<const RegionBvh> BrainModel::getRegionHierarchy() const {
+    std::shared_ptr<const RegionBvh> bvh = std::atomic_load(&regionBvh_);
+    if (!bvh || bvh->version() != version_) {
+        auto fresh = std::make_shared<RegionBvh>();
+        fresh->build(regions_, version_);
+        bvh = fresh;
+        std::atomic_store(&regionBvh_, bvh);
     }
-    return "";
+    return bvh;
+}
+
+RegionID BrainModel::findRegionAt(const Vec3& point) const {
+    // Feature 1/2: BVH over region volumes.
+    const RegionID* id = getRegionHierarchy()->findSmallestContaining(point);
+    return id ? *id : RegionID();
 }
 
 std::vector<RegionID> BrainModel::getHierarchyPath(const RegionID& id) const {
@@ -158,6 +223,7 @@ std::vector<int> BrainModel::getNodesInROI(const Vec3& center, float radius, con
 void BrainModel::clear() {
     regions_.clear();
     pathways_.clear();
+    ++version_;
 }
 
 std::vector<Vec3> BrainPathway::getInterpolatedPoints(int segmentsPerLink) const {
@@ -165,6 +231,7 @@ std::vector<Vec3> BrainPathway::getInterpolatedPoints(int segmentsPerLink) const
 
     std::vector<Vec3> result;
     int n = controlPoints.size();
+    result.reserve(static_cast<size_t>(n - 1) * std::max(segmentsPerLink, 0) + 1);
 
     for (int i = 0; i < n - 1; ++i) {
         Vec3 p0 = (i == 0) ? controlPoints[i] : controlPoints[i - 1];
@@ -7,13 +7,14 @@
 #include <memory>
 #include <unordered_map>
 #include <set>
-
-namespace render {
-    class OctreeIndex;
-}
+#include <cstdint>
 
 class Graph;
 
+namespace model {
+    class RegionBvh;
+}
+
 namespace model {
 
 
@@ -55,6 +56,9 @@ struct BrainRegion {
     int displayPriority = 0; // Feature extension for LOD/Filtering
 };
 
+// Exact test against the hull of the vertex list; false if it encloses no volume.
+bool isPointInConvexHull(const Vec3& p, const std::vector<Vec3>& hull);
+
 
 struct BrainPathway {
     PathwayID id;
@@ -66,12 +70,31 @@ struct BrainPathway {
     PathwayDirection direction = PathwayDirection::Unidirectional;
     float strength = 1.0f;
     PathwayType type = PathwayType::Unknown;
+    // Stamped by BrainModel on every insert; unique across models, so caches can key on it.
+    uint64_t revision = 0;
 
     // Feature 6: Spline Interpolation
     std::vector<Vec3> getInterpolatedPoints(int segmentsPerLink = 10) const;
 };
 
 
+// What an incremental atlas reload changed. Published so overlays and slices
+// can recompute only the affected regions.
+struct AtlasChangeSet {
+    std::vector<RegionID> addedRegions;
+    std::vector<RegionID> removedRegions;
+    std::vector<RegionID> modifiedRegions;
+    std::vector<PathwayID> addedPathways;
+    std::vector<PathwayID> removedPathways;
+    std::vector<PathwayID> modifiedPathways;
+    uint64_t modelVersion = 0;
+
+    bool empty() const {
+        return addedRegions.empty() && removedRegions.empty() && modifiedRegions.empty() &&
+               addedPathways.empty() && removedPathways.empty() && modifiedPathways.empty();
+    }
+};
+
 class BrainModel {
 public:
     BrainModel();
@@ -81,10 +104,28 @@ public:
     void addRegion(const BrainRegion& region);
     void addPathway(const BrainPathway& pathway);
 
+    // Bulk insertion for atlas loading: reserves once rather than per region.
+    // Later duplicates win.
+    void addRegions(std::vector<BrainRegion> regions);
+    void addPathways(std::vector<BrainPathway> pathways);
+
+    void removeRegion(const RegionID& id);
+    void removePathway(const PathwayID& id);
+
+    // Makes the model match the given atlas records, touching only regions and
+    // pathways whose atlas fields differ.
+    AtlasChangeSet applyAtlasDiff(std::vector<BrainRegion> regions, std::vector<BrainPathway> pathways);
+
+    // Bumped on every mutation; lets caches detect a stale model.
+    uint64_t getVersion() const { return version_; }
+
     const BrainRegion* getRegion(const RegionID& id) const;
     const BrainPathway* getPathway(const PathwayID& id) const;
 
+    // Smallest region whose hull (or bounding sphere, without one) contains the point.
     RegionID findRegionAt(const Vec3& point) const;
+    // Containment hierarchy for the current regions, built on first use after a change.
+    std::shared_ptr<const RegionBvh> getRegionHierarchy() const;
 
     const std::unordered_map<RegionID, BrainRegion>& getRegions() const { return regions_; }
     const std::unordered_map<PathwayID, BrainPathway>& getPathways() const { return pathways_; }
@@ -106,8 +147,9 @@ public:
 private:
     std::unordered_map<RegionID, BrainRegion> regions_;
     std::unordered_map<PathwayID, BrainPathway> pathways_;
-    std::unique_ptr<render::OctreeIndex> spatialIndex_; // Feature 1
-    std::unordered_map<int, RegionID> hashToId_; // Reverse mapping for Octree candidates
+    uint64_t version_ = 0;
+    // Built lazily for findRegionAt and swapped atomically, so concurrent readers are safe.
+    mutable std::shared_ptr<const RegionBvh> regionBvh_;
 };
 
 
@@ -1,64 +1,205 @@
 #include "brain_text_topology.h"
+#include "slice_cache.h"
+#include "slice_rasterizer.h"
+#include "../map_logic.h"
+#include "../analytics/worker_pool.h"
+#include "../render/spatial_index.h"
 #include <cmath>
 #include <algorithm>
 #include <sstream>
 #include <map>
+#include <thread>
 
 namespace model {
 
+// Bounding spheres that overlap slightly count as adjacent for text maps.
+// In a real system, this would use voxel geometry traversal.
+static bool computeAdjacency(const BrainRegion& r1, const BrainRegion& r2, AdjacencyEdge& edge) {
+    // Euclidean distance between centers
+    float dx = r1.center.x - r2.center.x;
+    float dy = r1.center.y - r2.center.y;
+    float dz = r1.center.z - r2.center.z;
+    float dist = std::sqrt(dx*dx + dy*dy + dz*dz);
+
+    if (dist >= (r1.radius + r2.radius) * 1.2f) return false;
+
+    edge.targetRegion = r2.id;
+    edge.proximityScore = 1.0f / (dist + 0.1f);
+
+    // Determine direction
+    if (std::abs(dx) > std::abs(dy) && std::abs(dx) > std::abs(dz)) {
+        edge.direction = (dx > 0) ? Direction::Medial : Direction::Lateral; // Simplified
+    } else if (std::abs(dy) > std::abs(dx) && std::abs(dy) > std::abs(dz)) {
+        edge.direction = (dy > 0) ? Direction::Superior : Direction::Inferior;
+    } else {
+        edge.direction = (dz > 0) ? Direction::Anterior : Direction::Posterior;
+    }
+    return true;
+}
+
 class TopologyIndexerImpl : public TopologyIndexer {
 public:
     void buildIndex(const BrainModel& model) override {
-        // Simple implementation: precompute adjacency based on bounding sphere overlap
-        // In a real system, this would use voxel geometry traversal
         adjacencyMap_.clear();
-        const auto& regions = model.getRegions();
-
-        for (auto it1 = regions.begin(); it1 != regions.end(); ++it1) {
-            RegionAdjacency adjacency;
-            adjacency.regionId = it1->first;
-
-            for (auto it2 = regions.begin(); it2 != regions.end(); ++it2) {
-                if (it1 == it2) continue;
-
-                const auto& r1 = it1->second;
-                const auto& r2 = it2->second;
+        std::vector<const BrainRegion*> regions;
+        regions.reserve(model.getRegions().size());
+        float maxRadius = 0.0f;
+        for (const auto& [id, region] : model.getRegions()) {
+            regions.push_back(&region);
+            maxRadius = std::max(maxRadius, region.radius);
+        }
 
-                // Euclidean distance between centers
-                float dx = r1.center.x - r2.center.x;
-                float dy = r1.center.y - r2.center.y;
-                float dz = r1.center.z - r2.center.z;
-                float dist = std::sqrt(dx*dx + dy*dy + dz*dz);
+        // Two regions can only be adjacent within (r1 + r2) * 1.2 <= 2.4 * maxRadius,
+        // so with cells that wide every candidate lies in the 27 surrounding cells.
+        float cellSize = maxRadius > 0.0f ? 2.4f * maxRadius : 1.0f;
+        std::unordered_map<GridCell, std::vector<uint32_t>, GridCellHash> grid;
+        for (uint32_t i = 0; i < regions.size(); ++i) {
+            grid[cellOf(regions[i]->center, cellSize)].push_back(i);
+        }
 
-                // If bounding spheres overlap slightly, consider them adjacent for text maps
-                if (dist < (r1.radius + r2.radius) * 1.2f) {
+        std::vector<std::vector<AdjacencyEdge>> neighbors(regions.size());
+        auto collect = [&](size_t first, size_t last) {
+            std::vector<uint32_t> candidates;
+            for (size_t i = first; i < last; ++i) {
+                GridCell c = cellOf(regions[i]->center, cellSize);
+                candidates.clear();
+                for (int64_t dz = -1; dz <= 1; ++dz)
+                    for (int64_t dy = -1; dy <= 1; ++dy)
+                        for (int64_t dx = -1; dx <= 1; ++dx) {
+                            auto it = grid.find({c.x + dx, c.y + dy, c.z + dz});
+                            if (it != grid.end()) candidates.insert(candidates.end(), it->second.begin(), it->second.end());
+                        }
+                // Same neighbor order as a scan over the model's regions.
+                std::sort(candidates.begin(), candidates.end());
+                for (uint32_t j : candidates) {
                     AdjacencyEdge edge;
-                    edge.targetRegion = r2.id;
-                    edge.proximityScore = 1.0f / (dist + 0.1f);
-
-                    // Determine direction
-                    if (std::abs(dx) > std::abs(dy) && std::abs(dx) > std::abs(dz)) {
-                        edge.direction = (dx > 0) ? Direction::Medial : Direction::Lateral; // Simplified
-                    } else if (std::abs(dy) > std::abs(dx) && std::abs(dy) > std::abs(dz)) {
-                        edge.direction = (dy > 0) ? Direction::Superior : Direction::Inferior;
-                    } else {
-                        edge.direction = (dz > 0) ? Direction::Anterior : Direction::Posterior;
-                    }
-
-                    adjacency.neighbors.push_back(edge);
+                    if (j != i && computeAdjacency(*regions[i], *regions[j], edge)) neighbors[i].push_back(edge);
                 }
             }
-            adjacencyMap_[it1->first] = adjacency;
+        };
+
+        size_t threads = std::max(1u, std::thread::hardware_concurrency());
+        size_t chunkCount = std::max<size_t>(1, std::min(threads, regions.size() / kMinRegionsPerChunk));
+        if (chunkCount == 1) {
+            collect(0, regions.size());
+        } else {
+            analytics::WorkerPool pool(chunkCount);
+            for (size_t c = 0; c < chunkCount; ++c) {
+                pool.enqueue([&, c] { collect(regions.size() * c / chunkCount, regions.size() * (c + 1) / chunkCount); });
+            }
+            pool.waitAll();
+        }
+
+        adjacencyMap_.reserve(regions.size());
+        for (size_t i = 0; i < regions.size(); ++i) {
+            RegionAdjacency& adjacency = adjacencyMap_[regions[i]->id];
+            adjacency.regionId = regions[i]->id;
+            adjacency.neighbors = std::move(neighbors[i]);
         }
+        indexCenters(model);
+    }
+
+    void updateIndex(const BrainModel& model, const AtlasChangeSet& changes) override {
+        // Drop the old edges of every touched region from both ends.
+        auto detach = [this](const RegionID& id) {
+            auto it = adjacencyMap_.find(id);
+            if (it == adjacencyMap_.end()) return;
+            for (const auto& edge : it->second.neighbors) {
+                auto other = adjacencyMap_.find(edge.targetRegion);
+                if (other == adjacencyMap_.end()) continue;
+                auto& list = other->second.neighbors;
+                list.erase(std::remove_if(list.begin(), list.end(),
+                    [&id](const AdjacencyEdge& e) { return e.targetRegion == id; }), list.end());
+            }
+            adjacencyMap_.erase(it);
+        };
+        for (const auto& id : changes.removedRegions) detach(id);
+        for (const auto& id : changes.modifiedRegions) detach(id);
+
+        // Reattach added and modified regions against the current model.
+        auto attach = [this, &model](const RegionID& id) {
+            const BrainRegion* r1 = model.getRegion(id);
+            if (!r1) return;
+            RegionAdjacency& adjacency = adjacencyMap_[id];
+            adjacency.regionId = id;
+            for (const auto& [otherId, r2] : model.getRegions()) {
+                if (otherId == id) continue;
+                AdjacencyEdge edge;
+                if (!computeAdjacency(*r1, r2, edge)) continue;
+                linkOnce(adjacency.neighbors, edge);
+
+                AdjacencyEdge back;
+                computeAdjacency(r2, *r1, back);
+                RegionAdjacency& other = adjacencyMap_[otherId];
+                other.regionId = otherId;
+                linkOnce(other.neighbors, back);
+            }
+        };
+        for (const auto& id : changes.addedRegions) attach(id);
+        for (const auto& id : changes.modifiedRegions) attach(id);
+        indexCenters(model);
+    }
+
+    const RegionAdjacency* getAdjacency(const RegionID& id) const override {
+        auto it = adjacencyMap_.find(id);
+        return it == adjacencyMap_.end() ? nullptr : &it->second;
     }
 
     RegionID findNearestRegion(const Vec3& point) const override {
-        // This would use a spatial tree in a real implementation
-        return ""; // Stub
+        if (!centers_) return "";
+        auto hits = centers_->nearest(point.x, point.y, point.z, 1);
+        return hits.empty() ? "" : centerIds_[hits[0].nodeId];
     }
 
 private:
+    static constexpr size_t kMinRegionsPerChunk = 1024;
+
+    struct GridCell {
+        int64_t x, y, z;
+        bool operator==(const GridCell& o) const { return x == o.x && y == o.y && z == o.z; }
+    };
+    struct GridCellHash {
+        size_t operator()(const GridCell& c) const {
+            uint64_t h = static_cast<uint64_t>(c.x) * 0x9E3779B97F4A7C15ULL;
+            h ^= static_cast<uint64_t>(c.y) * 0xC2B2AE3D27D4EB4FULL;
+            h ^= static_cast<uint64_t>(c.z) * 0x165667B19E3779F9ULL;
+            return std::hash<uint64_t>{}(h);
+        }
+    };
+
+    static GridCell cellOf(const Vec3& p, float cellSize) {
+        return {static_cast<int64_t>(std::floor(p.x / cellSize)), static_cast<int64_t>(std::floor(p.y / cellSize)),
+                static_cast<int64_t>(std::floor(p.z / cellSize))};
+    }
+
+    // Point index over region centers, keyed by position in centerIds_.
+    void indexCenters(const BrainModel& model) {
+        centerIds_.clear();
+        std::vector<render::SpatialEntry> entries;
+        render::SpatialBounds bounds{0, 0, 0, 0, 0, 0};
+        for (const auto& [id, region] : model.getRegions()) {
+            const Vec3& c = region.center;
+            if (entries.empty()) bounds = {c.x, c.y, c.z, c.x, c.y, c.z};
+            bounds = {std::min(bounds.x1, c.x), std::min(bounds.y1, c.y), std::min(bounds.z1, c.z),
+                      std::max(bounds.x2, c.x), std::max(bounds.y2, c.y), std::max(bounds.z2, c.z)};
+            entries.push_back({static_cast<int>(centerIds_.size()), c.x, c.y, c.z});
+            centerIds_.push_back(id);
+        }
+        centers_ = std::make_unique<render::OctreeIndex>(bounds);
+        centers_->build(std::move(entries));
+    }
+
+    // Two touched regions may both try to link each other.
+    static void linkOnce(std::vector<AdjacencyEdge>& list, const AdjacencyEdge& edge) {
+        for (const auto& e : list) {
+            if (e.targetRegion == edge.targetRegion) return;
+        }
+        list.push_back(edge);
+    }
+
     std::unordered_map<RegionID, RegionAdjacency> adjacencyMap_;
+    std::unique_ptr<render::OctreeIndex> centers_;
+    std::vector<RegionID> centerIds_;
 };
 
 class SimpleLabelPlacementPolicy : public LabelPlacementPolicy {
@@ -67,14 +208,23 @@ public:
         // Track occupied cells to avoid collisions
         std::vector<bool> occupied(canvas.cells.size(), false);
 
-        // Collect all unique regions in the canvas
-        std::map<RegionID, std::vector<std::pair<int, int>>> regionPixels;
+        // Centroid sums per region, accumulated over runs of equal cells
+        struct PixelSum { long long x = 0, y = 0, count = 0; };
+        std::map<RegionID, PixelSum> regionPixels;
         for (int y = 0; y < canvas.height; ++y) {
-            for (int x = 0; x < canvas.width; ++x) {
-                const auto& cell = canvas.at(x, y);
-                if (!cell.regionId.empty()) {
-                    regionPixels[cell.regionId].push_back({x, y});
+            int x = 0;
+            while (x < canvas.width) {
+                const RegionID& id = canvas.at(x, y).regionId;
+                int end = x + 1;
+                while (end < canvas.width && canvas.at(end, y).regionId == id) ++end;
+                if (!id.empty()) {
+                    long long n = end - x;
+                    auto& sum = regionPixels[id];
+                    sum.x += n * (x + end - 1) / 2;
+                    sum.y += n * y;
+                    sum.count += n;
                 }
+                x = end;
             }
         }
 
@@ -92,13 +242,11 @@ public:
         // Try to place labels
         for (const auto* region : regionsToLabel) {
             const auto& pixels = regionPixels[region->id];
-            if (pixels.empty()) continue;
+            if (pixels.count == 0) continue;
 
             // Calculate centroid as anchor
-            int sumX = 0, sumY = 0;
-            for (const auto& p : pixels) { sumX += p.first; sumY += p.second; }
-            int cx = sumX / pixels.size();
-            int cy = sumY / pixels.size();
+            int cx = static_cast<int>(pixels.x / pixels.count);
+            int cy = static_cast<int>(pixels.y / pixels.count);
 
             std::string labelText = region->regionCode;
             if (labelText.empty()) labelText = region->id.substr(0, 3);
@@ -127,73 +275,49 @@ public:
 class BrainTextTopologyImpl : public BrainTextTopology {
 public:
     TextSlice generateSlice(const BrainModel& model, TextSlice::Plane plane, float position, int resolution) override {
-        TextSlice slice;
-        slice.plane = plane;
-        slice.position = position;
-
-        slice.canvas.width = resolution;
-        slice.canvas.height = resolution;
-        slice.canvas.cells.resize(resolution * resolution);
+        if (Config::sliceCacheBudgetKB > 0) cache_.setBudget(static_cast<size_t>(Config::sliceCacheBudgetKB) << 10);
+        if (cacheStamp_.update(model)) cache_.clear();
 
-        float range = 200.0f;
-        float halfRange = range / 2.0f;
-
-        std::set<RegionID> regionsInSlice;
-        for (int y = 0; y < resolution; ++y) {
-            for (int x = 0; x < resolution; ++x) {
-                float px, py, pz;
-                float fx = (static_cast<float>(x) / resolution) * range - halfRange;
-                float fy = (static_cast<float>(y) / resolution) * range - halfRange;
-
-                if (plane == TextSlice::Plane::Axial) {
-                    px = fx; py = fy; pz = position;
-                } else if (plane == TextSlice::Plane::Coronal) {
-                    px = fx; py = position; pz = fy;
-                } else { // Sagittal
-                    px = position; py = fx; pz = fy;
-                }
-
-                RegionID regionId = model.findRegionAt({px, py, pz});
-                auto& cell = slice.canvas.at(x, y);
-                cell.regionId = regionId;
-                cell.symbol = regionId.empty() ? '.' : '#';
-                if (!regionId.empty()) regionsInSlice.insert(regionId);
-            }
+        // Positions closer than one pixel pitch share a slice.
+        SliceCache::Key key = sliceKey(model, plane, position, resolution);
+        TextSlice slice;
+        if (!cache_.get(key, slice)) {
+            slice = rasterizeSlice(*model.getRegionHierarchy(), plane, stepPosition(key.step, resolution), resolution);
+            cache_.put(key, slice);
         }
 
+        // Labels depend on region metadata, so they are placed after the cache.
         SimpleLabelPlacementPolicy policy;
         policy.placeLabels(model, slice.canvas);
-
-        std::stringstream ss;
-        ss << "Slice Summary: Plane=" << (int)plane << " Pos=" << position
-           << " Regions=" << regionsInSlice.size();
-        slice.summary = ss.str();
-
         return slice;
     }
 
+    void precomputeSlices(const BrainModel& model, TextSlice::Plane plane, float position, int resolution,
+                          int radius) override {
+        if (cacheStamp_.update(model)) cache_.clear();
+        std::shared_ptr<const RegionBvh> hierarchy; // built only if some slice is missing
+        SliceCache::Key center = sliceKey(model, plane, position, resolution);
+        for (int d = 1; d <= radius; ++d) {
+            for (int step : {center.step + d, center.step - d}) {
+                SliceCache::Key key = center;
+                key.step = step;
+                if (cache_.contains(key)) continue;
+                if (!hierarchy) hierarchy = model.getRegionHierarchy();
+                cache_.prefetch(key, [hierarchy, plane, step, resolution] {
+                    return rasterizeSlice(*hierarchy, plane, stepPosition(step, resolution), resolution);
+                });
+            }
+        }
+    }
+
     std::vector<RegionID> getNeighborhood(const BrainModel& model, const RegionID& id) override {
+        // The index is rebuilt only when the model changed since the last query.
+        if (indexStamp_.update(model)) indexer_.buildIndex(model);
+
         std::vector<RegionID> neighbors;
-        TopologyIndexerImpl indexer;
-        indexer.buildIndex(model);
-
-        // Find adjacency for this region
-        // Since we don't expose adjacencyMap_ in the interface, we'd normally use a internal method
-        // For this demo, we'll just re-calculate it or use the indexer if it had a query method
-        const auto& regions = model.getRegions();
-        auto it = regions.find(id);
-        if (it == regions.end()) return neighbors;
-
-        const auto& r1 = it->second;
-        for (const auto& [nid, r2] : regions) {
-            if (id == nid) continue;
-            float dx = r1.center.x - r2.center.x;
-            float dy = r1.center.y - r2.center.y;
-            float dz = r1.center.z - r2.center.z;
-            float distSq = dx*dx + dy*dy + dz*dz;
-            if (distSq < (r1.radius + r2.radius) * (r1.radius + r2.radius) * 1.44f) {
-                neighbors.push_back(nid);
-            }
+        if (const RegionAdjacency* adjacency = indexer_.getAdjacency(id)) {
+            neighbors.reserve(adjacency->neighbors.size());
+            for (const auto& edge : adjacency->neighbors) neighbors.push_back(edge.targetRegion);
         }
         return neighbors;
     }
@@ -279,12 +403,60 @@ public:
     }
 
 private:
+    static constexpr float kSliceRange = 200.0f;
+
+    static SliceCache::Key sliceKey(const BrainModel& model, TextSlice::Plane plane, float position, int resolution) {
+        int32_t step = resolution > 0 ? static_cast<int32_t>(std::lround(position * resolution / kSliceRange)) : 0;
+        return {model.getVersion(), plane, step, resolution};
+    }
+
+    static float stepPosition(int32_t step, int resolution) {
+        return resolution > 0 ? step * kSliceRange / resolution : 0.0f;
+    }
+
+    // Identifies the model state derived data was built from. Versions are per
+    // model, so the model's address is part of the stamp.
+    struct ModelStamp {
+        const BrainModel* model = nullptr;
+        uint64_t version = 0;
+
+        // Returns true, and records `current`, if it differs from the stamp.
+        bool update(const BrainModel& current) {
+            if (model == &current && version == current.getVersion()) return false;
+            model = &current;
+            version = current.getVersion();
+            return true;
+        }
+    };
+
+    static TextSlice rasterizeSlice(const RegionBvh& hierarchy, TextSlice::Plane plane, float position, int resolution) {
+        TextSlice slice;
+        slice.plane = plane;
+        slice.position = position;
+
+        slice.canvas.width = resolution;
+        slice.canvas.height = resolution;
+        slice.canvas.cells.resize(resolution * resolution);
+
+        // Regions are scan-converted per row; see SliceRasterizer.
+        size_t regionsInSlice = SliceRasterizer::rasterize(hierarchy, plane, position, kSliceRange, slice.canvas);
+
+        std::stringstream ss;
+        ss << "Slice Summary: Plane=" << (int)plane << " Pos=" << position
+           << " Regions=" << regionsInSlice;
+        slice.summary = ss.str();
+        return slice;
+    }
 
+    TopologyIndexerImpl indexer_;
+    ModelStamp indexStamp_;
+    ModelStamp cacheStamp_;
+    SliceCache cache_; // last: queued prefetches finish before the hierarchies they hold are released
 
     void printNode(std::stringstream& ss, const RegionID& id, std::map<RegionID, std::vector<RegionID>>& children, int indent, const BrainModel& model) {
         for (int i = 0; i < indent; ++i) ss << "  ";
         const auto* region = model.getRegion(id);
-        ss << "- " << (region ? region->name : id) << " (`" << id << "`)\n";
+        ss << "- " << (region ? region->name : id.str()) << " (`" << id << "`)\n";
 
         auto it = children.find(id);
         if (it != children.end()) {
@@ -18,7 +18,11 @@ class BrainTextTopology {
 public:
     virtual ~BrainTextTopology() = default;
 
+    // Slices are cached per model version; positions snap to the pixel pitch (range / resolution).
     virtual TextSlice generateSlice(const BrainModel& model, TextSlice::Plane plane, float position, int resolution) = 0;
+    // Builds the `radius` neighboring slices on each side in the background, e.g. while the user is idle.
+    virtual void precomputeSlices(const BrainModel& model, TextSlice::Plane plane, float position, int resolution,
+                                  int radius) = 0;
     virtual std::vector<RegionID> getNeighborhood(const BrainModel& model, const RegionID& id) = 0;
 
     virtual std::string generateHierarchyTree(const BrainModel& model) = 0;
@@ -35,6 +39,10 @@ class TopologyIndexer {
 public:
     virtual ~TopologyIndexer() = default;
     virtual void buildIndex(const BrainModel& model) = 0;
+    // Recomputes adjacency only for regions named in `changes`.
+    virtual void updateIndex(const BrainModel& model, const AtlasChangeSet& changes) = 0;
+    // Adjacency of one region from the last build/update, or nullptr if unknown.
+    virtual const RegionAdjacency* getAdjacency(const RegionID& id) const = 0;
     virtual RegionID findNearestRegion(const Vec3& point) const = 0;
 };
 
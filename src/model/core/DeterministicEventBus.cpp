@@ -1,45 +1,168 @@
 #include "model/core/DeterministicEventBus.h"
-#include <algorithm>
+#include <thread>
 
 namespace brain_model::core {
 
+namespace {
+
+// Bus whose handlers are running on this thread, if any.
+thread_local const DeterministicEventBus* t_dispatchingBus = nullptr;
+
+// Holds the dispatcher role for the current thread; released on unwind too.
+class DispatchScope {
+public:
+    DispatchScope(std::atomic<bool>& flag, const DeterministicEventBus* bus)
+        : m_flag(flag), m_previous(t_dispatchingBus) {
+        t_dispatchingBus = bus;
+    }
+    ~DispatchScope() {
+        t_dispatchingBus = m_previous;
+        m_flag.store(false, std::memory_order_seq_cst);
+    }
+
+private:
+    std::atomic<bool>& m_flag;
+    const DeterministicEventBus* m_previous;
+};
+
+} // namespace
+
+DeterministicEventBus::DeterministicEventBus()
+    : m_queue(kQueueCapacity), m_subscribers(std::make_shared<const Subscribers>()) {}
+
 void DeterministicEventBus::publish(const contracts::Event& event) {
-    std::lock_guard<std::mutex> lock(m_mutex);
-    if (m_recording) {
-        m_history.push_back(event);
+    if (t_dispatchingBus == this) {
+        if (!m_replaying) m_cascade.push_back(event);
+        return;
     }
+    while (!m_queue.try_push(event)) {
+        // Full: drain it ourselves if nobody is, otherwise let the dispatcher catch up.
+        if (!m_dispatching.exchange(true, std::memory_order_seq_cst)) {
+            DispatchScope scope(m_dispatching, this);
+            drain();
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    pump();
+}
 
-    if (m_subscribers.count(event.type)) {
-        for (const auto& handler : m_subscribers[event.type]) {
-            handler(event);
+void DeterministicEventBus::pump() {
+    // Re-check after releasing: a producer that saw us busy relies on it.
+    do {
+        if (m_dispatching.exchange(true, std::memory_order_seq_cst)) return;
+        DispatchScope scope(m_dispatching, this);
+        drain();
+    } while (!m_queue.empty());
+}
+
+void DeterministicEventBus::drain() {
+    contracts::Event event;
+    while (m_queue.try_pop(event)) {
+        dispatch(event);
+        while (!m_cascade.empty()) {
+            contracts::Event next = std::move(m_cascade.front());
+            m_cascade.pop_front();
+            dispatch(next);
         }
     }
 }
 
-void DeterministicEventBus::subscribe(const std::string& type, contracts::EventHandler handler) {
-    std::lock_guard<std::mutex> lock(m_mutex);
-    m_subscribers[type].push_back(handler);
+void DeterministicEventBus::dispatch(const contracts::Event& event) {
+    if (m_recording.load(std::memory_order_relaxed)) {
+        std::lock_guard<std::mutex> lock(m_historyMutex);
+        if (m_log) m_log->append(event);
+        else m_history.push_back(event);
+    }
+
+    uint64_t generation = m_subscriberGeneration.load(std::memory_order_acquire);
+    if (!m_dispatchSubscribers || generation != m_dispatchGeneration) {
+        m_dispatchSubscribers = std::atomic_load(&m_subscribers);
+        m_dispatchGeneration = generation;
+    }
+    // Holding the table keeps the handler list alive if a handler subscribes.
+    std::shared_ptr<const Subscribers> subscribers = m_dispatchSubscribers;
+    auto it = subscribers->find(event.type);
+    if (it == subscribers->end()) return;
+    for (const auto& handler : it->second) {
+        handler(event);
+    }
+}
+
+void DeterministicEventBus::subscribe(contracts::EventType type, contracts::EventHandler handler) {
+    std::lock_guard<std::mutex> lock(m_subscribeMutex);
+    auto next = std::make_shared<Subscribers>(*std::atomic_load(&m_subscribers));
+    (*next)[type].push_back(std::move(handler));
+    std::atomic_store(&m_subscribers, std::shared_ptr<const Subscribers>(std::move(next)));
+    m_subscriberGeneration.fetch_add(1, std::memory_order_release);
 }
 
 void DeterministicEventBus::start_recording() {
-    std::lock_guard<std::mutex> lock(m_mutex);
-    m_recording = true;
+    std::lock_guard<std::mutex> lock(m_historyMutex);
+    m_log.reset();
     m_history.clear();
+    m_recording.store(true);
+}
+
+bool DeterministicEventBus::start_recording_to(const std::string& path) {
+    std::lock_guard<std::mutex> lock(m_historyMutex);
+    m_history.clear();
+    m_log = std::make_unique<EventLogWriter>(path);
+    if (!m_log->is_open()) {
+        m_log.reset();
+        return false;
+    }
+    m_recording.store(true);
+    return true;
 }
 
 void DeterministicEventBus::stop_recording() {
-    std::lock_guard<std::mutex> lock(m_mutex);
-    m_recording = false;
+    m_recording.store(false);
+    std::lock_guard<std::mutex> lock(m_historyMutex);
+    m_log.reset();
 }
 
-void DeterministicEventBus::replay(const std::vector<contracts::Event>& history) {
-    for (const auto& event : history) {
-        publish(event);
+template <typename Next>
+void DeterministicEventBus::replay_with(Next&& next) {
+    auto run = [&] {
+        bool wasReplaying = m_replaying;
+        m_replaying = true;
+        contracts::Event event;
+        while (next(event)) dispatch(event);
+        m_replaying = wasReplaying;
+    };
+    if (t_dispatchingBus == this) {
+        run();
+        return;
+    }
+    {
+        while (m_dispatching.exchange(true, std::memory_order_seq_cst)) std::this_thread::yield();
+        DispatchScope scope(m_dispatching, this);
+        drain(); // live events queued before the replay go first
+        run();
     }
+    pump();
+}
+
+void DeterministicEventBus::replay(const std::vector<contracts::Event>& history) {
+    size_t i = 0;
+    replay_with([&](contracts::Event& event) {
+        if (i == history.size()) return false;
+        event = history[i++];
+        return true;
+    });
+}
+
+bool DeterministicEventBus::replay_from(const std::string& path, uint64_t from_timestamp_ms) {
+    EventLogReader reader(path);
+    if (!reader.is_open()) return false;
+    reader.seek(from_timestamp_ms);
+    replay_with([&](contracts::Event& event) { return reader.next(event); });
+    return true;
 }
 
 std::vector<contracts::Event> DeterministicEventBus::get_recorded_history() const {
-    std::lock_guard<std::mutex> lock(m_mutex);
+    std::lock_guard<std::mutex> lock(m_historyMutex);
     return m_history;
 }
 
@@ -1,27 +1,69 @@
 #pragma once
 
 #include "model/core/contracts/IEventBus.h"
-#include <map>
+#include "model/core/EventLog.h"
+#include "model/core/EventQueue.h"
+#include <atomic>
+#include <deque>
+#include <memory>
 #include <mutex>
+#include <unordered_map>
 #include <vector>
 
 namespace brain_model::core {
 
+// Events are queued by any thread and dispatched by one thread at a time,
+// outside every lock, so handlers may publish and subscribe freely. Events a
+// handler publishes run after the current event and before the next queued
+// one, which makes each event's cascade deterministic. A publisher that finds
+// the bus idle dispatches itself; otherwise the active dispatcher picks its
+// event up before returning.
 class DeterministicEventBus : public contracts::IEventBus {
 public:
+    static constexpr size_t kQueueCapacity = 1u << 16;
+
+    DeterministicEventBus();
+
     void publish(const contracts::Event& event) override;
-    void subscribe(const std::string& type, contracts::EventHandler handler) override;
+    void subscribe(contracts::EventType type, contracts::EventHandler handler) override;
 
     void start_recording() override;
     void stop_recording() override;
+    // Events handlers publish during a replay are dropped: the recorded history
+    // already contains them.
     void replay(const std::vector<contracts::Event>& history) override;
     std::vector<contracts::Event> get_recorded_history() const override;
 
+    // While recording to a file the in-memory history stays empty;
+    // stop_recording() finalizes the log.
+    bool start_recording_to(const std::string& path) override;
+    bool replay_from(const std::string& path, uint64_t from_timestamp_ms) override;
+
 private:
-    std::map<std::string, std::vector<contracts::EventHandler>> m_subscribers;
+    using Subscribers = std::unordered_map<contracts::EventType, std::vector<contracts::EventHandler>>;
+
+    void pump(); // dispatches until the queue is empty unless another thread is
+    void drain();
+    void dispatch(const contracts::Event& event);
+    // next(Event&) yields the events to replay until it returns false.
+    template <typename Next>
+    void replay_with(Next&& next);
+
+    EventQueue m_queue;
+    std::atomic<bool> m_dispatching{false};
+    std::deque<contracts::Event> m_cascade; // events published by handlers; dispatcher only
+    bool m_replaying = false;               // dispatcher only
+
+    std::shared_ptr<const Subscribers> m_subscribers; // copy-on-write, read with std::atomic_load
+    std::atomic<uint64_t> m_subscriberGeneration{0};
+    std::shared_ptr<const Subscribers> m_dispatchSubscribers; // dispatcher's cached copy
+    uint64_t m_dispatchGeneration = 0;
+    std::mutex m_subscribeMutex;
+
+    std::atomic<bool> m_recording{false};
     std::vector<contracts::Event> m_history;
-    bool m_recording = false;
-    mutable std::mutex m_mutex;
+    std::unique_ptr<EventLogWriter> m_log;
+    mutable std::mutex m_historyMutex;
 };
 
 } // namespace brain_model::core
@@ -0,0 +1,301 @@
+#include "model/core/EventLog.h"
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+
+namespace brain_model::core {
+
+namespace {
+
+constexpr char kLogMagic[8] = {'B', 'M', 'E', 'V', 'L', 'O', 'G', '1'};
+constexpr char kFooterMagic[8] = {'B', 'M', 'E', 'V', 'I', 'D', 'X', '1'};
+constexpr uint32_t kFormatVersion = 1;
+constexpr uint64_t kHeaderSize = 16;
+constexpr uint64_t kFooterSize = 16;
+constexpr size_t kFlushBytes = 1u << 16;
+
+enum RecordKind : uint8_t { kCheckpoint = 1, kSymbol = 2, kEvent = 3, kIndex = 4 };
+
+void put_varint(std::vector<uint8_t>& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value) | 0x80);
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+template <typename T>
+void put_raw(std::vector<uint8_t>& out, const T& value) {
+    const auto* bytes = reinterpret_cast<const uint8_t*>(&value);
+    out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+uint64_t zigzag(int64_t v) { return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63); }
+int64_t unzigzag(uint64_t v) { return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1); }
+
+// Bounds-checked cursor over one record body.
+struct Cursor {
+    const uint8_t* p;
+    const uint8_t* end;
+    bool ok = true;
+
+    uint64_t varint() {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (p == end) break;
+            uint8_t byte = *p++;
+            value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) return value;
+        }
+        ok = false;
+        return 0;
+    }
+
+    template <typename T>
+    T raw() {
+        T value{};
+        if (static_cast<size_t>(end - p) < sizeof(T)) {
+            ok = false;
+            return value;
+        }
+        std::memcpy(&value, p, sizeof(T));
+        p += sizeof(T);
+        return value;
+    }
+};
+
+} // namespace
+
+EventLogWriter::EventLogWriter(const std::string& path, uint32_t eventsPerCheckpoint)
+    : m_file(path, std::ios::binary | std::ios::trunc),
+      m_eventsPerCheckpoint(std::max<uint32_t>(eventsPerCheckpoint, 1)) {
+    if (!m_file.is_open()) return;
+    m_buffer.insert(m_buffer.end(), kLogMagic, kLogMagic + sizeof(kLogMagic));
+    put_raw(m_buffer, kFormatVersion);
+    put_raw(m_buffer, m_eventsPerCheckpoint);
+    m_offset = m_buffer.size();
+}
+
+EventLogWriter::~EventLogWriter() {
+    close();
+}
+
+void EventLogWriter::emit(uint8_t kind, const std::vector<uint8_t>& body) {
+    size_t before = m_buffer.size();
+    put_varint(m_buffer, body.size() + 1);
+    m_buffer.push_back(kind);
+    m_buffer.insert(m_buffer.end(), body.begin(), body.end());
+    m_offset += m_buffer.size() - before;
+}
+
+void EventLogWriter::flush() {
+    m_file.write(reinterpret_cast<const char*>(m_buffer.data()), static_cast<std::streamsize>(m_buffer.size()));
+    m_buffer.clear();
+}
+
+uint32_t EventLogWriter::local_id(model::Symbol symbol) {
+    if (symbol.empty()) return 0;
+    auto [it, inserted] = m_dictionary.emplace(symbol.handle(), static_cast<uint32_t>(m_dictionary.size() + 1));
+    if (inserted) {
+        const std::string& text = symbol.str();
+        std::vector<uint8_t> body(text.begin(), text.end());
+        emit(kSymbol, body);
+    }
+    return it->second;
+}
+
+void EventLogWriter::append(const contracts::Event& event) {
+    if (!is_open()) return;
+    if (m_events % m_eventsPerCheckpoint == 0) {
+        m_dictionary.clear();
+        m_checkpoints.push_back({m_offset, m_events, event.timestamp_ms});
+        m_body.clear();
+        put_raw(m_body, m_events);
+        put_raw(m_body, event.timestamp_ms);
+        emit(kCheckpoint, m_body);
+        m_previousTimestamp = event.timestamp_ms;
+    }
+
+    // Definitions go out before the event that refers to them.
+    uint32_t type = local_id(event.type);
+    const model::Symbol* symbolPayload = std::get_if<model::Symbol>(&event.payload);
+    uint32_t symbol = symbolPayload ? local_id(*symbolPayload) : 0;
+
+    m_body.clear();
+    put_varint(m_body, type);
+    put_varint(m_body, zigzag(static_cast<int64_t>(event.timestamp_ms - m_previousTimestamp)));
+    m_body.push_back(static_cast<uint8_t>(event.payload.index()));
+    std::visit([&](const auto& value) {
+        using T = std::decay_t<decltype(value)>;
+        if constexpr (std::is_same_v<T, bool>) m_body.push_back(value ? 1 : 0);
+        else if constexpr (std::is_same_v<T, int64_t>) put_varint(m_body, zigzag(value));
+        else if constexpr (std::is_same_v<T, double>) put_raw(m_body, value);
+        else if constexpr (std::is_same_v<T, model::Symbol>) put_varint(m_body, symbol);
+        else if constexpr (std::is_same_v<T, std::array<float, 3>>) put_raw(m_body, value);
+    }, event.payload);
+    emit(kEvent, m_body);
+
+    m_previousTimestamp = event.timestamp_ms;
+    ++m_events;
+    if (m_buffer.size() >= kFlushBytes) flush();
+}
+
+void EventLogWriter::close() {
+    if (!is_open()) return;
+    uint64_t indexOffset = m_offset;
+    m_body.clear();
+    put_varint(m_body, m_checkpoints.size());
+    for (const auto& checkpoint : m_checkpoints) {
+        put_raw(m_body, checkpoint.offset);
+        put_raw(m_body, checkpoint.ordinal);
+        put_raw(m_body, checkpoint.timestamp_ms);
+    }
+    emit(kIndex, m_body);
+    put_raw(m_buffer, indexOffset);
+    m_buffer.insert(m_buffer.end(), kFooterMagic, kFooterMagic + sizeof(kFooterMagic));
+    flush();
+    m_file.close();
+}
+
+EventLogReader::EventLogReader(const std::string& path) : m_file(path, std::ios::binary) {
+    char magic[sizeof(kLogMagic)];
+    uint32_t version = 0, eventsPerCheckpoint = 0;
+    m_file.read(magic, sizeof(magic));
+    m_file.read(reinterpret_cast<char*>(&version), sizeof(version));
+    m_file.read(reinterpret_cast<char*>(&eventsPerCheckpoint), sizeof(eventsPerCheckpoint));
+    m_valid = m_file && std::memcmp(magic, kLogMagic, sizeof(kLogMagic)) == 0 && version == kFormatVersion;
+    if (!m_valid) return;
+    load_index();
+    seek(0);
+}
+
+bool EventLogReader::read_length(uint64_t& length) {
+    length = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        int byte = m_file.get();
+        if (byte == std::char_traits<char>::eof()) return false;
+        length |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) return length > 0;
+    }
+    return false;
+}
+
+bool EventLogReader::read_record(uint8_t& kind) {
+    uint64_t length;
+    if (!read_length(length)) return false;
+    int byte = m_file.get();
+    if (byte == std::char_traits<char>::eof()) return false;
+    kind = static_cast<uint8_t>(byte);
+    m_body.resize(length - 1);
+    m_file.read(reinterpret_cast<char*>(m_body.data()), static_cast<std::streamsize>(m_body.size()));
+    return static_cast<uint64_t>(m_file.gcount()) == m_body.size();
+}
+
+void EventLogReader::load_index() {
+    m_file.seekg(0, std::ios::end);
+    uint64_t size = static_cast<uint64_t>(m_file.tellg());
+    if (size >= kHeaderSize + kFooterSize) {
+        uint64_t indexOffset = 0;
+        char magic[sizeof(kFooterMagic)];
+        m_file.seekg(static_cast<std::streamoff>(size - kFooterSize));
+        m_file.read(reinterpret_cast<char*>(&indexOffset), sizeof(indexOffset));
+        m_file.read(magic, sizeof(magic));
+        uint8_t kind = 0;
+        if (m_file && std::memcmp(magic, kFooterMagic, sizeof(kFooterMagic)) == 0 && indexOffset < size) {
+            m_file.seekg(static_cast<std::streamoff>(indexOffset));
+            if (read_record(kind) && kind == kIndex) {
+                Cursor in{m_body.data(), m_body.data() + m_body.size()};
+                uint64_t count = in.varint();
+                for (uint64_t i = 0; i < count && in.ok; ++i) {
+                    Checkpoint checkpoint;
+                    checkpoint.offset = in.raw<uint64_t>();
+                    checkpoint.ordinal = in.raw<uint64_t>();
+                    checkpoint.timestamp_ms = in.raw<uint64_t>();
+                    m_checkpoints.push_back(checkpoint);
+                }
+                if (in.ok) return;
+                m_checkpoints.clear();
+            }
+        }
+    }
+    scan_index();
+}
+
+// Recovers checkpoints from a log without a footer, reading only their bodies.
+void EventLogReader::scan_index() {
+    m_file.clear();
+    m_file.seekg(static_cast<std::streamoff>(kHeaderSize));
+    for (;;) {
+        uint64_t offset = static_cast<uint64_t>(m_file.tellg());
+        uint64_t length;
+        if (!read_length(length)) break;
+        int kind = m_file.get();
+        if (kind == kCheckpoint) {
+            Checkpoint checkpoint{offset, 0, 0};
+            m_file.read(reinterpret_cast<char*>(&checkpoint.ordinal), sizeof(checkpoint.ordinal));
+            m_file.read(reinterpret_cast<char*>(&checkpoint.timestamp_ms), sizeof(checkpoint.timestamp_ms));
+            if (!m_file) break;
+            m_checkpoints.push_back(checkpoint);
+        } else if (kind == std::char_traits<char>::eof() || kind == kIndex) {
+            break;
+        } else {
+            m_file.seekg(static_cast<std::streamoff>(length - 1), std::ios::cur);
+        }
+    }
+}
+
+void EventLogReader::seek(uint64_t timestamp_ms) {
+    if (!m_valid) return;
+    // The segment before the first one starting at or after the target may
+    // still hold events stamped with it.
+    auto it = std::lower_bound(m_checkpoints.begin(), m_checkpoints.end(), timestamp_ms,
+                               [](const Checkpoint& c, uint64_t t) { return c.timestamp_ms < t; });
+    if (it != m_checkpoints.begin()) --it;
+    uint64_t offset = it == m_checkpoints.end() ? kHeaderSize : it->offset;
+    m_file.clear();
+    m_file.seekg(static_cast<std::streamoff>(offset));
+    m_dictionary.clear();
+    m_skipBefore = timestamp_ms;
+}
+
+bool EventLogReader::next(contracts::Event& out) {
+    uint8_t kind = 0;
+    while (m_valid && read_record(kind)) {
+        Cursor in{m_body.data(), m_body.data() + m_body.size()};
+        if (kind == kCheckpoint) {
+            m_dictionary.clear();
+            in.raw<uint64_t>();
+            m_previousTimestamp = in.raw<uint64_t>();
+        } else if (kind == kSymbol) {
+            m_dictionary.emplace_back(std::string_view(reinterpret_cast<const char*>(m_body.data()), m_body.size()));
+        } else if (kind == kIndex) {
+            return false;
+        } else if (kind == kEvent) {
+            auto symbolAt = [&](uint64_t id) {
+                if (id > m_dictionary.size()) in.ok = false;
+                return id == 0 || !in.ok ? model::Symbol() : m_dictionary[id - 1];
+            };
+            contracts::Event event;
+            event.type = symbolAt(in.varint());
+            event.timestamp_ms = m_previousTimestamp + static_cast<uint64_t>(unzigzag(in.varint()));
+            switch (in.raw<uint8_t>()) {
+                case 0: break;
+                case 1: event.payload = in.raw<uint8_t>() != 0; break;
+                case 2: event.payload = unzigzag(in.varint()); break;
+                case 3: event.payload = in.raw<double>(); break;
+                case 4: event.payload = symbolAt(in.varint()); break;
+                case 5: event.payload = in.raw<std::array<float, 3>>(); break;
+                default: in.ok = false; break;
+            }
+            if (!in.ok) return false;
+            m_previousTimestamp = event.timestamp_ms;
+            if (event.timestamp_ms < m_skipBefore) continue;
+            out = std::move(event);
+            return true;
+        }
+        if (!in.ok) return false;
+    }
+    return false;
+}
+
+} // namespace brain_model::core
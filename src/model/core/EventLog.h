@@ -0,0 +1,85 @@
+#pragma once
+
+#include "model/core/contracts/IEventBus.h"
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace brain_model::core {
+
+// On-disk event recording. The log is a stream of length-prefixed records
+// split into segments of a fixed number of events. Each segment opens with a
+// checkpoint (event ordinal and first timestamp) and defines the type and
+// symbol names it uses, so reading can start at any checkpoint. A clean close
+// appends the checkpoint index and a footer pointing at it; a log cut short
+// is still readable, and its index is rebuilt by skipping from record to
+// record.
+class EventLogWriter {
+public:
+    static constexpr uint32_t kDefaultEventsPerCheckpoint = 4096;
+
+    explicit EventLogWriter(const std::string& path, uint32_t eventsPerCheckpoint = kDefaultEventsPerCheckpoint);
+    ~EventLogWriter();
+
+    bool is_open() const { return m_file.is_open(); }
+    void append(const contracts::Event& event);
+    // Writes the index and footer; further appends are ignored.
+    void close();
+
+    uint64_t event_count() const { return m_events; }
+
+private:
+    struct Checkpoint {
+        uint64_t offset, ordinal, timestamp_ms;
+    };
+
+    uint32_t local_id(model::Symbol symbol);
+    void emit(uint8_t kind, const std::vector<uint8_t>& body);
+    void flush();
+
+    std::ofstream m_file;
+    uint32_t m_eventsPerCheckpoint;
+    uint64_t m_offset = 0;         // bytes written, including m_buffer
+    uint64_t m_events = 0;
+    uint64_t m_previousTimestamp = 0;
+    std::vector<uint8_t> m_buffer;
+    std::vector<uint8_t> m_body;
+    std::unordered_map<uint32_t, uint32_t> m_dictionary; // symbol handle -> segment-local id
+    std::vector<Checkpoint> m_checkpoints;
+};
+
+class EventLogReader {
+public:
+    explicit EventLogReader(const std::string& path);
+
+    bool is_open() const { return m_valid; }
+    // Positions the stream before the first event stamped at or after
+    // `timestamp_ms`. Timestamps are expected not to decrease within a log.
+    void seek(uint64_t timestamp_ms);
+    bool next(contracts::Event& out);
+
+    // From the footer index, or rebuilt by scanning a log that was cut short.
+    size_t checkpoint_count() const { return m_checkpoints.size(); }
+
+private:
+    struct Checkpoint {
+        uint64_t offset, ordinal, timestamp_ms;
+    };
+
+    bool read_length(uint64_t& length);
+    bool read_record(uint8_t& kind);
+    void load_index();
+    void scan_index();
+
+    std::ifstream m_file;
+    bool m_valid = false;
+    uint64_t m_skipBefore = 0;
+    uint64_t m_previousTimestamp = 0;
+    std::vector<uint8_t> m_body;
+    std::vector<model::Symbol> m_dictionary; // segment-local id - 1 -> symbol
+    std::vector<Checkpoint> m_checkpoints;
+};
+
+} // namespace brain_model::core
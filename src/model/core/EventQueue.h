@@ -0,0 +1,72 @@
+#pragma once
+
+#include "model/core/contracts/IEventBus.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace brain_model::core {
+
+// Bounded lock-free multi-producer queue of events (sequence-numbered ring
+// slots). Events are dequeued in the order their producers claimed slots.
+class EventQueue {
+public:
+    explicit EventQueue(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity) size <<= 1;
+        m_mask = size - 1;
+        m_slots.reset(new Slot[size]);
+        for (size_t i = 0; i < size; ++i) m_slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    // Returns false when the queue is full.
+    bool try_push(const contracts::Event& event) {
+        size_t pos = m_tail.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& slot = m_slots[pos & m_mask];
+            size_t seq = slot.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (m_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                    slot.event = event;
+                    slot.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = m_tail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Single consumer. Returns false when empty or the next slot is still being written.
+    bool try_pop(contracts::Event& out) {
+        size_t pos = m_head.load(std::memory_order_relaxed);
+        Slot& slot = m_slots[pos & m_mask];
+        if (slot.sequence.load(std::memory_order_acquire) != pos + 1) return false;
+        out = std::move(slot.event);
+        m_head.store(pos + 1, std::memory_order_relaxed);
+        slot.sequence.store(pos + m_mask + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Counts claimed slots, including ones whose write has not finished.
+    bool empty() const {
+        return m_tail.load(std::memory_order_seq_cst) == m_head.load(std::memory_order_seq_cst);
+    }
+
+private:
+    struct Slot {
+        std::atomic<size_t> sequence{0};
+        contracts::Event event;
+    };
+
+    std::unique_ptr<Slot[]> m_slots;
+    size_t m_mask = 0;
+    alignas(64) std::atomic<size_t> m_tail{0};
+    alignas(64) std::atomic<size_t> m_head{0};
+};
+
+} // namespace brain_model::core
@@ -1,37 +1,329 @@
 #include "model/core/ModelGraphStore.h"
+#include <algorithm>
+#include <deque>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace brain_model::core {
 
+namespace {
+
+using model::Symbol;
+
+template <typename Record>
+void set_attributes(Record& record, const std::map<std::string, contracts::AttributeValue>& attributes) {
+    std::vector<std::pair<Symbol, const contracts::AttributeValue*>> sorted;
+    sorted.reserve(attributes.size());
+    for (const auto& [key, value] : attributes) sorted.emplace_back(Symbol(key), &value);
+    std::sort(sorted.begin(), sorted.end(),
+              [](const auto& a, const auto& b) { return a.first.handle() < b.first.handle(); });
+    record.keys.reserve(sorted.size());
+    record.values.reserve(sorted.size());
+    for (const auto& [key, value] : sorted) {
+        record.keys.push_back(key);
+        record.values.push_back(*value);
+    }
+}
+
+template <typename Record>
+const contracts::AttributeValue* find_attribute(const Record& record, Symbol key) {
+    auto it = std::lower_bound(record.keys.begin(), record.keys.end(), key,
+                               [](Symbol a, Symbol b) { return a.handle() < b.handle(); });
+    if (it == record.keys.end() || *it != key) return nullptr;
+    return &record.values[it - record.keys.begin()];
+}
+
+template <typename Record>
+std::map<std::string, contracts::AttributeValue> attribute_map(const Record& record) {
+    std::map<std::string, contracts::AttributeValue> out;
+    for (size_t i = 0; i < record.keys.size(); ++i) out.emplace(record.keys[i].str(), record.values[i]);
+    return out;
+}
+
+void index_insert(PersistentTrie<PersistentIdSet>& index, Symbol key, uint32_t id, uint64_t owner) {
+    const PersistentIdSet* existing = index.find(key.handle());
+    PersistentIdSet ids = existing ? *existing : PersistentIdSet();
+    ids.insert(id, owner);
+    index.set(key.handle(), std::move(ids), owner);
+}
+
+void index_erase(PersistentTrie<PersistentIdSet>& index, Symbol key, uint32_t id, uint64_t owner) {
+    const PersistentIdSet* existing = index.find(key.handle());
+    if (!existing) return;
+    PersistentIdSet ids = *existing;
+    ids.erase(id, owner);
+    if (ids.empty()) index.erase(key.handle(), owner);
+    else index.set(key.handle(), std::move(ids), owner);
+}
+
+} // namespace
+
+const contracts::AttributeValue* ModelGraphStore::NodeRecord::attribute(Symbol key) const {
+    return find_attribute(*this, key);
+}
+
+contracts::GraphNode ModelGraphStore::NodeRecord::to_node() const {
+    return contracts::GraphNode{id.str(), domain.str(), type.str(), attribute_map(*this)};
+}
+
+const contracts::AttributeValue* ModelGraphStore::EdgeRecord::attribute(Symbol key) const {
+    return find_attribute(*this, key);
+}
+
+contracts::GraphEdge ModelGraphStore::EdgeRecord::to_edge() const {
+    return contracts::GraphEdge{id.str(), source.str(), target.str(), domain.str(), attribute_map(*this)};
+}
+
+template <typename Fn>
+void ModelGraphStore::Snapshot::for_each_step(Symbol node, const EdgeFilter& filter, Direction direction, Fn&& fn) const {
+    auto follow = [&](const EdgeRecord& edge, Symbol next) {
+        if (!filter.domain.empty() && edge.domain != filter.domain) return;
+        if (!filter.attribute.empty()) {
+            const contracts::AttributeValue* value = edge.attribute(filter.attribute);
+            if (!value || (filter.value && *value != *filter.value)) return;
+        }
+        if (!filter.node_domain.empty()) {
+            const NodeRecord* record = this->node(next);
+            if (!record || record->domain != filter.node_domain) return;
+        }
+        fn(next);
+    };
+    if (direction != Direction::In) {
+        for_each_out_edge(node, [&](const EdgeRecord& edge) { follow(edge, edge.target); });
+    }
+    if (direction != Direction::Out) {
+        for_each_in_edge(node, [&](const EdgeRecord& edge) { follow(edge, edge.source); });
+    }
+}
+
+std::vector<Symbol> ModelGraphStore::Snapshot::neighborhood(Symbol start, uint32_t hops, const EdgeFilter& filter,
+                                                            Direction direction) const {
+    std::vector<Symbol> reached;
+    std::unordered_set<Symbol> seen{start};
+    std::vector<Symbol> ring{start}, next;
+    for (uint32_t hop = 0; hop < hops && !ring.empty(); ++hop) {
+        next.clear();
+        for (Symbol node : ring) {
+            for_each_step(node, filter, direction, [&](Symbol to) {
+                if (seen.insert(to).second) next.push_back(to);
+            });
+        }
+        reached.insert(reached.end(), next.begin(), next.end());
+        ring.swap(next);
+    }
+    return reached;
+}
+
+std::vector<Symbol> ModelGraphStore::Snapshot::shortest_path(Symbol from, Symbol to, const EdgeFilter& filter,
+                                                             Direction direction) const {
+    if (from == to) return {from};
+    std::unordered_map<Symbol, Symbol> parent{{from, from}};
+    std::deque<Symbol> frontier{from};
+    bool found = false;
+    while (!frontier.empty() && !found) {
+        Symbol current = frontier.front();
+        frontier.pop_front();
+        for_each_step(current, filter, direction, [&](Symbol next) {
+            if (found || !parent.emplace(next, current).second) return;
+            found = next == to;
+            frontier.push_back(next);
+        });
+    }
+    if (!found) return {};
+    std::vector<Symbol> path{to};
+    while (path.back() != from) path.push_back(parent[path.back()]);
+    std::reverse(path.begin(), path.end());
+    return path;
+}
+
+ModelGraphStore::ModelGraphStore()
+    : m_head(std::make_shared<const State>()), m_versions{m_head} {}
+
+void ModelGraphStore::put_node(State& state, const contracts::GraphNode& node, uint64_t owner) {
+    auto record = std::make_shared<NodeRecord>();
+    record->id = Symbol(node.id);
+    record->domain = Symbol(node.domain);
+    record->type = Symbol(node.type);
+    set_attributes(*record, node.attributes);
+
+    uint32_t id = record->id.handle();
+    if (const auto* previous = state.nodes.find(id)) {
+        index_erase(state.by_domain, (*previous)->domain, id, owner);
+        index_erase(state.by_type, (*previous)->type, id, owner);
+    } else {
+        ++state.node_count;
+    }
+    index_insert(state.by_domain, record->domain, id, owner);
+    index_insert(state.by_type, record->type, id, owner);
+    state.nodes.set(id, std::move(record), owner);
+}
+
+void ModelGraphStore::put_edge(State& state, const contracts::GraphEdge& edge, uint64_t owner) {
+    auto record = std::make_shared<EdgeRecord>();
+    record->id = Symbol(edge.id);
+    record->source = Symbol(edge.source_id);
+    record->target = Symbol(edge.target_id);
+    record->domain = Symbol(edge.domain);
+    set_attributes(*record, edge.attributes);
+
+    uint32_t id = record->id.handle();
+    if (const auto* previous = state.edges.find(id)) {
+        index_erase(state.out_edges, (*previous)->source, id, owner);
+        index_erase(state.in_edges, (*previous)->target, id, owner);
+    } else {
+        ++state.edge_count;
+    }
+    index_insert(state.out_edges, record->source, id, owner);
+    index_insert(state.in_edges, record->target, id, owner);
+    state.edges.set(id, std::move(record), owner);
+}
+
+// Caller holds m_writeMutex.
+void ModelGraphStore::publish(State state) {
+    state.version = m_firstVersion + static_cast<uint32_t>(m_versions.size());
+    auto next = std::make_shared<const State>(std::move(state));
+    m_versions.push_back(next);
+    std::atomic_store(&m_head, std::move(next));
+    trim_history();
+}
+
+// Caller holds m_writeMutex.
+void ModelGraphStore::trim_history() {
+    while (m_versions.size() > m_historyLimit) {
+        m_versions.pop_front();
+        ++m_firstVersion;
+    }
+}
+
 void ModelGraphStore::add_node(const contracts::GraphNode& node) {
-    m_nodes[node.id] = node;
-    m_version++;
+    add_nodes({node});
 }
 
 void ModelGraphStore::add_edge(const contracts::GraphEdge& edge) {
-    m_edges[edge.id] = edge;
-    m_version++;
+    add_edges({edge});
+}
+
+void ModelGraphStore::add_nodes(const std::vector<contracts::GraphNode>& nodes) {
+    std::lock_guard<std::mutex> lock(m_writeMutex);
+    State next = *m_versions.back();
+    uint64_t owner = ++m_lastOwner;
+    for (const auto& node : nodes) put_node(next, node, owner);
+    publish(std::move(next));
+}
+
+void ModelGraphStore::add_edges(const std::vector<contracts::GraphEdge>& edges) {
+    std::lock_guard<std::mutex> lock(m_writeMutex);
+    State next = *m_versions.back();
+    uint64_t owner = ++m_lastOwner;
+    for (const auto& edge : edges) put_edge(next, edge, owner);
+    publish(std::move(next));
 }
 
 std::optional<contracts::GraphNode> ModelGraphStore::get_node(const std::string& id) const {
-    auto it = m_nodes.find(id);
-    if (it != m_nodes.end()) return it->second;
+    Symbol key = Symbol::find(id);
+    if (key.empty() && !id.empty()) return std::nullopt;
+    const NodeRecord* record = snapshot().node(key);
+    if (record) return record->to_node();
     return std::nullopt;
 }
 
 std::vector<contracts::GraphNode> ModelGraphStore::find_nodes_by_domain(const std::string& domain) const {
     std::vector<contracts::GraphNode> results;
-    for (auto const& [id, node] : m_nodes) {
-        if (node.domain == domain) {
-            results.push_back(node);
-        }
-    }
+    Symbol key = Symbol::find(domain);
+    if (key.empty() && !domain.empty()) return results;
+    snapshot().for_each_node_in_domain(key, [&](const NodeRecord& node) { results.push_back(node.to_node()); });
     return results;
 }
 
-uint32_t ModelGraphStore::current_version() const { return m_version; }
+std::vector<contracts::GraphNode> ModelGraphStore::find_nodes_by_type(const std::string& type) const {
+    std::vector<contracts::GraphNode> results;
+    Symbol key = Symbol::find(type);
+    if (key.empty() && !type.empty()) return results;
+    snapshot().for_each_node_of_type(key, [&](const NodeRecord& node) { results.push_back(node.to_node()); });
+    return results;
+}
+
+std::optional<contracts::GraphEdge> ModelGraphStore::get_edge(const std::string& id) const {
+    Symbol key = Symbol::find(id);
+    if (key.empty() && !id.empty()) return std::nullopt;
+    const EdgeRecord* record = snapshot().edge(key);
+    if (record) return record->to_edge();
+    return std::nullopt;
+}
+
+std::vector<contracts::GraphEdge> ModelGraphStore::get_out_edges(const std::string& node_id) const {
+    std::vector<contracts::GraphEdge> results;
+    Symbol key = Symbol::find(node_id);
+    if (key.empty()) return results;
+    snapshot().for_each_out_edge(key, [&](const EdgeRecord& edge) { results.push_back(edge.to_edge()); });
+    return results;
+}
+
+std::vector<contracts::GraphEdge> ModelGraphStore::get_in_edges(const std::string& node_id) const {
+    std::vector<contracts::GraphEdge> results;
+    Symbol key = Symbol::find(node_id);
+    if (key.empty()) return results;
+    snapshot().for_each_in_edge(key, [&](const EdgeRecord& edge) { results.push_back(edge.to_edge()); });
+    return results;
+}
+
+std::vector<std::string> ModelGraphStore::get_neighborhood(const std::string& node_id, uint32_t hops,
+                                                           const std::string& domain) const {
+    std::vector<std::string> results;
+    Symbol start = Symbol::find(node_id);
+    EdgeFilter filter;
+    filter.node_domain = Symbol::find(domain);
+    if (start.empty() || (filter.node_domain.empty() && !domain.empty())) return results;
+    for (Symbol id : snapshot().neighborhood(start, hops, filter)) results.push_back(id.str());
+    return results;
+}
+
+std::vector<std::string> ModelGraphStore::find_shortest_path(const std::string& from, const std::string& to) const {
+    std::vector<std::string> results;
+    Symbol source = Symbol::find(from), target = Symbol::find(to);
+    if (source.empty() || target.empty()) return results;
+    for (Symbol id : snapshot().shortest_path(source, target)) results.push_back(id.str());
+    return results;
+}
+
+ModelGraphStore::Snapshot ModelGraphStore::snapshot() const {
+    return Snapshot(std::atomic_load(&m_head));
+}
+
+ModelGraphStore::Snapshot ModelGraphStore::snapshot_at(uint32_t version) const {
+    std::lock_guard<std::mutex> lock(m_writeMutex);
+    bool retained = version >= m_firstVersion && version - m_firstVersion < m_versions.size();
+    return Snapshot(retained ? m_versions[version - m_firstVersion] : m_versions.back());
+}
+
+uint32_t ModelGraphStore::current_version() const {
+    return std::atomic_load(&m_head)->version;
+}
 
 void ModelGraphStore::checkout_version(uint32_t version) {
-    m_version = version;
+    std::lock_guard<std::mutex> lock(m_writeMutex);
+    if (version < m_firstVersion || version - m_firstVersion >= m_versions.size()) return;
+    m_versions.resize(version - m_firstVersion + 1);
+    std::atomic_store(&m_head, m_versions.back());
+}
+
+void ModelGraphStore::set_history_limit(size_t limit) {
+    std::lock_guard<std::mutex> lock(m_writeMutex);
+    m_historyLimit = std::max<size_t>(limit, 1);
+    trim_history();
+}
+
+void ModelGraphStore::release_versions_before(uint32_t version) {
+    std::lock_guard<std::mutex> lock(m_writeMutex);
+    while (m_versions.size() > 1 && m_firstVersion < version) {
+        m_versions.pop_front();
+        ++m_firstVersion;
+    }
+}
+
+size_t ModelGraphStore::retained_versions() const {
+    std::lock_guard<std::mutex> lock(m_writeMutex);
+    return m_versions.size();
 }
 
 } // namespace brain_model::core
@@ -1,7 +1,11 @@
 #pragma once
 
 #include "model/core/contracts/IModelGraphStore.h"
-#include <unordered_map>
+#include "model/core/PersistentTrie.h"
+#include "model/symbol.h"
+#include <deque>
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <vector>
 #include <string>
@@ -9,19 +13,177 @@
 
 namespace brain_model::core {
 
+// Multi-version graph store. Every write publishes a new immutable state that
+// shares all untouched structure with its predecessor, so a pinned snapshot
+// stays valid and can be queried without locks while writers move on.
+// Only the most recent versions stay reachable through snapshot_at() and
+// checkout_version(); older ones are released.
 class ModelGraphStore : public contracts::IModelGraphStore {
 public:
+    static constexpr size_t kDefaultHistoryLimit = 1024;
+
+    // Attributes are kept as parallel arrays sorted by key handle.
+    struct NodeRecord {
+        model::Symbol id, domain, type;
+        std::vector<model::Symbol> keys;
+        std::vector<contracts::AttributeValue> values;
+
+        const contracts::AttributeValue* attribute(model::Symbol key) const;
+        contracts::GraphNode to_node() const;
+    };
+
+    struct EdgeRecord {
+        model::Symbol id, source, target, domain;
+        std::vector<model::Symbol> keys;
+        std::vector<contracts::AttributeValue> values;
+
+        const contracts::AttributeValue* attribute(model::Symbol key) const;
+        contracts::GraphEdge to_edge() const;
+    };
+
+private:
+    struct State {
+        uint32_t version = 0;
+        size_t node_count = 0;
+        size_t edge_count = 0;
+        PersistentTrie<std::shared_ptr<const NodeRecord>> nodes;
+        PersistentTrie<std::shared_ptr<const EdgeRecord>> edges;
+        PersistentTrie<PersistentIdSet> by_domain; // domain handle -> node ids
+        PersistentTrie<PersistentIdSet> by_type;   // type handle -> node ids
+        PersistentTrie<PersistentIdSet> out_edges; // source node handle -> edge ids
+        PersistentTrie<PersistentIdSet> in_edges;  // target node handle -> edge ids
+    };
+
+public:
+    enum class Direction { Out, In, Both };
+
+    // Restricts which edges a traversal may follow. Empty fields match anything.
+    struct EdgeFilter {
+        model::Symbol domain;      // edge domain
+        model::Symbol node_domain; // domain of the node the edge leads to
+        model::Symbol attribute;   // edge must carry this attribute...
+        std::optional<contracts::AttributeValue> value; // ...with this value, if set
+    };
+
+    class Snapshot {
+    public:
+        uint32_t version() const { return m_state->version; }
+        size_t node_count() const { return m_state->node_count; }
+        size_t edge_count() const { return m_state->edge_count; }
+
+        const NodeRecord* node(model::Symbol id) const {
+            auto record = m_state->nodes.find(id.handle());
+            return record ? record->get() : nullptr;
+        }
+        const EdgeRecord* edge(model::Symbol id) const {
+            auto record = m_state->edges.find(id.handle());
+            return record ? record->get() : nullptr;
+        }
+
+        // fn(const NodeRecord&); cost is proportional to the matches.
+        template <typename Fn>
+        void for_each_node_in_domain(model::Symbol domain, Fn&& fn) const {
+            for_each_in(m_state->by_domain, domain, fn);
+        }
+        template <typename Fn>
+        void for_each_node_of_type(model::Symbol type, Fn&& fn) const {
+            for_each_in(m_state->by_type, type, fn);
+        }
+
+        // fn(const EdgeRecord&); records stay valid while the snapshot lives.
+        template <typename Fn>
+        void for_each_out_edge(model::Symbol node, Fn&& fn) const {
+            for_each_edge_in(m_state->out_edges, node, fn);
+        }
+        template <typename Fn>
+        void for_each_in_edge(model::Symbol node, Fn&& fn) const {
+            for_each_edge_in(m_state->in_edges, node, fn);
+        }
+
+        // Nodes reachable from `start` in at most `hops` steps, nearest first;
+        // `start` itself is not included.
+        std::vector<model::Symbol> neighborhood(model::Symbol start, uint32_t hops, const EdgeFilter& filter = {},
+                                                Direction direction = Direction::Out) const;
+        // Fewest-edge path from `from` to `to`, both included; empty if unreachable.
+        std::vector<model::Symbol> shortest_path(model::Symbol from, model::Symbol to, const EdgeFilter& filter = {},
+                                                 Direction direction = Direction::Out) const;
+
+    private:
+        friend class ModelGraphStore;
+        explicit Snapshot(std::shared_ptr<const State> state) : m_state(std::move(state)) {}
+
+        template <typename Fn>
+        void for_each_in(const PersistentTrie<PersistentIdSet>& index, model::Symbol key, Fn& fn) const {
+            const PersistentIdSet* ids = index.find(key.handle());
+            if (!ids) return;
+            ids->for_each([&](uint32_t id) {
+                fn(**m_state->nodes.find(id));
+                return true;
+            });
+        }
+
+        template <typename Fn>
+        void for_each_edge_in(const PersistentTrie<PersistentIdSet>& index, model::Symbol node, Fn& fn) const {
+            const PersistentIdSet* ids = index.find(node.handle());
+            if (!ids) return;
+            ids->for_each([&](uint32_t id) {
+                fn(**m_state->edges.find(id));
+                return true;
+            });
+        }
+
+        // Calls fn(next node) for every edge from `node` the filter admits.
+        template <typename Fn>
+        void for_each_step(model::Symbol node, const EdgeFilter& filter, Direction direction, Fn&& fn) const;
+
+        std::shared_ptr<const State> m_state;
+    };
+
+    ModelGraphStore();
+
     void add_node(const contracts::GraphNode& node) override;
     void add_edge(const contracts::GraphEdge& edge) override;
+    void add_nodes(const std::vector<contracts::GraphNode>& nodes) override;
+    void add_edges(const std::vector<contracts::GraphEdge>& edges) override;
+
     std::optional<contracts::GraphNode> get_node(const std::string& id) const override;
     std::vector<contracts::GraphNode> find_nodes_by_domain(const std::string& domain) const override;
+    std::vector<contracts::GraphNode> find_nodes_by_type(const std::string& type) const override;
+    std::optional<contracts::GraphEdge> get_edge(const std::string& id) const override;
+    std::vector<contracts::GraphEdge> get_out_edges(const std::string& node_id) const override;
+    std::vector<contracts::GraphEdge> get_in_edges(const std::string& node_id) const override;
+    std::vector<std::string> get_neighborhood(const std::string& node_id, uint32_t hops,
+                                              const std::string& domain) const override;
+    std::vector<std::string> find_shortest_path(const std::string& from, const std::string& to) const override;
+
+    Snapshot snapshot() const;
+    // Pins an earlier version; unknown or released versions yield the current one.
+    Snapshot snapshot_at(uint32_t version) const;
+
     uint32_t current_version() const override;
+    // Rewinds the head to `version` and discards the later history; snapshots
+    // already pinned keep their state. Unknown or released versions are ignored.
     void checkout_version(uint32_t version) override;
 
+    // Keeps at most `limit` versions, the head included (at least one).
+    void set_history_limit(size_t limit);
+    // Releases every version older than `version`, never the head. Pinned
+    // snapshots keep their state.
+    void release_versions_before(uint32_t version);
+    size_t retained_versions() const;
+
 private:
-    std::unordered_map<std::string, contracts::GraphNode> m_nodes;
-    std::unordered_map<std::string, contracts::GraphEdge> m_edges;
-    uint32_t m_version = 0;
+    void put_node(State& state, const contracts::GraphNode& node, uint64_t owner);
+    void put_edge(State& state, const contracts::GraphEdge& edge, uint64_t owner);
+    void publish(State state);
+    void trim_history();
+
+    std::shared_ptr<const State> m_head; // read with std::atomic_load
+    std::deque<std::shared_ptr<const State>> m_versions; // index + m_firstVersion == version
+    uint32_t m_firstVersion = 0;
+    size_t m_historyLimit = kDefaultHistoryLimit;
+    uint64_t m_lastOwner = 0;
+    mutable std::mutex m_writeMutex;
 };
 
 } // namespace brain_model::core
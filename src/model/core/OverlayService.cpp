@@ -1,4 +1,5 @@
 #include "model/core/OverlayService.h"
+#include <algorithm>
 #include <iostream>
 
 namespace brain_model::core {
@@ -10,7 +11,11 @@ bool OverlayService::load_overlays_from_file(const std::string& path) {
 }
 
 void OverlayService::add_overlay(const contracts::OverlaySpec& spec) {
-    m_entityToOverlays[spec.anchor_entity_id].push_back(spec);
+    auto& overlays = m_entityToOverlays[spec.anchor_entity_id];
+    auto it = std::find_if(overlays.begin(), overlays.end(),
+                           [&](const contracts::OverlaySpec& existing) { return existing.id == spec.id; });
+    if (it != overlays.end()) *it = spec;
+    else overlays.push_back(spec);
 }
 
 std::vector<contracts::OverlaySpec> OverlayService::get_active_overlays_for_entity(const std::string& entity_id) const {
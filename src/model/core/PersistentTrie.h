@@ -0,0 +1,168 @@
+#pragma once
+
+#include <bitset>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace brain_model::core {
+
+// Immutable radix trie keyed by 32-bit ids (symbol handles), 32-way with
+// popcount-compressed nodes. A trie value is just its root pointer: copying it
+// is O(1), and an edit copies only the path to the touched key, so older
+// versions keep sharing everything else. Nodes tagged with the editing batch's
+// owner id were created by that batch and are updated in place.
+template <typename T>
+class PersistentTrie {
+public:
+    bool empty() const { return !m_root; }
+
+    const T* find(uint32_t key) const {
+        const Node* node = m_root.get();
+        for (int shift = kTopShift; node; shift -= kBits) {
+            uint32_t bit = 1u << ((key >> shift) & kMask);
+            if (!(node->bitmap & bit)) return nullptr;
+            size_t i = slot(node->bitmap, bit);
+            if (shift == 0) return &node->values[i];
+            node = node->children[i].get();
+        }
+        return nullptr;
+    }
+
+    // `owner` must be non-zero and unique to one batch of edits.
+    void set(uint32_t key, T value, uint64_t owner) {
+        m_root = set_in(m_root, kTopShift, key, std::move(value), owner);
+    }
+
+    bool erase(uint32_t key, uint64_t owner) {
+        if (!find(key)) return false;
+        m_root = erase_in(m_root, kTopShift, key, owner);
+        return true;
+    }
+
+    // Visits entries in key order; fn(key, const T&) returns false to stop.
+    template <typename Fn>
+    bool for_each(Fn&& fn) const {
+        return m_root ? visit(*m_root, kTopShift, 0, fn) : true;
+    }
+
+private:
+    static constexpr int kBits = 5;
+    static constexpr uint32_t kMask = (1u << kBits) - 1;
+    static constexpr int kTopShift = 30; // levels at 30, 25, ..., 0
+
+    struct Node;
+    using NodePtr = std::shared_ptr<Node>;
+    struct Node {
+        uint64_t owner = 0;
+        uint32_t bitmap = 0;
+        std::vector<NodePtr> children; // inner levels
+        std::vector<T> values;         // last level
+    };
+
+    static size_t slot(uint32_t bitmap, uint32_t bit) {
+        return std::bitset<32>(bitmap & (bit - 1)).count();
+    }
+
+    static NodePtr editable(const NodePtr& node, uint64_t owner) {
+        if (node && node->owner == owner) return node;
+        NodePtr copy = node ? std::make_shared<Node>(*node) : std::make_shared<Node>();
+        copy->owner = owner;
+        return copy;
+    }
+
+    static NodePtr set_in(const NodePtr& node, int shift, uint32_t key, T&& value, uint64_t owner) {
+        NodePtr out = editable(node, owner);
+        uint32_t bit = 1u << ((key >> shift) & kMask);
+        size_t i = slot(out->bitmap, bit);
+        bool present = (out->bitmap & bit) != 0;
+        if (shift == 0) {
+            if (present) out->values[i] = std::move(value);
+            else out->values.insert(out->values.begin() + i, std::move(value));
+        } else {
+            NodePtr child = set_in(present ? out->children[i] : NodePtr(), shift - kBits, key, std::move(value), owner);
+            if (present) out->children[i] = std::move(child);
+            else out->children.insert(out->children.begin() + i, std::move(child));
+        }
+        out->bitmap |= bit;
+        return out;
+    }
+
+    // Returns null once the node has no entries left.
+    static NodePtr erase_in(const NodePtr& node, int shift, uint32_t key, uint64_t owner) {
+        uint32_t bit = 1u << ((key >> shift) & kMask);
+        size_t i = slot(node->bitmap, bit);
+        NodePtr out = editable(node, owner);
+        if (shift == 0) {
+            out->values.erase(out->values.begin() + i);
+            out->bitmap &= ~bit;
+        } else {
+            NodePtr child = erase_in(out->children[i], shift - kBits, key, owner);
+            if (child) {
+                out->children[i] = std::move(child);
+            } else {
+                out->children.erase(out->children.begin() + i);
+                out->bitmap &= ~bit;
+            }
+        }
+        return out->bitmap ? out : NodePtr();
+    }
+
+    template <typename Fn>
+    static bool visit(const Node& node, int shift, uint32_t prefix, Fn& fn) {
+        size_t i = 0;
+        for (uint32_t b = 0; b <= kMask; ++b) {
+            if (!(node.bitmap & (1u << b))) continue;
+            uint32_t key = prefix | (b << shift);
+            if (shift == 0 ? !fn(key, node.values[i]) : !visit(*node.children[i], shift - kBits, key, fn)) return false;
+            ++i;
+        }
+        return true;
+    }
+
+    NodePtr m_root;
+};
+
+// Set of 32-bit ids as a persistent trie of 64-bit membership words.
+class PersistentIdSet {
+public:
+    bool empty() const { return m_words.empty(); }
+
+    bool contains(uint32_t id) const {
+        const uint64_t* word = m_words.find(id >> 6);
+        return word && (*word >> (id & 63)) & 1u;
+    }
+
+    void insert(uint32_t id, uint64_t owner) {
+        const uint64_t* word = m_words.find(id >> 6);
+        uint64_t bits = (word ? *word : 0) | (uint64_t(1) << (id & 63));
+        if (!word || *word != bits) m_words.set(id >> 6, bits, owner);
+    }
+
+    void erase(uint32_t id, uint64_t owner) {
+        const uint64_t* word = m_words.find(id >> 6);
+        if (!word || !((*word >> (id & 63)) & 1u)) return;
+        uint64_t bits = *word & ~(uint64_t(1) << (id & 63));
+        if (bits) m_words.set(id >> 6, bits, owner);
+        else m_words.erase(id >> 6, owner);
+    }
+
+    // fn(id) returns false to stop.
+    template <typename Fn>
+    bool for_each(Fn&& fn) const {
+        return m_words.for_each([&fn](uint32_t index, uint64_t bits) {
+            while (bits) {
+                int b = __builtin_ctzll(bits);
+                if (!fn((index << 6) | static_cast<uint32_t>(b))) return false;
+                bits &= bits - 1;
+            }
+            return true;
+        });
+    }
+
+private:
+    PersistentTrie<uint64_t> m_words;
+};
+
+} // namespace brain_model::core
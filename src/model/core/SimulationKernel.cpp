@@ -36,6 +36,7 @@ void SimulationKernel::set_seed(uint64_t seed) {
     m_rng.seed(m_seed);
 }
 
+uint64_t SimulationKernel::seed() const { return m_seed; }
 uint64_t SimulationKernel::current_time_ms() const { return m_currentTimeMs; }
 bool SimulationKernel::is_running() const { return m_running; }
 
@@ -18,6 +18,7 @@ public:
     void restore_snapshot(const contracts::SimulationSnapshot& snapshot) override;
 
     void set_seed(uint64_t seed) override;
+    uint64_t seed() const override;
 
     uint64_t current_time_ms() const override;
     bool is_running() const override;
@@ -0,0 +1,189 @@
+#include "model/core/SystemScheduler.h"
+#include "analytics/worker_pool.h"
+#include "model/core/contracts/IModelGraphStore.h"
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+namespace brain_model::core {
+
+namespace {
+
+uint64_t mix(uint64_t x) {
+    x += 0x9e3779b97f4a7c15ull;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+    return x ^ (x >> 31);
+}
+
+// FNV-1a: stable across runs and platforms, unlike std::hash.
+uint64_t hash_name(const std::string& name) {
+    uint64_t h = 0xcbf29ce484222325ull;
+    for (unsigned char c : name) h = (h ^ c) * 0x100000001b3ull;
+    return h;
+}
+
+bool intersects(const std::vector<std::string>& a, const std::vector<std::string>& b) {
+    for (const auto& x : a) {
+        if (std::find(b.begin(), b.end(), x) != b.end()) return true;
+    }
+    return false;
+}
+
+bool conflicts(const contracts::SystemAccess& a, const contracts::SystemAccess& b) {
+    return intersects(a.writes, b.writes) || intersects(a.writes, b.reads) || intersects(a.reads, b.writes);
+}
+
+// Same replacement rule as IOverlayService::add_overlay: one spec per id and anchor.
+void replace_or_append(std::vector<contracts::OverlaySpec>& specs, const contracts::OverlaySpec& spec,
+                       const std::string& anchor) {
+    auto it = std::find_if(specs.begin(), specs.end(), [&](const contracts::OverlaySpec& existing) {
+        return existing.id == spec.id && existing.anchor_entity_id == anchor;
+    });
+    if (it != specs.end()) *it = spec;
+    else specs.push_back(spec);
+}
+
+// Buffers a system's overlays until its stage ends; reads see the shared
+// service, which does not change while the stage runs, plus the buffer.
+class StagedOverlays : public contracts::IOverlayService {
+public:
+    StagedOverlays(const contracts::IOverlayService& shared, std::vector<contracts::OverlaySpec>& staged)
+        : m_shared(shared), m_staged(staged) {}
+
+    bool load_overlays_from_file(const std::string&) override { return false; }
+    void add_overlay(const contracts::OverlaySpec& spec) override { replace_or_append(m_staged, spec, spec.anchor_entity_id); }
+
+    std::vector<contracts::OverlaySpec> get_active_overlays_for_entity(const std::string& entity_id) const override {
+        auto result = m_shared.get_active_overlays_for_entity(entity_id);
+        for (const auto& spec : m_staged) {
+            if (spec.anchor_entity_id == entity_id) replace_or_append(result, spec, entity_id);
+        }
+        return result;
+    }
+
+    void render_2d() override {}
+    void render_3d() override {}
+
+private:
+    const contracts::IOverlayService& m_shared;
+    std::vector<contracts::OverlaySpec>& m_staged;
+};
+
+} // namespace
+
+// Buffers a system's store writes until its stage ends.
+class SystemScheduler::StagedGraphWrites : public contracts::IGraphWriter {
+public:
+    void add_node(const contracts::GraphNode& node) override { nodes.push_back(node); }
+    void add_edge(const contracts::GraphEdge& edge) override { edges.push_back(edge); }
+
+    std::vector<contracts::GraphNode> nodes;
+    std::vector<contracts::GraphEdge> edges;
+};
+
+SystemScheduler::SystemScheduler(std::shared_ptr<contracts::ISimulationKernel> kernel,
+                                 std::shared_ptr<contracts::IOverlayService> overlays,
+                                 std::shared_ptr<contracts::IModelGraphStore> store,
+                                 uint32_t step_ms, size_t threads)
+    : m_kernel(std::move(kernel)), m_overlays(std::move(overlays)), m_store(std::move(store)),
+      m_stepMs(std::max<uint32_t>(step_ms, 1)),
+      m_threads(threads ? threads : std::max(1u, std::thread::hardware_concurrency())) {}
+
+SystemScheduler::~SystemScheduler() = default;
+
+void SystemScheduler::add_system(std::shared_ptr<contracts::ISimulationSystem> system) {
+    if (!system) return;
+    Entry entry;
+    entry.access = system->access();
+    entry.graph = std::make_unique<StagedGraphWrites>();
+    SystemStats stats;
+    stats.name = system->name();
+    entry.system = std::move(system);
+    m_entries.push_back(std::move(entry));
+    m_stats.push_back(std::move(stats));
+    m_stagesDirty = true;
+}
+
+void SystemScheduler::add_systems(const contracts::SystemRegistry& registry) {
+    for (const auto& system : registry.systems()) add_system(system);
+}
+
+size_t SystemScheduler::stage_count() {
+    if (m_stagesDirty) build_stages();
+    return m_stages.size();
+}
+
+void SystemScheduler::build_stages() {
+    m_stages.clear();
+    for (size_t i = 0; i < m_entries.size(); ++i) {
+        size_t stage = 0;
+        for (size_t j = 0; j < i; ++j) {
+            if (conflicts(m_entries[i].access, m_entries[j].access)) stage = std::max(stage, m_stats[j].stage + 1);
+        }
+        m_stats[i].stage = stage;
+        if (stage == m_stages.size()) m_stages.emplace_back();
+        m_stages[stage].push_back(i);
+    }
+    m_stagesDirty = false;
+}
+
+uint32_t SystemScheduler::advance(uint32_t elapsed_ms) {
+    if (!m_kernel->is_running()) return 0;
+    m_accumulatedMs += elapsed_ms;
+    uint32_t steps = 0;
+    while (m_accumulatedMs >= m_stepMs) {
+        m_accumulatedMs -= m_stepMs;
+        tick();
+        ++steps;
+    }
+    return steps;
+}
+
+void SystemScheduler::run_system(size_t index, uint64_t tick_seed) {
+    Entry& entry = m_entries[index];
+    StagedOverlays overlays(*m_overlays, entry.staged);
+    contracts::SystemContext context{m_stepMs, m_kernel->current_time_ms(),
+                                     mix(tick_seed ^ hash_name(m_stats[index].name)), m_store.get(), *entry.graph,
+                                     overlays};
+    auto start = std::chrono::steady_clock::now();
+    entry.system->update(context);
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    SystemStats& stats = m_stats[index];
+    stats.last_ms = ms;
+    stats.total_ms += ms;
+    ++stats.updates;
+}
+
+void SystemScheduler::tick() {
+    if (m_stagesDirty) build_stages();
+    m_kernel->step(m_stepMs);
+    uint64_t tickSeed = mix(m_kernel->seed() ^ mix(m_ticks++));
+
+    for (const auto& stage : m_stages) {
+        if (stage.size() == 1 || m_threads == 1) {
+            for (size_t index : stage) run_system(index, tickSeed);
+        } else {
+            if (!m_pool) m_pool = std::make_unique<analytics::WorkerPool>(m_threads);
+            for (size_t index : stage) {
+                m_pool->enqueue([this, index, tickSeed] { run_system(index, tickSeed); });
+            }
+            m_pool->waitAll();
+        }
+        merge_stage(stage);
+    }
+}
+
+void SystemScheduler::merge_stage(const std::vector<size_t>& stage) {
+    for (size_t index : stage) {
+        Entry& entry = m_entries[index];
+        for (const auto& spec : entry.staged) m_overlays->add_overlay(spec);
+        if (m_store && !entry.graph->nodes.empty()) m_store->add_nodes(entry.graph->nodes);
+        if (m_store && !entry.graph->edges.empty()) m_store->add_edges(entry.graph->edges);
+        entry.staged.clear();
+        entry.graph->nodes.clear();
+        entry.graph->edges.clear();
+    }
+}
+
+} // namespace brain_model::core
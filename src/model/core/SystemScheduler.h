@@ -0,0 +1,84 @@
+#pragma once
+
+#include "model/core/contracts/ISimulationKernel.h"
+#include "model/core/contracts/ISimulationSystem.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace analytics { class WorkerPool; }
+
+namespace brain_model::core {
+
+// Runs simulation systems on a fixed timestep. Systems are grouped into
+// stages in registration order: a system joins the first stage after every
+// earlier system it conflicts with (one writes what the other reads or
+// writes). Systems in a stage run concurrently. Their overlays are staged and
+// merged in registration order when the stage ends, and so are their store
+// writes. Each system gets a seed derived from the kernel seed, so a run is
+// reproducible for a given seed.
+class SystemScheduler {
+public:
+    static constexpr uint32_t kDefaultStepMs = 16;
+
+    struct SystemStats {
+        std::string name;
+        size_t stage = 0;
+        uint64_t updates = 0;
+        double last_ms = 0.0;
+        double total_ms = 0.0;
+    };
+
+    // `threads` == 0 uses the hardware concurrency.
+    SystemScheduler(std::shared_ptr<contracts::ISimulationKernel> kernel,
+                    std::shared_ptr<contracts::IOverlayService> overlays,
+                    std::shared_ptr<contracts::IModelGraphStore> store = nullptr,
+                    uint32_t step_ms = kDefaultStepMs, size_t threads = 0);
+    ~SystemScheduler();
+
+    void add_system(std::shared_ptr<contracts::ISimulationSystem> system);
+    void add_systems(const contracts::SystemRegistry& registry);
+
+    // Banks `elapsed_ms` and runs as many whole steps as it covers; the rest
+    // carries over. Nothing runs while the kernel is paused. Returns the steps run.
+    uint32_t advance(uint32_t elapsed_ms);
+    // Runs one step now, regardless of the accumulated time.
+    void tick();
+
+    uint32_t step_ms() const { return m_stepMs; }
+    uint32_t pending_ms() const { return m_accumulatedMs; }
+    size_t stage_count();
+    // Indexed like the registration order.
+    const std::vector<SystemStats>& stats() const { return m_stats; }
+
+private:
+    class StagedGraphWrites;
+
+    struct Entry {
+        std::shared_ptr<contracts::ISimulationSystem> system;
+        contracts::SystemAccess access;
+        std::vector<contracts::OverlaySpec> staged;
+        std::unique_ptr<StagedGraphWrites> graph;
+    };
+
+    void build_stages();
+    void run_system(size_t index, uint64_t tick_seed);
+    void merge_stage(const std::vector<size_t>& stage);
+
+    std::shared_ptr<contracts::ISimulationKernel> m_kernel;
+    std::shared_ptr<contracts::IOverlayService> m_overlays;
+    std::shared_ptr<contracts::IModelGraphStore> m_store;
+    uint32_t m_stepMs;
+    uint32_t m_accumulatedMs = 0;
+    uint64_t m_ticks = 0;
+    size_t m_threads;
+
+    std::vector<Entry> m_entries;
+    std::vector<SystemStats> m_stats;
+    std::vector<std::vector<size_t>> m_stages; // entry indices, ascending
+    bool m_stagesDirty = false;
+    std::unique_ptr<analytics::WorkerPool> m_pool; // created on the first parallel stage
+};
+
+} // namespace brain_model::core
@@ -1,18 +1,26 @@
 #pragma once
 
+#include "model/symbol.h"
+#include <array>
 #include <functional>
 #include <string>
 #include <vector>
 #include <memory>
-#include <any>
+#include <variant>
 #include <cstdint>
 
 namespace brain_model::core::contracts {
 
+// Event types are interned, so subscriber lookup is an integer hash.
+using EventType = model::Symbol;
+
+// Payloads are stored inline; none of the alternatives allocate.
+using EventPayload = std::variant<std::monostate, bool, int64_t, double, model::Symbol, std::array<float, 3>>;
+
 struct Event {
-    std::string type;
-    uint64_t timestamp_ms;
-    std::any payload;
+    EventType type;
+    uint64_t timestamp_ms = 0;
+    EventPayload payload;
 };
 
 using EventHandler = std::function<void(const Event&)>;
@@ -23,14 +31,19 @@ public:
 
     // Publish/Subscribe
     virtual void publish(const Event& event) = 0;
-    virtual void subscribe(const std::string& type, EventHandler handler) = 0;
+    virtual void subscribe(EventType type, EventHandler handler) = 0;
 
     // Deterministic Replay
     virtual void start_recording() = 0;
     virtual void stop_recording() = 0;
     virtual void replay(const std::vector<Event>& history) = 0;
-    
+
     virtual std::vector<Event> get_recorded_history() const = 0;
+
+    // Recording to a binary log on disk instead of memory, and streaming it
+    // back from the first event at or after `from_timestamp_ms`.
+    virtual bool start_recording_to(const std::string& path) = 0;
+    virtual bool replay_from(const std::string& path, uint64_t from_timestamp_ms) = 0;
 };
 
 } // namespace brain_model::core::contracts
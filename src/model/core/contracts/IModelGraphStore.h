@@ -26,6 +26,15 @@ struct GraphEdge {
     std::map<std::string, AttributeValue> attributes;
 };
 
+// Write half of the store, for callers whose writes are applied later.
+class IGraphWriter {
+public:
+    virtual ~IGraphWriter() = default;
+
+    virtual void add_node(const GraphNode& node) = 0;
+    virtual void add_edge(const GraphEdge& edge) = 0;
+};
+
 class IModelGraphStore {
 public:
     virtual ~IModelGraphStore() = default;
@@ -33,10 +42,22 @@ public:
     // Entity Management
     virtual void add_node(const GraphNode& node) = 0;
     virtual void add_edge(const GraphEdge& edge) = 0;
+    // Each batch is published as a single version.
+    virtual void add_nodes(const std::vector<GraphNode>& nodes) = 0;
+    virtual void add_edges(const std::vector<GraphEdge>& edges) = 0;
     
     // Query API
     virtual std::optional<GraphNode> get_node(const std::string& id) const = 0;
     virtual std::vector<GraphNode> find_nodes_by_domain(const std::string& domain) const = 0;
+    virtual std::vector<GraphNode> find_nodes_by_type(const std::string& type) const = 0;
+    virtual std::optional<GraphEdge> get_edge(const std::string& id) const = 0;
+    virtual std::vector<GraphEdge> get_out_edges(const std::string& node_id) const = 0;
+    virtual std::vector<GraphEdge> get_in_edges(const std::string& node_id) const = 0;
+
+    // Traversal along edge direction; an empty domain matches any node.
+    virtual std::vector<std::string> get_neighborhood(const std::string& node_id, uint32_t hops,
+                                                      const std::string& domain) const = 0;
+    virtual std::vector<std::string> find_shortest_path(const std::string& from, const std::string& to) const = 0;
     
     // Versioning
     virtual uint32_t current_version() const = 0;
@@ -22,6 +22,7 @@ public:
 
     // Spec Management
     virtual bool load_overlays_from_file(const std::string& path) = 0;
+    // Replaces the spec with the same id on the same anchor, if any.
     virtual void add_overlay(const OverlaySpec& spec) = 0;
     
     // Binding & Resolution
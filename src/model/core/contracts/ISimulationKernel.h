@@ -28,6 +28,7 @@ public:
     
     // Seeded RNG input for deterministic behavior
     virtual void set_seed(uint64_t seed) = 0;
+    virtual uint64_t seed() const = 0;
     
     virtual uint64_t current_time_ms() const = 0;
     virtual bool is_running() const = 0;
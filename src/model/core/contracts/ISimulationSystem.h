@@ -0,0 +1,52 @@
+#pragma once
+
+#include "model/core/contracts/IOverlayService.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace brain_model::core::contracts {
+
+class IModelGraphStore;
+class IGraphWriter;
+
+// Named resources a system touches, usually graph domains. Systems whose sets
+// do not conflict may run concurrently.
+struct SystemAccess {
+    std::vector<std::string> reads;
+    std::vector<std::string> writes;
+};
+
+struct SystemContext {
+    uint32_t delta_ms;
+    uint64_t time_ms;
+    uint64_t seed;            // derived from the kernel seed, the tick and the system name
+    // Read-only: the store as it was when the stage started; may be null.
+    const IModelGraphStore* store;
+    // Writes are staged and applied after the stage, one batch per system in
+    // registration order, so store versions do not depend on thread timing.
+    IGraphWriter& graph;
+    IOverlayService& overlays; // staged; merged in registration order after the stage
+};
+
+class ISimulationSystem {
+public:
+    virtual ~ISimulationSystem() = default;
+
+    virtual std::string name() const = 0;
+    virtual SystemAccess access() const = 0;
+    virtual void update(SystemContext& context) = 0;
+};
+
+// Collects the systems a domain plugin contributes.
+class SystemRegistry {
+public:
+    void add(std::shared_ptr<ISimulationSystem> system) { m_systems.push_back(std::move(system)); }
+    const std::vector<std::shared_ptr<ISimulationSystem>>& systems() const { return m_systems; }
+
+private:
+    std::vector<std::shared_ptr<ISimulationSystem>> m_systems;
+};
+
+} // namespace brain_model::core::contracts
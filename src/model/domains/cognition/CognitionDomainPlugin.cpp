@@ -1,12 +1,18 @@
 #include <cstdint>
+#include <memory>
 #include "model/core/contracts/IOverlayService.h"
+#include "model/core/contracts/ISimulationSystem.h"
 #include "model/domains/cognition/CognitionDomainPlugin.h"
 #include <iostream>
 
 namespace brain_model::domains::cognition {
 
-class CognitionSimulationSystem {
+class CognitionSimulationSystem : public ISimulationSystem {
 public:
+    std::string name() const override { return "Cognition"; }
+    SystemAccess access() const override { return {{}, {"Cognition"}}; }
+    void update(SystemContext& context) override { update(context.delta_ms, context.overlays); }
+
     void update(uint32_t delta_ms, IOverlayService& overlayService) {
         // Logic for "enhancement_7": Executive Control Pulse
         // Replicating: utils().drawPulse(ctx, w * 0.35, h * 0.35, '#4fd1c5', t('cog_label_exec_control'))
@@ -32,4 +38,8 @@ public:
     }
 };
 
+void CognitionDomainPlugin::register_systems(SystemRegistry& registry) {
+    registry.add(std::make_shared<CognitionSimulationSystem>());
+}
+
 } // namespace brain_model::domains::cognition
@@ -14,9 +14,7 @@ public:
         // Cognition-specific entity registration
     }
 
-    void register_systems(SystemRegistry& registry) override {
-        // Cognition-specific simulation system registration
-    }
+    void register_systems(SystemRegistry& registry) override;
 
     void register_controls(ControlRegistry& registry) override {
         // Cognition-specific user control registration
@@ -1,11 +1,17 @@
 #include <cstdint>
+#include <memory>
 #include "model/core/contracts/IOverlayService.h"
+#include "model/core/contracts/ISimulationSystem.h"
 #include "model/domains/dna/DNADomainPlugin.h"
 
 namespace brain_model::domains::dna {
 
-class DNASimulationSystem {
+class DNASimulationSystem : public ISimulationSystem {
 public:
+    std::string name() const override { return "DNA"; }
+    SystemAccess access() const override { return {{}, {"DNA"}}; }
+    void update(SystemContext& context) override { update(context.delta_ms, context.overlays); }
+
     void update(uint32_t delta_ms, IOverlayService& overlayService) {
         // DNA Repair Logic
         // Replicating: "Base Excision Repair (BER), Mismatch Repair (MMR), DSB repair"
@@ -29,4 +35,8 @@ public:
     }
 };
 
+void DNADomainPlugin::register_systems(SystemRegistry& registry) {
+    registry.add(std::make_shared<DNASimulationSystem>());
+}
+
 } // namespace brain_model::domains::dna
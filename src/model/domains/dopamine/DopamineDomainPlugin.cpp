@@ -1,11 +1,17 @@
 #include <cstdint>
+#include <memory>
 #include "model/core/contracts/IOverlayService.h"
+#include "model/core/contracts/ISimulationSystem.h"
 #include "model/domains/dopamine/DopamineDomainPlugin.h"
 
 namespace brain_model::domains::dopamine {
 
-class DopamineSimulationSystem {
+class DopamineSimulationSystem : public ISimulationSystem {
 public:
+    std::string name() const override { return "Dopamine"; }
+    SystemAccess access() const override { return {{}, {"Dopamine"}}; }
+    void update(SystemContext& context) override { update(context.delta_ms, context.overlays); }
+
     void update(uint32_t delta_ms, IOverlayService& overlayService) {
         // Dopamine Signaling Logic
         // Replicating: "Receptor subtypes, binding kinetics, motivational drive"
@@ -29,4 +35,8 @@ public:
     }
 };
 
+void DopamineDomainPlugin::register_systems(SystemRegistry& registry) {
+    registry.add(std::make_shared<DopamineSimulationSystem>());
+}
+
 } // namespace brain_model::domains::dopamine
@@ -1,5 +1,7 @@
 #include <cstdint>
+#include <memory>
 #include "model/core/contracts/IOverlayService.h"
+#include "model/core/contracts/ISimulationSystem.h"
 #include "model/domains/emotion/EmotionDomainPlugin.h"
 #include "model/core/contracts/IOverlayService.h"
 #include <cstdint>
@@ -9,8 +11,12 @@ namespace brain_model::domains::emotion {
 using namespace brain_model::core;
 using namespace brain_model::core::contracts;
 
-class EmotionSimulationSystem {
+class EmotionSimulationSystem : public ISimulationSystem {
 public:
+    std::string name() const override { return "Emotion"; }
+    SystemAccess access() const override { return {{}, {"Emotion"}}; }
+    void update(SystemContext& context) override { update(context.delta_ms, context.overlays); }
+
     void update(uint32_t delta_ms, IOverlayService& overlayService) {
         // Papez Circuit Simulation Logic
         // Replicating: "Limbic system, Papez circuit, hypothalamus, hippocampus"
@@ -35,4 +41,8 @@ public:
     }
 };
 
+void EmotionDomainPlugin::register_systems(SystemRegistry& registry) {
+    registry.add(std::make_shared<EmotionSimulationSystem>());
+}
+
 } // namespace brain_model::domains::emotion
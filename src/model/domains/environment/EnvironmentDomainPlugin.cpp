@@ -1,11 +1,17 @@
 #include <cstdint>
+#include <memory>
 #include "model/core/contracts/IOverlayService.h"
+#include "model/core/contracts/ISimulationSystem.h"
 #include "model/domains/environment/EnvironmentDomainPlugin.h"
 
 namespace brain_model::domains::environment {
 
-class EnvironmentSimulationSystem {
+class EnvironmentSimulationSystem : public ISimulationSystem {
 public:
+    std::string name() const override { return "Environment"; }
+    SystemAccess access() const override { return {{}, {"Environment"}}; }
+    void update(SystemContext& context) override { update(context.delta_ms, context.overlays); }
+
     void update(uint32_t delta_ms, IOverlayService& overlayService) {
         // Environment Logic
         // Replicating: "Stressor exposure, social support, resilience factors"
@@ -29,4 +35,8 @@ public:
     }
 };
 
+void EnvironmentDomainPlugin::register_systems(SystemRegistry& registry) {
+    registry.add(std::make_shared<EnvironmentSimulationSystem>());
+}
+
 } // namespace brain_model::domains::environment
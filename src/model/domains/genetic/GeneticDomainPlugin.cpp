@@ -1,11 +1,17 @@
 #include <cstdint>
+#include <memory>
 #include "model/core/contracts/IOverlayService.h"
+#include "model/core/contracts/ISimulationSystem.h"
 #include "model/domains/genetic/GeneticDomainPlugin.h"
 
 namespace brain_model::domains::genetic {
 
-class GeneticSimulationSystem {
+class GeneticSimulationSystem : public ISimulationSystem {
 public:
+    std::string name() const override { return "Genetic"; }
+    SystemAccess access() const override { return {{}, {"Genetic"}}; }
+    void update(SystemContext& context) override { update(context.delta_ms, context.overlays); }
+
     void update(uint32_t delta_ms, IOverlayService& overlayService) {
         // Genetic Foundation Logic
         // Replicating: "Probabilistic traits, sensitivity, stress reactivity"
@@ -29,4 +35,8 @@ public:
     }
 };
 
+void GeneticDomainPlugin::register_systems(SystemRegistry& registry) {
+    registry.add(std::make_shared<GeneticSimulationSystem>());
+}
+
 } // namespace brain_model::domains::genetic
@@ -1,11 +1,17 @@
 #include <cstdint>
+#include <memory>
 #include "model/core/contracts/IOverlayService.h"
+#include "model/core/contracts/ISimulationSystem.h"
 #include "model/domains/inflammation/InflammationDomainPlugin.h"
 
 namespace brain_model::domains::inflammation {
 
-class InflammationSimulationSystem {
+class InflammationSimulationSystem : public ISimulationSystem {
 public:
+    std::string name() const override { return "Inflammation"; }
+    SystemAccess access() const override { return {{}, {"Inflammation"}}; }
+    void update(SystemContext& context) override { update(context.delta_ms, context.overlays); }
+
     void update(uint32_t delta_ms, IOverlayService& overlayService) {
         // Neuroinflammation Logic
         // Replicating: "Glial activation, cytokine tone, BBB permeability"
@@ -29,4 +35,8 @@ public:
     }
 };
 
+void InflammationDomainPlugin::register_systems(SystemRegistry& registry) {
+    registry.add(std::make_shared<InflammationSimulationSystem>());
+}
+
 } // namespace brain_model::domains::inflammation
@@ -1,11 +1,17 @@
 #include <cstdint>
+#include <memory>
 #include "model/core/contracts/IOverlayService.h"
+#include "model/core/contracts/ISimulationSystem.h"
 #include "model/domains/neuro/NeuroDomainPlugin.h"
 
 namespace brain_model::domains::neuro {
 
-class NeuroSimulationSystem {
+class NeuroSimulationSystem : public ISimulationSystem {
 public:
+    std::string name() const override { return "Neuro"; }
+    SystemAccess access() const override { return {{}, {"Neuro"}}; }
+    void update(SystemContext& context) override { update(context.delta_ms, context.overlays); }
+
     void update(uint32_t delta_ms, IOverlayService& overlayService) {
         // Network Dynamics Simulation
         // Regions as nodes in a graph
@@ -30,4 +36,8 @@ public:
     }
 };
 
+void NeuroDomainPlugin::register_systems(SystemRegistry& registry) {
+    registry.add(std::make_shared<NeuroSimulationSystem>());
+}
+
 } // namespace brain_model::domains::neuro
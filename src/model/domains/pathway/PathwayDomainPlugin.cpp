@@ -1,11 +1,17 @@
 #include <cstdint>
+#include <memory>
 #include "model/core/contracts/IOverlayService.h"
+#include "model/core/contracts/ISimulationSystem.h"
 #include "model/domains/pathway/PathwayDomainPlugin.h"
 
 namespace brain_model::domains::pathway {
 
-class PathwaySimulationSystem {
+class PathwaySimulationSystem : public ISimulationSystem {
 public:
+    std::string name() const override { return "Pathway"; }
+    SystemAccess access() const override { return {{}, {"Pathway"}}; }
+    void update(SystemContext& context) override { update(context.delta_ms, context.overlays); }
+
     void update(uint32_t delta_ms, IOverlayService& overlayService) {
         // Pathway Loop Logic
         // Replicating: "Habit loops, behavioral reinforcement, path rigidity"
@@ -29,4 +35,8 @@ public:
     }
 };
 
+void PathwayDomainPlugin::register_systems(SystemRegistry& registry) {
+    registry.add(std::make_shared<PathwaySimulationSystem>());
+}
+
 } // namespace brain_model::domains::pathway
@@ -1,11 +1,17 @@
 #include <cstdint>
+#include <memory>
 #include "model/core/contracts/IOverlayService.h"
+#include "model/core/contracts/ISimulationSystem.h"
 #include "model/domains/rna/RNADomainPlugin.h"
 
 namespace brain_model::domains::rna {
 
-class RNASimulationSystem {
+class RNASimulationSystem : public ISimulationSystem {
 public:
+    std::string name() const override { return "RNA"; }
+    SystemAccess access() const override { return {{}, {"RNA"}}; }
+    void update(SystemContext& context) override { update(context.delta_ms, context.overlays); }
+
     void update(uint32_t delta_ms, IOverlayService& overlayService) {
         // RNA Repair Logic
         // Replicating: "AlkB enzymes, fidelity of protein synthesis, RNA ligation"
@@ -29,4 +35,8 @@ public:
     }
 };
 
+void RNADomainPlugin::register_systems(SystemRegistry& registry) {
+    registry.add(std::make_shared<RNASimulationSystem>());
+}
+
 } // namespace brain_model::domains::rna
@@ -1,11 +1,17 @@
 #include <cstdint>
+#include <memory>
 #include "model/core/contracts/IOverlayService.h"
+#include "model/core/contracts/ISimulationSystem.h"
 #include "model/domains/serotonin/SerotoninDomainPlugin.h"
 
 namespace brain_model::domains::serotonin {
 
-class SerotoninSimulationSystem {
+class SerotoninSimulationSystem : public ISimulationSystem {
 public:
+    std::string name() const override { return "Serotonin"; }
+    SystemAccess access() const override { return {{}, {"Serotonin"}}; }
+    void update(SystemContext& context) override { update(context.delta_ms, context.overlays); }
+
     void update(uint32_t delta_ms, IOverlayService& overlayService) {
         // Serotonin Structural Logic
         // Replicating: "5-HT1A receptor, resilience, emotional equilibrium"
@@ -29,4 +35,8 @@ public:
     }
 };
 
+void SerotoninDomainPlugin::register_systems(SystemRegistry& registry) {
+    registry.add(std::make_shared<SerotoninSimulationSystem>());
+}
+
 } // namespace brain_model::domains::serotonin
@@ -1,11 +1,17 @@
 #include <cstdint>
+#include <memory>
 #include "model/core/contracts/IOverlayService.h"
+#include "model/core/contracts/ISimulationSystem.h"
 #include "model/domains/stress/StressDomainPlugin.h"
 
 namespace brain_model::domains::stress {
 
-class StressSimulationSystem {
+class StressSimulationSystem : public ISimulationSystem {
 public:
+    std::string name() const override { return "Stress"; }
+    SystemAccess access() const override { return {{}, {"Stress"}}; }
+    void update(SystemContext& context) override { update(context.delta_ms, context.overlays); }
+
     void update(uint32_t delta_ms, IOverlayService& overlayService) {
         // Allostatic Load Tracking
         // Replicating: "HPA-axis load, allostatic load, resilience reserve"
@@ -29,4 +35,8 @@ public:
     }
 };
 
+void StressDomainPlugin::register_systems(SystemRegistry& registry) {
+    registry.add(std::make_shared<StressSimulationSystem>());
+}
+
 } // namespace brain_model::domains::stress
@@ -1,11 +1,17 @@
 #include <cstdint>
+#include <memory>
 #include "model/core/contracts/IOverlayService.h"
+#include "model/core/contracts/ISimulationSystem.h"
 #include "model/domains/synapse/SynapseDomainPlugin.h"
 
 namespace brain_model::domains::synapse {
 
-class SynapseSimulationSystem {
+class SynapseSimulationSystem : public ISimulationSystem {
 public:
+    std::string name() const override { return "Synapse"; }
+    SystemAccess access() const override { return {{}, {"Synapse"}}; }
+    void update(SystemContext& context) override { update(context.delta_ms, context.overlays); }
+
     void update(uint32_t delta_ms, IOverlayService& overlayService) {
         // Synapse Simulation Logic
         // Replicating: "Signal weighting, amplification, dampening"
@@ -29,4 +35,8 @@ public:
     }
 };
 
+void SynapseDomainPlugin::register_systems(SystemRegistry& registry) {
+    registry.add(std::make_shared<SynapseSimulationSystem>());
+}
+
 } // namespace brain_model::domains::synapse
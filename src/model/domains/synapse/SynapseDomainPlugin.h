@@ -10,7 +10,7 @@ class SynapseDomainPlugin : public IModelDomainPlugin {
 public:
     std::string name() const override { return "Synapse"; }
     void register_entities(GraphRegistry&) override {}
-    void register_systems(SystemRegistry&) override {}
+    void register_systems(SystemRegistry& registry) override;
     void register_controls(ControlRegistry&) override {}
     void register_analytics(AnalyticsRegistry&) override {}
     void register_overlay_anchors(OverlayAnchorRegistry&) override {}
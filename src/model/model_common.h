@@ -1,6 +1,7 @@
 #ifndef MODEL_COMMON_H
 #define MODEL_COMMON_H
 
+#include "symbol.h"
 #include <string>
 #include <vector>
 #include <set>
@@ -15,8 +16,8 @@ struct Vec3 {
     }
 };
 
-using RegionID = std::string;
-using PathwayID = std::string;
+using RegionID = Symbol;
+using PathwayID = Symbol;
 
 enum class Hemisphere {
     Left,
@@ -1,10 +1,17 @@
 #include "model_repository.h"
+#include "atlas_cache.h"
 #include "../logger.h"
+#include "../io/mapped_file.h"
+#include "../analytics/worker_pool.h"
 #include <fstream>
 #include <sstream>
 #include <iostream>
 #include <vector>
 #include <algorithm>
+#include <charconv>
+#include <iterator>
+#include <string_view>
+#include <thread>
 
 namespace model {
 
@@ -18,76 +25,217 @@ static std::vector<std::string> split(const std::string& s, char delimiter) {
     return tokens;
 }
 
-ModelRepository::ModelRepository() {
-    topology_ = createBrainTextTopology();
-    indexer_ = createTopologyIndexer();
+// Below this size a single thread parses the whole atlas.
+static constexpr size_t kMinAtlasChunkBytes = 1 << 20;
+static constexpr size_t kMaxAtlasFields = 16;
+
+// Same semantics as the getline-based split: a trailing empty field is dropped.
+static size_t splitFields(std::string_view line, std::string_view* fields) {
+    size_t count = 0;
+    size_t start = 0;
+    while (start < line.size() && count < kMaxAtlasFields) {
+        size_t comma = line.find(',', start);
+        if (comma == std::string_view::npos) {
+            fields[count++] = line.substr(start);
+            break;
+        }
+        fields[count++] = line.substr(start, comma - start);
+        start = comma + 1;
+    }
+    return count;
 }
 
-BrainTextTopology& ModelRepository::getTopology() { return *topology_; }
-TopologyIndexer& ModelRepository::getIndexer() { return *indexer_; }
+static std::string_view trimNumber(std::string_view s) {
+    while (!s.empty() && (s.front() == ' ' || s.front() == '\t')) s.remove_prefix(1);
+    if (!s.empty() && s.front() == '+') s.remove_prefix(1);
+    return s;
+}
 
-bool ModelRepository::loadAtlas(const std::string& filepath) {
-    std::ifstream file(filepath);
-    if (!file.is_open()) {
-        Logger::error("Failed to open atlas file: " + filepath);
-        return false;
-    }
+static bool parseFloat(std::string_view s, float& out) {
+    s = trimNumber(s);
+    auto res = std::from_chars(s.data(), s.data() + s.size(), out);
+    return res.ec == std::errc() && res.ptr != s.data();
+}
 
-    currentAtlasPath_ = filepath;
-    model_.clear();
+static bool parseInt(std::string_view s, int& out) {
+    s = trimNumber(s);
+    auto res = std::from_chars(s.data(), s.data() + s.size(), out);
+    return res.ec == std::errc() && res.ptr != s.data();
+}
 
-    std::string line;
-    int lineNum = 0;
-    while (std::getline(file, line)) {
-        lineNum++;
+// Warnings carry a chunk-local line number; the merge step rebases it.
+struct AtlasWarning {
+    int line;
+    const char* prefix;
+    const char* suffix;
+};
+
+struct AtlasChunk {
+    std::vector<BrainRegion> regions;
+    std::vector<BrainPathway> pathways;
+    std::vector<AtlasWarning> warnings;
+    int lineCount = 0;
+};
+
+static void parseAtlasChunk(std::string_view text, AtlasChunk& out) {
+    std::string_view tokens[kMaxAtlasFields];
+    size_t pos = 0;
+    while (pos < text.size()) {
+        size_t nl = text.find('\n', pos);
+        std::string_view line = text.substr(pos, (nl == std::string_view::npos ? text.size() : nl) - pos);
+        pos = (nl == std::string_view::npos) ? text.size() : nl + 1;
+        int lineNum = ++out.lineCount;
+
+        if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
         if (line.empty() || line[0] == '#') continue;
-        auto tokens = split(line, ',');
-        if (tokens.empty()) continue;
+        size_t count = splitFields(line, tokens);
+        if (count == 0) continue;
 
         if (tokens[0] == "REGION") {
-            if (tokens.size() < 7) {
-                Logger::warn("Malformed REGION at line " + std::to_string(lineNum) + ": insufficient fields.");
+            if (count < 7) {
+                out.warnings.push_back({lineNum, "Malformed REGION at line ", ": insufficient fields."});
                 continue;
             }
 
-            try {
-                BrainRegion region;
-                region.id = tokens[1];
-                region.name = tokens[2];
-                region.center = { std::stof(tokens[3]), std::stof(tokens[4]), std::stof(tokens[5]) };
-                region.radius = std::stof(tokens[6]);
-
-                if (tokens.size() > 7) region.regionCode = tokens[7];
-                if (tokens.size() > 8) region.hemisphere = static_cast<Hemisphere>(std::stoi(tokens[8]));
-                if (tokens.size() > 9) region.lobe = static_cast<Lobe>(std::stoi(tokens[9]));
-                if (tokens.size() > 10) region.parentId = tokens[10];
-
-                model_.addRegion(region);
-            } catch (const std::exception& e) {
-                Logger::warn("Error parsing REGION at line " + std::to_string(lineNum) + ": " + std::string(e.what()));
+            BrainRegion region;
+            region.id = std::string(tokens[1]);
+            region.name = std::string(tokens[2]);
+            int hemisphere = 0, lobe = 0;
+            bool ok = parseFloat(tokens[3], region.center.x) && parseFloat(tokens[4], region.center.y) &&
+                      parseFloat(tokens[5], region.center.z) && parseFloat(tokens[6], region.radius);
+            if (ok && count > 7) region.regionCode = std::string(tokens[7]);
+            if (ok && count > 8) {
+                ok = parseInt(tokens[8], hemisphere);
+                region.hemisphere = static_cast<Hemisphere>(hemisphere);
+            }
+            if (ok && count > 9) {
+                ok = parseInt(tokens[9], lobe);
+                region.lobe = static_cast<Lobe>(lobe);
+            }
+            if (ok && count > 10) region.parentId = std::string(tokens[10]);
+
+            if (!ok) {
+                out.warnings.push_back({lineNum, "Error parsing REGION at line ", ": invalid numeric field"});
+                continue;
             }
+            out.regions.push_back(std::move(region));
         } else if (tokens[0] == "PATHWAY") {
-            if (tokens.size() < 5) {
-                Logger::warn("Malformed PATHWAY at line " + std::to_string(lineNum) + ": insufficient fields.");
+            if (count < 5) {
+                out.warnings.push_back({lineNum, "Malformed PATHWAY at line ", ": insufficient fields."});
                 continue;
             }
 
-            try {
-                BrainPathway pathway;
-                pathway.id = tokens[1];
-                pathway.name = tokens[2];
-                pathway.sourceRegion = tokens[3];
-                pathway.targetRegion = tokens[4];
-
-                if (tokens.size() > 5) pathway.direction = static_cast<PathwayDirection>(std::stoi(tokens[5]));
-                if (tokens.size() > 6) pathway.strength = std::stof(tokens[6]);
-                if (tokens.size() > 7) pathway.type = static_cast<PathwayType>(std::stoi(tokens[7]));
+            BrainPathway pathway;
+            pathway.id = std::string(tokens[1]);
+            pathway.name = std::string(tokens[2]);
+            pathway.sourceRegion = std::string(tokens[3]);
+            pathway.targetRegion = std::string(tokens[4]);
+
+            bool ok = true;
+            int direction = 0, type = 0;
+            if (count > 5) {
+                ok = parseInt(tokens[5], direction);
+                pathway.direction = static_cast<PathwayDirection>(direction);
+            }
+            if (ok && count > 6) ok = parseFloat(tokens[6], pathway.strength);
+            if (ok && count > 7) {
+                ok = parseInt(tokens[7], type);
+                pathway.type = static_cast<PathwayType>(type);
+            }
 
-                model_.addPathway(pathway);
-            } catch (const std::exception& e) {
-                Logger::warn("Error parsing PATHWAY at line " + std::to_string(lineNum) + ": " + std::string(e.what()));
+            if (!ok) {
+                out.warnings.push_back({lineNum, "Error parsing PATHWAY at line ", ": invalid numeric field"});
+                continue;
             }
+            out.pathways.push_back(std::move(pathway));
+        }
+    }
+}
+
+// Parses every REGION/PATHWAY record in file order, logging malformed lines.
+static void parseAtlasRecords(std::string_view text, std::vector<BrainRegion>& regions,
+                              std::vector<BrainPathway>& pathways) {
+    // Split the mapped file at line boundaries into roughly equal chunks.
+    size_t threads = std::max(1u, std::thread::hardware_concurrency());
+    size_t chunkCount = std::max<size_t>(1, std::min(threads, text.size() / kMinAtlasChunkBytes));
+    std::vector<std::string_view> chunkText;
+    size_t start = 0;
+    for (size_t c = 1; c <= chunkCount && start < text.size(); ++c) {
+        size_t end = (c == chunkCount) ? text.size() : text.size() * c / chunkCount;
+        if (end < start) end = start;
+        if (end < text.size()) {
+            size_t nl = text.find('\n', end);
+            end = (nl == std::string_view::npos) ? text.size() : nl + 1;
+        }
+        chunkText.push_back(text.substr(start, end - start));
+        start = end;
+    }
+
+    std::vector<AtlasChunk> chunks(chunkText.size());
+    if (chunks.size() == 1) {
+        parseAtlasChunk(chunkText[0], chunks[0]);
+    } else {
+        analytics::WorkerPool pool(chunks.size());
+        for (size_t i = 0; i < chunks.size(); ++i) {
+            pool.enqueue([&chunkText, &chunks, i]() { parseAtlasChunk(chunkText[i], chunks[i]); });
+        }
+        pool.waitAll();
+    }
+
+    // Merge in file order so duplicate ids resolve exactly as a serial read would.
+    size_t regionTotal = 0, pathwayTotal = 0;
+    for (const auto& chunk : chunks) {
+        regionTotal += chunk.regions.size();
+        pathwayTotal += chunk.pathways.size();
+    }
+    regions.reserve(regionTotal);
+    pathways.reserve(pathwayTotal);
+
+    int lineBase = 0;
+    for (auto& chunk : chunks) {
+        for (const auto& w : chunk.warnings) {
+            Logger::warn(w.prefix + std::to_string(lineBase + w.line) + w.suffix);
         }
+        lineBase += chunk.lineCount;
+        std::move(chunk.regions.begin(), chunk.regions.end(), std::back_inserter(regions));
+        std::move(chunk.pathways.begin(), chunk.pathways.end(), std::back_inserter(pathways));
+    }
+}
+
+ModelRepository::ModelRepository() {
+    topology_ = createBrainTextTopology();
+    indexer_ = createTopologyIndexer();
+}
+
+BrainTextTopology& ModelRepository::getTopology() { return *topology_; }
+TopologyIndexer& ModelRepository::getIndexer() { return *indexer_; }
+
+bool ModelRepository::loadAtlas(const std::string& filepath) {
+    io::MappedFile file(filepath);
+    if (!file.isOpen()) {
+        Logger::error("Failed to open atlas file: " + filepath);
+        return false;
+    }
+
+    currentAtlasPath_ = filepath;
+    model_.clear();
+
+    uint64_t sourceHash = AtlasCache::hashSource(file.view());
+    std::string cachePath = AtlasCache::cachePathFor(filepath);
+    if (atlasCacheEnabled_ && AtlasCache::read(cachePath, sourceHash, file.size(), model_)) {
+        indexer_->buildIndex(model_);
+        Logger::info("Atlas loaded from cache: " + cachePath);
+        return true;
+    }
+
+    std::vector<BrainRegion> regions;
+    std::vector<BrainPathway> pathways;
+    parseAtlasRecords(file.view(), regions, pathways);
+    model_.addRegions(std::move(regions));
+    model_.addPathways(std::move(pathways));
+
+    if (atlasCacheEnabled_ && !AtlasCache::write(cachePath, model_, sourceHash, file.size())) {
+        Logger::warn("Could not write atlas cache: " + cachePath);
     }
 
     indexer_->buildIndex(model_);
@@ -98,7 +246,42 @@ bool ModelRepository::loadAtlas(const std::string& filepath) {
 bool ModelRepository::reloadAtlas() {
     if (currentAtlasPath_.empty()) return false;
     Logger::info("Reloading atlas from: " + currentAtlasPath_);
-    return loadAtlas(currentAtlasPath_);
+
+    io::MappedFile file(currentAtlasPath_);
+    if (!file.isOpen()) {
+        Logger::error("Failed to open atlas file: " + currentAtlasPath_);
+        return false;
+    }
+
+    std::vector<BrainRegion> regions;
+    std::vector<BrainPathway> pathways;
+    parseAtlasRecords(file.view(), regions, pathways);
+
+    AtlasChangeSet changes = model_.applyAtlasDiff(std::move(regions), std::move(pathways));
+    if (changes.empty()) {
+        Logger::info("Atlas unchanged: " + currentAtlasPath_);
+        return true;
+    }
+
+    indexer_->updateIndex(model_, changes);
+    for (const auto& listener : atlasListeners_) listener(changes);
+
+    std::string cachePath = AtlasCache::cachePathFor(currentAtlasPath_);
+    if (atlasCacheEnabled_ &&
+        !AtlasCache::write(cachePath, model_, AtlasCache::hashSource(file.view()), file.size())) {
+        Logger::warn("Could not write atlas cache: " + cachePath);
+    }
+
+    Logger::info("Atlas reloaded: " + std::to_string(changes.addedRegions.size()) + " regions added, " +
+                 std::to_string(changes.modifiedRegions.size()) + " modified, " +
+                 std::to_string(changes.removedRegions.size()) + " removed; " +
+                 std::to_string(changes.addedPathways.size() + changes.modifiedPathways.size() +
+                                changes.removedPathways.size()) + " pathway changes.");
+    return true;
+}
+
+void ModelRepository::addAtlasChangeListener(AtlasChangeListener listener) {
+    atlasListeners_.push_back(std::move(listener));
 }
 
 bool ModelRepository::exportToJSON(const std::string& filepath) {
@@ -5,9 +5,10 @@
 #include "brain_label.h"
 #include "brain_overlay.h"
 #include "brain_text_topology.h"
-#include "brain_text_topology.h"
+#include <functional>
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace model {
 
@@ -20,8 +21,16 @@ public:
 
     // Load and reload (Requirement 10)
     bool loadAtlas(const std::string& filepath);
+    // Diffs the file against the loaded model and applies only what changed.
     bool reloadAtlas();
 
+    // Binary cache beside the atlas (<atlas>.cache); on by default.
+    void setAtlasCacheEnabled(bool enabled) { atlasCacheEnabled_ = enabled; }
+
+    // Notified after each reload that changed the model.
+    using AtlasChangeListener = std::function<void(const AtlasChangeSet&)>;
+    void addAtlasChangeListener(AtlasChangeListener listener);
+
     bool loadLabels(const std::string& filepath);
     bool loadOverlay(const std::string& filepath);
 
@@ -67,6 +76,8 @@ private:
 
     std::unique_ptr<BrainTextTopology> topology_;
     std::unique_ptr<TopologyIndexer> indexer_;
+    std::vector<AtlasChangeListener> atlasListeners_;
+    bool atlasCacheEnabled_ = true;
 };
 
 
@@ -0,0 +1,140 @@
+#include "pathway_tessellator.h"
+#include <algorithm>
+#include <cmath>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace model {
+
+namespace {
+
+// Cubic coefficients of every link in the batch, one array per term and axis:
+// p(t) = a + b t + c t^2 + d t^3.
+struct LinkBatch {
+    std::vector<float> a[3], b[3], c[3], d[3];
+    std::vector<uint32_t> segments;
+    std::vector<uint32_t> firstPoint; // into the owning pathway's arrays
+    std::vector<TessellatedPathway*> owner;
+
+    void add(const Vec3& p0, const Vec3& p1, const Vec3& p2, const Vec3& p3) {
+        const float q0[3] = {p0.x, p0.y, p0.z}, q1[3] = {p1.x, p1.y, p1.z};
+        const float q2[3] = {p2.x, p2.y, p2.z}, q3[3] = {p3.x, p3.y, p3.z};
+        for (int k = 0; k < 3; ++k) {
+            a[k].push_back(q1[k]);
+            b[k].push_back(0.5f * (q2[k] - q0[k]));
+            c[k].push_back(0.5f * (2.0f * q0[k] - 5.0f * q1[k] + 4.0f * q2[k] - q3[k]));
+            d[k].push_back(0.5f * (-q0[k] + 3.0f * q1[k] - 3.0f * q2[k] + q3[k]));
+        }
+    }
+
+    size_t size() const { return a[0].size(); }
+};
+
+// Writes p(j / segments) for j in [0, segments).
+void evaluateAxis(float a, float b, float c, float d, uint32_t segments, float* out) {
+    float inv = 1.0f / segments;
+    uint32_t j = 0;
+#if defined(__SSE2__)
+    const __m128 va = _mm_set1_ps(a), vb = _mm_set1_ps(b), vc = _mm_set1_ps(c), vd = _mm_set1_ps(d);
+    const __m128 vinv = _mm_set1_ps(inv);
+    const __m128 lane = _mm_set_ps(3.0f, 2.0f, 1.0f, 0.0f);
+    for (; j + 4 <= segments; j += 4) {
+        __m128 t = _mm_mul_ps(_mm_add_ps(_mm_set1_ps(static_cast<float>(j)), lane), vinv);
+        __m128 r = _mm_add_ps(_mm_mul_ps(vd, t), vc);
+        r = _mm_add_ps(_mm_mul_ps(r, t), vb);
+        r = _mm_add_ps(_mm_mul_ps(r, t), va);
+        _mm_storeu_ps(out + j, r);
+    }
+#endif
+    for (; j < segments; ++j) {
+        float t = static_cast<float>(j) * inv;
+        out[j] = ((d * t + c) * t + b) * t + a;
+    }
+}
+
+} // namespace
+
+PathwayTessellator::PathwayTessellator(float tolerance, int maxSegmentsPerLink)
+    : tolerance_(std::max(tolerance, 1e-3f)), maxSegmentsPerLink_(std::max(maxSegmentsPerLink, 1)) {}
+
+int PathwayTessellator::lodFor(float pixelsPerUnit) {
+    if (!(pixelsPerUnit > 0.0f)) return INT32_MIN;
+    return static_cast<int>(std::ceil(std::log2(pixelsPerUnit) * 4.0f));
+}
+
+float PathwayTessellator::pixelsPerUnitFor(int lod) {
+    return lod == INT32_MIN ? 0.0f : std::exp2(lod / 4.0f);
+}
+
+const TessellatedPathway* PathwayTessellator::get(const PathwayID& id) const {
+    auto it = cache_.find(id);
+    return it == cache_.end() ? nullptr : &it->second;
+}
+
+size_t PathwayTessellator::tessellate(const BrainModel& model, float pixelsPerUnit) {
+    const auto& pathways = model.getPathways();
+    for (auto it = cache_.begin(); it != cache_.end();) {
+        it = pathways.count(it->first) ? std::next(it) : cache_.erase(it);
+    }
+
+    int lod = lodFor(pixelsPerUnit);
+    float scale = pixelsPerUnitFor(lod);
+    LinkBatch batch;
+    size_t rebuilt = 0;
+
+    for (const auto& [id, pathway] : pathways) {
+        TessellatedPathway& out = cache_[id];
+        if (out.revision == pathway.revision && out.lod == lod) continue;
+        out.revision = pathway.revision;
+        out.lod = lod;
+        ++rebuilt;
+
+        const auto& cp = pathway.controlPoints;
+        size_t n = cp.size();
+        size_t points = 0;
+        if (n >= 2) {
+            for (size_t i = 0; i + 1 < n; ++i) {
+                batch.add(i == 0 ? cp[i] : cp[i - 1], cp[i], cp[i + 1], i + 2 == n ? cp[i + 1] : cp[i + 2]);
+                // Chord error of n uniform steps is at most max|p''| / (8 n^2).
+                size_t k = batch.size() - 1;
+                float curvature = 0.0f;
+                for (float t : {0.0f, 1.0f}) {
+                    float sq = 0.0f;
+                    for (int axis = 0; axis < 3; ++axis) {
+                        float second = 2.0f * batch.c[axis][k] + 6.0f * batch.d[axis][k] * t;
+                        sq += second * second;
+                    }
+                    curvature = std::max(curvature, std::sqrt(sq));
+                }
+                float needed = std::ceil(std::sqrt(curvature * scale / (8.0f * tolerance_)));
+                uint32_t segments = static_cast<uint32_t>(std::clamp(needed, 1.0f, static_cast<float>(maxSegmentsPerLink_)));
+                batch.segments.push_back(segments);
+                batch.firstPoint.push_back(static_cast<uint32_t>(points));
+                batch.owner.push_back(&out);
+                points += segments;
+            }
+        }
+        points += n > 0 ? 1 : 0;
+        out.x.resize(points);
+        out.y.resize(points);
+        out.z.resize(points);
+        if (n > 0) {
+            out.x.back() = cp.back().x;
+            out.y.back() = cp.back().y;
+            out.z.back() = cp.back().z;
+        }
+    }
+
+    for (size_t k = 0; k < batch.size(); ++k) {
+        TessellatedPathway& out = *batch.owner[k];
+        float* dst[3] = {out.x.data(), out.y.data(), out.z.data()};
+        for (int axis = 0; axis < 3; ++axis) {
+            evaluateAxis(batch.a[axis][k], batch.b[axis][k], batch.c[axis][k], batch.d[axis][k],
+                         batch.segments[k], dst[axis] + batch.firstPoint[k]);
+        }
+    }
+    return rebuilt;
+}
+
+} // namespace model
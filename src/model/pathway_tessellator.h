@@ -0,0 +1,47 @@
+#ifndef PATHWAY_TESSELLATOR_H
+#define PATHWAY_TESSELLATOR_H
+
+#include "brain_model.h"
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace model {
+
+// Polyline of one pathway, stored as separate coordinate arrays.
+struct TessellatedPathway {
+    std::vector<float> x, y, z;
+    uint64_t revision = 0;
+    int lod = 0;
+
+    size_t size() const { return x.size(); }
+};
+
+// Batch Catmull-Rom tessellation for every pathway of a model. Each link gets
+// just enough segments that the polyline stays within `tolerance` screen cells
+// of the curve at the given zoom. Results are cached per pathway and reused
+// while its revision and LOD bucket are unchanged.
+class PathwayTessellator {
+public:
+    explicit PathwayTessellator(float tolerance = 0.5f, int maxSegmentsPerLink = 32);
+
+    // Re-tessellates stale pathways only; returns how many were rebuilt.
+    size_t tessellate(const BrainModel& model, float pixelsPerUnit);
+    const TessellatedPathway* get(const PathwayID& id) const;
+    size_t size() const { return cache_.size(); }
+    void clear() { cache_.clear(); }
+
+    // Quarter-octave zoom buckets; tessellating at a bucket's upper edge keeps
+    // the error bound for every zoom inside it.
+    static int lodFor(float pixelsPerUnit);
+    static float pixelsPerUnitFor(int lod);
+
+private:
+    float tolerance_;
+    int maxSegmentsPerLink_;
+    std::unordered_map<PathwayID, TessellatedPathway> cache_;
+};
+
+} // namespace model
+
+#endif // PATHWAY_TESSELLATOR_H
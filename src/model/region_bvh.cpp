@@ -0,0 +1,207 @@
+#include "region_bvh.h"
+#include "brain_model.h"
+#include <algorithm>
+#include <cmath>
+
+namespace model {
+
+namespace {
+
+// Facets are found by testing every vertex triple, so larger hulls fall back
+// to their bounding sphere rather than stall the build.
+constexpr size_t kMaxHullPoints = 32;
+
+float extentOf(const std::vector<Vec3>& points) {
+    float extent = 0.0f;
+    for (const auto& p : points) {
+        extent = std::max({extent, std::fabs(p.x), std::fabs(p.y), std::fabs(p.z)});
+    }
+    return extent;
+}
+
+} // namespace
+
+bool computeHullPlanes(const std::vector<Vec3>& points, std::vector<HullPlane>& planes) {
+    size_t n = points.size();
+    if (n < 4 || n > kMaxHullPoints) return false;
+    float eps = 1e-5f * (extentOf(points) + 1.0f);
+    size_t start = planes.size();
+
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = i + 1; j < n; ++j) {
+            for (size_t k = j + 1; k < n; ++k) {
+                const Vec3& a = points[i];
+                const Vec3& b = points[j];
+                const Vec3& c = points[k];
+                float ux = b.x - a.x, uy = b.y - a.y, uz = b.z - a.z;
+                float vx = c.x - a.x, vy = c.y - a.y, vz = c.z - a.z;
+                float nx = uy * vz - uz * vy, ny = uz * vx - ux * vz, nz = ux * vy - uy * vx;
+                float len = std::sqrt(nx * nx + ny * ny + nz * nz);
+                if (len <= eps * eps) continue; // collinear
+                nx /= len; ny /= len; nz /= len;
+                float d = nx * a.x + ny * a.y + nz * a.z;
+
+                bool below = true, above = true;
+                for (const auto& p : points) {
+                    float s = nx * p.x + ny * p.y + nz * p.z - d;
+                    if (s > eps) below = false;
+                    if (s < -eps) above = false;
+                    if (!below && !above) break;
+                }
+                if (below && above) {
+                    planes.resize(start); // every point on one plane: no volume
+                    return false;
+                }
+                if (!below && !above) continue;
+                if (above) { nx = -nx; ny = -ny; nz = -nz; d = -d; }
+
+                bool seen = false;
+                for (size_t q = start; q < planes.size() && !seen; ++q) {
+                    const HullPlane& h = planes[q];
+                    seen = h.nx * nx + h.ny * ny + h.nz * nz > 1.0f - 1e-5f && std::fabs(h.d - d) <= eps;
+                }
+                if (!seen) planes.push_back({nx, ny, nz, d});
+            }
+        }
+    }
+    return planes.size() > start;
+}
+
+bool isInsideHull(const Vec3& p, const HullPlane* planes, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        const HullPlane& h = planes[i];
+        float slack = 1e-5f * (std::fabs(h.d) + 1.0f);
+        if (h.nx * p.x + h.ny * p.y + h.nz * p.z - h.d > slack) return false;
+    }
+    return true;
+}
+
+void RegionBvh::clear() {
+    ids_.clear();
+    volumes_.clear();
+    planes_.clear();
+    nodes_.clear();
+}
+
+void RegionBvh::build(const std::unordered_map<RegionID, BrainRegion>& regions, uint64_t version) {
+    clear();
+    version_ = version;
+    ids_.reserve(regions.size());
+    volumes_.reserve(regions.size());
+
+    for (const auto& [id, region] : regions) {
+        Volume v{};
+        v.center = region.center;
+        v.radius2 = region.radius * region.radius;
+        v.firstPlane = static_cast<uint32_t>(planes_.size());
+        if (computeHullPlanes(region.convexHull, planes_)) {
+            v.planeCount = static_cast<uint32_t>(planes_.size()) - v.firstPlane;
+            v.min[0] = v.max[0] = region.convexHull[0].x;
+            v.min[1] = v.max[1] = region.convexHull[0].y;
+            v.min[2] = v.max[2] = region.convexHull[0].z;
+            for (const auto& p : region.convexHull) {
+                v.min[0] = std::min(v.min[0], p.x); v.max[0] = std::max(v.max[0], p.x);
+                v.min[1] = std::min(v.min[1], p.y); v.max[1] = std::max(v.max[1], p.y);
+                v.min[2] = std::min(v.min[2], p.z); v.max[2] = std::max(v.max[2], p.z);
+            }
+            v.size = (v.max[0] - v.min[0]) * (v.max[1] - v.min[1]) * (v.max[2] - v.min[2]);
+        } else {
+            if (region.radius < 0.0f) continue;
+            v.planeCount = 0;
+            v.min[0] = region.center.x - region.radius; v.max[0] = region.center.x + region.radius;
+            v.min[1] = region.center.y - region.radius; v.max[1] = region.center.y + region.radius;
+            v.min[2] = region.center.z - region.radius; v.max[2] = region.center.z + region.radius;
+            v.size = 4.18879f * region.radius * region.radius * region.radius; // 4/3 pi r^3
+        }
+        if (region.volume > 0.0f) v.size = region.volume;
+        v.idIndex = static_cast<uint32_t>(ids_.size());
+        ids_.push_back(id);
+        volumes_.push_back(v);
+    }
+
+    if (volumes_.empty()) return;
+    nodes_.reserve(2 * volumes_.size() / kLeafSize + 1);
+    nodes_.push_back(Node{});
+    buildNode(0, 0, static_cast<uint32_t>(volumes_.size()));
+}
+
+void RegionBvh::buildNode(uint32_t index, uint32_t first, uint32_t last) {
+    Node node{};
+    float cmin[3], cmax[3];
+    for (int a = 0; a < 3; ++a) {
+        node.min[a] = cmin[a] = INFINITY;
+        node.max[a] = cmax[a] = -INFINITY;
+    }
+    for (uint32_t i = first; i < last; ++i) {
+        const Volume& v = volumes_[i];
+        for (int a = 0; a < 3; ++a) {
+            node.min[a] = std::min(node.min[a], v.min[a]);
+            node.max[a] = std::max(node.max[a], v.max[a]);
+            float c = 0.5f * (v.min[a] + v.max[a]);
+            cmin[a] = std::min(cmin[a], c);
+            cmax[a] = std::max(cmax[a], c);
+        }
+    }
+
+    if (last - first <= kLeafSize) {
+        node.first = first;
+        node.count = last - first;
+        nodes_[index] = node;
+        return;
+    }
+
+    // Median split on the axis where the volume centers spread the most.
+    int axis = 0;
+    for (int a = 1; a < 3; ++a) {
+        if (cmax[a] - cmin[a] > cmax[axis] - cmin[axis]) axis = a;
+    }
+    uint32_t mid = first + (last - first) / 2;
+    std::nth_element(volumes_.begin() + first, volumes_.begin() + mid, volumes_.begin() + last,
+                     [axis](const Volume& a, const Volume& b) {
+        return a.min[axis] + a.max[axis] < b.min[axis] + b.max[axis];
+    });
+
+    uint32_t left = static_cast<uint32_t>(nodes_.size());
+    nodes_.push_back(Node{});
+    nodes_.push_back(Node{});
+    node.first = left;
+    node.count = 0;
+    nodes_[index] = node;
+    buildNode(left, first, mid);
+    buildNode(left + 1, mid, last);
+}
+
+bool RegionBvh::contains(const Volume& v, const Vec3& p) const {
+    if (p.x < v.min[0] || p.x > v.max[0] || p.y < v.min[1] || p.y > v.max[1] ||
+        p.z < v.min[2] || p.z > v.max[2]) return false;
+    if (v.planeCount > 0) return isInsideHull(p, planes_.data() + v.firstPlane, v.planeCount);
+    float dx = p.x - v.center.x, dy = p.y - v.center.y, dz = p.z - v.center.z;
+    return dx * dx + dy * dy + dz * dz <= v.radius2;
+}
+
+const RegionID* RegionBvh::findSmallestContaining(const Vec3& p) const {
+    if (nodes_.empty()) return nullptr;
+    const Volume* best = nullptr;
+
+    uint32_t stack[64];
+    int top = 0;
+    stack[top++] = 0;
+    while (top > 0) {
+        const Node& node = nodes_[stack[--top]];
+        if (p.x < node.min[0] || p.x > node.max[0] || p.y < node.min[1] || p.y > node.max[1] ||
+            p.z < node.min[2] || p.z > node.max[2]) continue;
+        if (node.count == 0) {
+            stack[top++] = node.first + 1;
+            stack[top++] = node.first;
+            continue;
+        }
+        for (uint32_t i = node.first; i < node.first + node.count; ++i) {
+            const Volume& v = volumes_[i];
+            if (!contains(v, p)) continue;
+            if (!best || outranks(v, *best)) best = &v;
+        }
+    }
+    return best ? &ids_[best->idIndex] : nullptr;
+}
+
+} // namespace model
@@ -0,0 +1,100 @@
+#ifndef REGION_BVH_H
+#define REGION_BVH_H
+
+#include "model_common.h"
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace model {
+
+struct BrainRegion;
+
+// Supporting plane of a convex hull; points with nx*x + ny*y + nz*z <= d are inside.
+struct HullPlane {
+    float nx, ny, nz, d;
+};
+
+// Face planes of the convex hull of `points`. Returns false when the points do not
+// span a volume (fewer than four, or coplanar) or there are too many to enumerate.
+bool computeHullPlanes(const std::vector<Vec3>& points, std::vector<HullPlane>& planes);
+bool isInsideHull(const Vec3& p, const HullPlane* planes, size_t count);
+
+// Bounding-volume hierarchy over region volumes for exact point containment.
+// A region's volume is its convex hull when one is defined, otherwise its
+// bounding sphere. Nodes are stored flat; leaves reference ranges of volumes.
+class RegionBvh {
+public:
+    struct Volume {
+        float min[3], max[3];
+        Vec3 center;
+        float radius2;
+        uint32_t firstPlane, planeCount; // planeCount == 0: sphere test
+        float size;
+        uint32_t idIndex;
+    };
+
+    // `version` tags the model state the hierarchy was built from.
+    void build(const std::unordered_map<RegionID, BrainRegion>& regions, uint64_t version = 0);
+    void clear();
+    uint64_t version() const { return version_; }
+
+    // Smallest region containing the point (by volume, then id), or nullptr.
+    const RegionID* findSmallestContaining(const Vec3& p) const;
+
+    // Calls fn(const Volume&) for every volume whose bounds reach `value` on `axis` (0 = x, 1 = y, 2 = z).
+    template <typename Fn>
+    void forEachCrossing(int axis, float value, Fn&& fn) const;
+
+    bool contains(const Volume& v, const Vec3& p) const;
+    // True when `a` wins over `b` where both contain a point.
+    bool outranks(const Volume& a, const Volume& b) const {
+        return a.size < b.size || (a.size == b.size && ids_[a.idIndex] < ids_[b.idIndex]);
+    }
+    const RegionID& idOf(const Volume& v) const { return ids_[v.idIndex]; }
+    const HullPlane* planesOf(const Volume& v) const { return planes_.data() + v.firstPlane; }
+
+    size_t size() const { return volumes_.size(); }
+
+private:
+    struct Node {
+        float min[3], max[3];
+        uint32_t first; // leaf: first volume; inner: left child (right child is first + 1)
+        uint32_t count; // leaf volume count; 0 for inner nodes
+    };
+
+    static constexpr uint32_t kLeafSize = 4;
+
+    void buildNode(uint32_t index, uint32_t first, uint32_t last);
+
+    uint64_t version_ = 0;
+    std::vector<RegionID> ids_;
+    std::vector<Volume> volumes_;
+    std::vector<HullPlane> planes_;
+    std::vector<Node> nodes_;
+};
+
+template <typename Fn>
+void RegionBvh::forEachCrossing(int axis, float value, Fn&& fn) const {
+    if (nodes_.empty()) return;
+    uint32_t stack[64];
+    int top = 0;
+    stack[top++] = 0;
+    while (top > 0) {
+        const Node& node = nodes_[stack[--top]];
+        if (value < node.min[axis] || value > node.max[axis]) continue;
+        if (node.count == 0) {
+            stack[top++] = node.first + 1;
+            stack[top++] = node.first;
+            continue;
+        }
+        for (uint32_t i = node.first; i < node.first + node.count; ++i) {
+            const Volume& v = volumes_[i];
+            if (value >= v.min[axis] && value <= v.max[axis]) fn(v);
+        }
+    }
+}
+
+} // namespace model
+
+#endif // REGION_BVH_H
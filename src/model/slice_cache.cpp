@@ -0,0 +1,172 @@
+#include "slice_cache.h"
+#include "../analytics/worker_pool.h"
+#include <functional>
+
+namespace model {
+
+EncodedSlice EncodedSlice::encode(const TextSlice& slice) {
+    EncodedSlice out;
+    out.plane = slice.plane;
+    out.position = slice.position;
+    out.width = slice.canvas.width;
+    out.height = slice.canvas.height;
+    out.summary = slice.summary;
+    const auto& cells = slice.canvas.cells;
+    for (size_t i = 0; i < cells.size();) {
+        const TextCell& cell = cells[i];
+        size_t end = i + 1;
+        while (end < cells.size() && cells[end].symbol == cell.symbol && cells[end].color == cell.color &&
+               cells[end].isBoundary == cell.isBoundary && cells[end].regionId == cell.regionId) {
+            ++end;
+        }
+        out.runs.push_back({static_cast<uint32_t>(end - i), cell.color, cell.regionId, cell.symbol, cell.isBoundary});
+        i = end;
+    }
+    out.runs.shrink_to_fit();
+    return out;
+}
+
+TextSlice EncodedSlice::decode() const {
+    TextSlice slice;
+    slice.plane = plane;
+    slice.position = position;
+    slice.summary = summary;
+    slice.canvas.width = width;
+    slice.canvas.height = height;
+    slice.canvas.cells.resize(static_cast<size_t>(width) * height);
+
+    size_t i = 0;
+    for (const Run& run : runs) {
+        for (size_t end = i + run.length; i < end; ++i) {
+            TextCell& cell = slice.canvas.cells[i];
+            cell.symbol = run.symbol;
+            cell.color = run.color;
+            cell.isBoundary = run.isBoundary;
+            cell.regionId = run.region;
+        }
+    }
+    return slice;
+}
+
+size_t EncodedSlice::footprint() const {
+    size_t bytes = sizeof(EncodedSlice) + summary.capacity() + runs.capacity() * sizeof(Run);
+    return bytes;
+}
+
+size_t SliceCache::KeyHash::operator()(const Key& k) const {
+    uint64_t h = k.version * 0x9E3779B97F4A7C15ULL;
+    h ^= (static_cast<uint64_t>(static_cast<uint32_t>(k.step)) << 32) | static_cast<uint32_t>(k.resolution);
+    h ^= static_cast<uint64_t>(k.plane) * 0xC2B2AE3D27D4EB4FULL;
+    return std::hash<uint64_t>{}(h);
+}
+
+SliceCache::SliceCache(size_t budgetBytes) : budget_(budgetBytes) {}
+
+SliceCache::~SliceCache() = default;
+
+void SliceCache::setBudget(size_t bytes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    budget_ = bytes;
+    evictLocked();
+}
+
+size_t SliceCache::budget() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return budget_;
+}
+
+size_t SliceCache::footprint() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return footprint_;
+}
+
+size_t SliceCache::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return lru_.size();
+}
+
+bool SliceCache::contains(const Key& key) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return index_.count(key) > 0;
+}
+
+bool SliceCache::get(const Key& key, TextSlice& out) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(key);
+    if (it == index_.end()) return false;
+    lru_.splice(lru_.begin(), lru_, it->second);
+    out = it->second->slice.decode();
+    return true;
+}
+
+void SliceCache::put(const Key& key, const TextSlice& slice) {
+    EncodedSlice encoded = EncodedSlice::encode(slice);
+    std::lock_guard<std::mutex> lock(mutex_);
+    insertLocked(key, std::move(encoded));
+}
+
+void SliceCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++generation_;
+    lru_.clear();
+    index_.clear();
+    pending_.clear();
+    footprint_ = 0;
+}
+
+void SliceCache::prefetch(const Key& key, std::function<TextSlice()> build) {
+    uint64_t generation;
+    analytics::WorkerPool* pool;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (index_.count(key) || !pending_.insert(key).second) return;
+        if (!pool_) pool_ = std::make_unique<analytics::WorkerPool>(1);
+        generation = generation_;
+        pool = pool_.get();
+    }
+    pool->enqueue([this, key, generation, build = std::move(build)] {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (generation != generation_) return;
+        }
+        EncodedSlice encoded = EncodedSlice::encode(build());
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (generation != generation_) return;
+        pending_.erase(key);
+        if (!index_.count(key)) insertLocked(key, std::move(encoded));
+    });
+}
+
+void SliceCache::waitIdle() {
+    analytics::WorkerPool* pool;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pool = pool_.get();
+    }
+    if (pool) pool->waitAll();
+}
+
+void SliceCache::insertLocked(const Key& key, EncodedSlice slice) {
+    size_t bytes = slice.footprint();
+    auto it = index_.find(key);
+    if (it != index_.end()) {
+        footprint_ -= it->second->bytes;
+        lru_.erase(it->second);
+        index_.erase(it);
+    }
+    if (bytes > budget_) return;
+    lru_.push_front({key, std::move(slice), bytes});
+    index_[key] = lru_.begin();
+    footprint_ += bytes;
+    evictLocked();
+}
+
+void SliceCache::evictLocked() {
+    while (footprint_ > budget_ && !lru_.empty()) {
+        footprint_ -= lru_.back().bytes;
+        index_.erase(lru_.back().key);
+        lru_.pop_back();
+    }
+}
+
+} // namespace model
@@ -0,0 +1,101 @@
+#ifndef SLICE_CACHE_H
+#define SLICE_CACHE_H
+
+#include "text_topology.h"
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace analytics { class WorkerPool; }
+
+namespace model {
+
+// Run-length encoded slice: consecutive equal cells collapse into one run.
+struct EncodedSlice {
+    struct Run {
+        uint32_t length;
+        uint32_t color;
+        RegionID region;
+        char symbol;
+        bool isBoundary;
+    };
+
+    TextSlice::Plane plane = TextSlice::Plane::Axial;
+    float position = 0.0f;
+    int width = 0, height = 0;
+    std::string summary;
+    std::vector<Run> runs;
+
+    static EncodedSlice encode(const TextSlice& slice);
+    TextSlice decode() const;
+    size_t footprint() const;
+};
+
+// LRU cache of encoded slices bounded by a byte budget. Slices can also be
+// built ahead of time on a background worker; prefetches are dropped when the
+// cache is cleared before they run.
+class SliceCache {
+public:
+    struct Key {
+        uint64_t version;
+        TextSlice::Plane plane;
+        int32_t step; // position in units of the slice's pixel pitch
+        int32_t resolution;
+
+        bool operator==(const Key& other) const {
+            return version == other.version && plane == other.plane &&
+                   step == other.step && resolution == other.resolution;
+        }
+    };
+
+    static constexpr size_t kDefaultBudget = 64u << 20;
+
+    explicit SliceCache(size_t budgetBytes = kDefaultBudget);
+    ~SliceCache();
+
+    // Shrinking the budget evicts least recently used slices immediately.
+    void setBudget(size_t bytes);
+    size_t budget() const;
+    size_t footprint() const;
+    size_t size() const;
+
+    bool contains(const Key& key) const;
+    bool get(const Key& key, TextSlice& out);
+    void put(const Key& key, const TextSlice& slice);
+    void clear();
+
+    // Builds the slice on the background worker unless it is cached or queued.
+    void prefetch(const Key& key, std::function<TextSlice()> build);
+    void waitIdle();
+
+private:
+    struct KeyHash {
+        size_t operator()(const Key& k) const;
+    };
+    struct Entry {
+        Key key;
+        EncodedSlice slice;
+        size_t bytes;
+    };
+
+    void insertLocked(const Key& key, EncodedSlice slice);
+    void evictLocked();
+
+    mutable std::mutex mutex_;
+    size_t budget_;
+    size_t footprint_ = 0;
+    uint64_t generation_ = 0; // bumped by clear() to cancel queued prefetches
+    std::list<Entry> lru_;    // most recent first
+    std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> index_;
+    std::unordered_set<Key, KeyHash> pending_;
+    std::unique_ptr<analytics::WorkerPool> pool_; // last member: joined before the rest is destroyed
+};
+
+} // namespace model
+
+#endif // SLICE_CACHE_H
@@ -0,0 +1,198 @@
+#include "slice_rasterizer.h"
+#include "../analytics/worker_pool.h"
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+namespace model {
+
+namespace {
+
+constexpr int kTileRows = 64;
+
+// In-plane axes (u, v) and the normal axis n, as x = 0, y = 1, z = 2.
+struct PlaneAxes {
+    int u, v, n;
+};
+
+PlaneAxes axesFor(TextSlice::Plane plane) {
+    switch (plane) {
+        case TextSlice::Plane::Axial:   return {0, 1, 2};
+        case TextSlice::Plane::Coronal: return {0, 2, 1};
+        default:                        return {1, 2, 0}; // Sagittal
+    }
+}
+
+inline float component(const Vec3& p, int axis) {
+    return axis == 0 ? p.x : (axis == 1 ? p.y : p.z);
+}
+
+inline float planeComponent(const HullPlane& h, int axis) {
+    return axis == 0 ? h.nx : (axis == 1 ? h.ny : h.nz);
+}
+
+class TileRasterizer {
+public:
+    TileRasterizer(const RegionBvh& bvh, const std::vector<const RegionBvh::Volume*>& volumes,
+                   PlaneAxes axes, float position, float range, const std::vector<float>& us,
+                   const std::vector<float>& vs)
+        : bvh_(bvh), volumes_(volumes), axes_(axes), position_(position),
+          halfRange_(range / 2.0f), pixelsPerUnit_(us.size() / range), us_(us), vs_(vs) {}
+
+    // Fills rows [y0, y1) of the canvas and flags the volumes that own a pixel.
+    void run(int y0, int y1, TextCanvas& canvas, std::vector<char>& seen) const {
+        int width = static_cast<int>(us_.size());
+        float vMin = vs_[y0], vMax = vs_[y1 - 1];
+        std::vector<uint32_t> local;
+        for (uint32_t i = 0; i < volumes_.size(); ++i) {
+            const auto& vol = *volumes_[i];
+            if (vol.max[axes_.v] >= vMin && vol.min[axes_.v] <= vMax) local.push_back(i);
+        }
+
+        // Owner per pixel, as index + 1 into volumes_; later volumes win.
+        std::vector<uint32_t> owner(width);
+        for (int y = y0; y < y1; ++y) {
+            std::fill(owner.begin(), owner.end(), 0u);
+            float v = vs_[y];
+            for (uint32_t i : local) {
+                int x0, x1;
+                if (span(*volumes_[i], v, x0, x1)) {
+                    std::fill(owner.begin() + x0, owner.begin() + x1 + 1, i + 1);
+                }
+            }
+            for (int x = 0; x < width; ++x) {
+                TextCell& cell = canvas.at(x, y);
+                if (owner[x] == 0) {
+                    cell.symbol = '.';
+                    continue;
+                }
+                uint32_t i = owner[x] - 1;
+                seen[i] = 1;
+                cell.regionId = bvh_.idOf(*volumes_[i]);
+                cell.symbol = '#';
+            }
+        }
+    }
+
+private:
+    Vec3 point(float u, float v) const {
+        float c[3];
+        c[axes_.u] = u;
+        c[axes_.v] = v;
+        c[axes_.n] = position_;
+        return {c[0], c[1], c[2]};
+    }
+
+    bool inside(const RegionBvh::Volume& vol, int x, float v) const {
+        return bvh_.contains(vol, point(us_[x], v));
+    }
+
+    // Pixel columns [x0, x1] of row `v` inside the volume.
+    bool span(const RegionBvh::Volume& vol, float v, int& x0, int& x1) const {
+        if (v < vol.min[axes_.v] || v > vol.max[axes_.v]) return false;
+        float lo = vol.min[axes_.u], hi = vol.max[axes_.u];
+
+        if (vol.planeCount == 0) {
+            float dn = position_ - component(vol.center, axes_.n);
+            float dv = v - component(vol.center, axes_.v);
+            float half = std::sqrt(std::max(vol.radius2 - dn * dn - dv * dv, 0.0f));
+            float cu = component(vol.center, axes_.u);
+            lo = std::max(lo, cu - half);
+            hi = std::min(hi, cu + half);
+        } else {
+            const HullPlane* planes = bvh_.planesOf(vol);
+            for (uint32_t p = 0; p < vol.planeCount; ++p) {
+                const HullPlane& h = planes[p];
+                float a = planeComponent(h, axes_.u);
+                float slack = 1e-5f * (std::fabs(h.d) + 1.0f);
+                float rhs = h.d + slack - planeComponent(h, axes_.v) * v - planeComponent(h, axes_.n) * position_;
+                if (std::fabs(a) < 1e-6f) {
+                    if (rhs < -slack) return false;
+                    continue;
+                }
+                if (a > 0) hi = std::min(hi, rhs / a);
+                else lo = std::max(lo, rhs / a);
+            }
+        }
+
+        // The estimate is only a starting point; snap both ends with the exact test.
+        int width = static_cast<int>(us_.size());
+        float fx0 = (lo + halfRange_) * pixelsPerUnit_, fx1 = (hi + halfRange_) * pixelsPerUnit_;
+        if (!(fx0 <= fx1 + 1.0f) || fx1 < -1.0f || fx0 > width) return false;
+        x0 = std::clamp(static_cast<int>(std::floor(fx0)), 0, width - 1);
+        x1 = std::clamp(static_cast<int>(std::ceil(fx1)), 0, width - 1);
+        while (x0 <= x1 && !inside(vol, x0, v)) ++x0;
+        while (x1 >= x0 && !inside(vol, x1, v)) --x1;
+        if (x0 > x1) return false;
+        while (x0 > 0 && inside(vol, x0 - 1, v)) --x0;
+        while (x1 < width - 1 && inside(vol, x1 + 1, v)) ++x1;
+        return true;
+    }
+
+    const RegionBvh& bvh_;
+    const std::vector<const RegionBvh::Volume*>& volumes_;
+    PlaneAxes axes_;
+    float position_;
+    float halfRange_, pixelsPerUnit_;
+    const std::vector<float>& us_;
+    const std::vector<float>& vs_;
+};
+
+// Same sampling as the per-pixel slice loop, so coordinates match bit for bit.
+std::vector<float> sampleCoordinates(int resolution, float range) {
+    float halfRange = range / 2.0f;
+    std::vector<float> coords(resolution);
+    for (int i = 0; i < resolution; ++i) {
+        coords[i] = (static_cast<float>(i) / resolution) * range - halfRange;
+    }
+    return coords;
+}
+
+} // namespace
+
+size_t SliceRasterizer::rasterize(const RegionBvh& regions, TextSlice::Plane plane, float position,
+                                  float range, TextCanvas& canvas) {
+    if (canvas.width <= 0 || canvas.height <= 0) return 0;
+    PlaneAxes axes = axesFor(plane);
+
+    // Weakest first, so the smallest region is painted last and ends on top.
+    std::vector<const RegionBvh::Volume*> volumes;
+    regions.forEachCrossing(axes.n, position, [&](const RegionBvh::Volume& v) { volumes.push_back(&v); });
+    std::sort(volumes.begin(), volumes.end(), [&](const RegionBvh::Volume* a, const RegionBvh::Volume* b) {
+        return regions.outranks(*b, *a);
+    });
+
+    std::vector<float> us = sampleCoordinates(canvas.width, range);
+    std::vector<float> vs = sampleCoordinates(canvas.height, range);
+    TileRasterizer tile(regions, volumes, axes, position, range, us, vs);
+
+    int tiles = (canvas.height + kTileRows - 1) / kTileRows;
+    std::vector<std::vector<char>> seen(tiles, std::vector<char>(volumes.size(), 0));
+    size_t threads = std::max(1u, std::thread::hardware_concurrency());
+    if (tiles == 1 || threads == 1) {
+        for (int t = 0; t < tiles; ++t) {
+            tile.run(t * kTileRows, std::min(canvas.height, (t + 1) * kTileRows), canvas, seen[t]);
+        }
+    } else {
+        analytics::WorkerPool pool(std::min(threads, static_cast<size_t>(tiles)));
+        for (int t = 0; t < tiles; ++t) {
+            pool.enqueue([&, t] {
+                tile.run(t * kTileRows, std::min(canvas.height, (t + 1) * kTileRows), canvas, seen[t]);
+            });
+        }
+        pool.waitAll();
+    }
+
+    size_t painted = 0;
+    for (size_t i = 0; i < volumes.size(); ++i) {
+        for (const auto& flags : seen) {
+            if (flags[i]) {
+                ++painted;
+                break;
+            }
+        }
+    }
+    return painted;
+}
+
+} // namespace model
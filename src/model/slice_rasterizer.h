@@ -0,0 +1,25 @@
+#ifndef SLICE_RASTERIZER_H
+#define SLICE_RASTERIZER_H
+
+#include "region_bvh.h"
+#include "text_topology.h"
+
+namespace model {
+
+// Scan-converts region footprints on a slice plane into a text canvas. Each
+// volume crossing the plane yields one span per row (a circle chord for
+// spheres, the intersection of half-planes for hulls); span ends are snapped
+// with the exact containment test so the result matches per-pixel
+// BrainModel::findRegionAt. Overlaps go to the smallest region. Row tiles are
+// filled in parallel.
+class SliceRasterizer {
+public:
+    // Pixel (x, y) samples (x / width * range - range / 2, y / height * range - range / 2)
+    // on the plane. `canvas` must be sized; returns the number of distinct regions painted.
+    static size_t rasterize(const RegionBvh& regions, TextSlice::Plane plane, float position,
+                            float range, TextCanvas& canvas);
+};
+
+} // namespace model
+
+#endif // SLICE_RASTERIZER_H
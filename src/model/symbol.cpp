@@ -0,0 +1,99 @@
+#include "symbol.h"
+#include <atomic>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+namespace model {
+
+namespace {
+
+// Strings live in fixed-size chunks that never move, so a handle resolves
+// without locking; only interning new text takes the writer lock.
+class SymbolTable {
+public:
+    static constexpr uint32_t kChunkBits = 12;
+    static constexpr uint32_t kChunkSize = 1u << kChunkBits;
+    static constexpr uint32_t kMaxChunks = 1u << 16;
+
+    SymbolTable() : chunks_(new std::atomic<std::string*>[kMaxChunks]) {
+        for (uint32_t i = 0; i < kMaxChunks; ++i) chunks_[i].store(nullptr, std::memory_order_relaxed);
+        append(std::string()); // handle 0
+    }
+
+    uint32_t intern(std::string_view text) {
+        if (text.empty()) return 0;
+        {
+            std::shared_lock<std::shared_mutex> lock(mutex_);
+            auto it = index_.find(text);
+            if (it != index_.end()) return it->second;
+        }
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        auto it = index_.find(text);
+        if (it != index_.end()) return it->second;
+        return append(std::string(text));
+    }
+
+    uint32_t find(std::string_view text) const {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        auto it = index_.find(text);
+        return it == index_.end() ? 0 : it->second;
+    }
+
+    const std::string& lookup(uint32_t handle) const {
+        const std::string* chunk = chunks_[handle >> kChunkBits].load(std::memory_order_acquire);
+        return chunk[handle & (kChunkSize - 1)];
+    }
+
+    size_t size() const { return count_.load(std::memory_order_acquire); }
+
+private:
+    // Caller holds the writer lock (or is the constructor).
+    uint32_t append(std::string text) {
+        uint32_t handle = count_.load(std::memory_order_relaxed);
+        if ((handle >> kChunkBits) >= kMaxChunks) std::abort();
+        std::string* chunk = chunks_[handle >> kChunkBits].load(std::memory_order_relaxed);
+        if (!chunk) {
+            chunk = new std::string[kChunkSize];
+            chunks_[handle >> kChunkBits].store(chunk, std::memory_order_release);
+        }
+        std::string& slot = chunk[handle & (kChunkSize - 1)];
+        slot = std::move(text);
+        index_.emplace(std::string_view(slot), handle);
+        count_.store(handle + 1, std::memory_order_release);
+        return handle;
+    }
+
+    mutable std::shared_mutex mutex_;
+    std::unordered_map<std::string_view, uint32_t> index_; // views into the chunks
+    std::unique_ptr<std::atomic<std::string*>[]> chunks_;
+    std::atomic<uint32_t> count_{0};
+};
+
+// Never destroyed, so ids held by other statics stay readable during shutdown.
+SymbolTable& table() {
+    static SymbolTable* instance = new SymbolTable();
+    return *instance;
+}
+
+} // namespace
+
+uint32_t Symbol::intern(std::string_view text) {
+    return table().intern(text);
+}
+
+const std::string& Symbol::lookup(uint32_t handle) {
+    return table().lookup(handle);
+}
+
+Symbol Symbol::find(std::string_view text) {
+    return fromHandle(table().find(text));
+}
+
+size_t Symbol::tableSize() {
+    return table().size();
+}
+
+} // namespace model
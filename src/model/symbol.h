@@ -0,0 +1,79 @@
+#ifndef SYMBOL_H
+#define SYMBOL_H
+
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+namespace model {
+
+// Interned string: a 32-bit handle into a process-wide table. Equal strings
+// share a handle, so copies, equality and hashing are integer operations; the
+// text is only looked up for output. Handle 0 is the empty string. Ordering
+// compares the text, so sorted containers keep their alphabetical order.
+class Symbol {
+public:
+    Symbol() = default;
+    Symbol(const std::string& text) : handle_(intern(text)) {}
+    Symbol(const char* text) : handle_(intern(text)) {}
+    Symbol(std::string_view text) : handle_(intern(text)) {}
+
+    // `handle` must come from handle() in this process.
+    static Symbol fromHandle(uint32_t handle) {
+        Symbol s;
+        s.handle_ = handle;
+        return s;
+    }
+    // Existing symbol for `text`, or the empty symbol if it was never interned.
+    static Symbol find(std::string_view text);
+    // Number of distinct strings interned so far, including the empty string.
+    static size_t tableSize();
+
+    uint32_t handle() const { return handle_; }
+    const std::string& str() const { return lookup(handle_); }
+    operator const std::string&() const { return str(); }
+
+    bool empty() const { return handle_ == 0; }
+    size_t size() const { return str().size(); }
+    const char* c_str() const { return str().c_str(); }
+    std::string substr(size_t pos, size_t count = std::string::npos) const { return str().substr(pos, count); }
+
+    friend bool operator==(Symbol a, Symbol b) { return a.handle_ == b.handle_; }
+    friend bool operator!=(Symbol a, Symbol b) { return a.handle_ != b.handle_; }
+    friend bool operator<(Symbol a, Symbol b) { return a.handle_ != b.handle_ && a.str() < b.str(); }
+
+    // Comparing against plain text does not intern it.
+    friend bool operator==(Symbol a, const std::string& b) { return a.str() == b; }
+    friend bool operator==(const std::string& a, Symbol b) { return a == b.str(); }
+    friend bool operator==(Symbol a, const char* b) { return a.str() == b; }
+    friend bool operator==(const char* a, Symbol b) { return a == b.str(); }
+    friend bool operator!=(Symbol a, const std::string& b) { return !(a == b); }
+    friend bool operator!=(const std::string& a, Symbol b) { return !(a == b); }
+    friend bool operator!=(Symbol a, const char* b) { return !(a == b); }
+    friend bool operator!=(const char* a, Symbol b) { return !(a == b); }
+
+    friend std::string operator+(const std::string& a, Symbol b) { return a + b.str(); }
+    friend std::string operator+(Symbol a, const std::string& b) { return a.str() + b; }
+    friend std::string operator+(const char* a, Symbol b) { return a + b.str(); }
+    friend std::string operator+(Symbol a, const char* b) { return a.str() + b; }
+    friend std::ostream& operator<<(std::ostream& out, Symbol s) { return out << s.str(); }
+
+private:
+    static uint32_t intern(std::string_view text);
+    static const std::string& lookup(uint32_t handle);
+
+    uint32_t handle_ = 0;
+};
+
+} // namespace model
+
+namespace std {
+template <>
+struct hash<model::Symbol> {
+    size_t operator()(model::Symbol s) const noexcept { return s.handle(); }
+};
+} // namespace std
+
+#endif // SYMBOL_H
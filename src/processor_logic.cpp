@@ -1,28 +1,32 @@
 #include "processor_logic.h"
+#include "analytics/worker_pool.h"
 #include <iostream>
 #include <fstream>
-#include <sstream>
 #include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
 
 namespace tp {
 
-std::vector<std::string> splitBlocks(const std::string& text) {
-    std::vector<std::string> blocks;
+std::vector<std::string_view> splitBlockViews(std::string_view text) {
+    std::vector<std::string_view> blocks;
     size_t pos = 0, start = 0;
-    while ((pos = text.find("\n\n", start)) != std::string::npos) {
-        std::string blk = text.substr(start, pos - start);
-        if (!blk.empty()) blocks.push_back(blk);
+    while ((pos = text.find("\n\n", start)) != std::string_view::npos) {
+        if (pos > start) blocks.push_back(text.substr(start, pos - start));
         start = pos + 2;
     }
-    std::string tail = text.substr(start);
-    if (!tail.empty()) blocks.push_back(tail);
+    if (start < text.size()) blocks.push_back(text.substr(start));
     return blocks;
 }
 
-std::vector<std::string> splitLines(const std::string& block) {
-    std::vector<std::string> lines;
+std::vector<std::string_view> splitLineViews(std::string_view block) {
+    std::vector<std::string_view> lines;
     size_t start = 0, pos;
-    while ((pos = block.find_first_of("\r\n", start)) != std::string::npos) {
+    while ((pos = block.find_first_of("\r\n", start)) != std::string_view::npos) {
         if (pos > start) lines.push_back(block.substr(start, pos - start));
         start = pos + 1;
         while (start < block.size() && (block[start] == '\r' || block[start] == '\n')) ++start;
@@ -31,6 +35,63 @@ std::vector<std::string> splitLines(const std::string& block) {
     return lines;
 }
 
+std::vector<std::string> splitBlocks(const std::string& text) {
+    auto views = splitBlockViews(text);
+    return std::vector<std::string>(views.begin(), views.end());
+}
+
+std::vector<std::string> splitLines(const std::string& block) {
+    auto views = splitLineViews(block);
+    return std::vector<std::string>(views.begin(), views.end());
+}
+
+namespace {
+
+enum class LineKind { Topic, OneLiner, Paragraph };
+
+struct ClassifiedLine {
+    LineKind kind;
+    std::string_view text;
+};
+
+// Parser-stage output for one file. Line views borrow from `text`, so the
+// partial must stay alive until the merge stage has consumed it.
+struct FilePartial {
+    std::string text;
+    std::vector<ClassifiedLine> lines;
+    std::vector<size_t> blockEnds; // one entry per non-empty block, indexing into lines
+    std::exception_ptr error;
+    bool ready = false;
+};
+
+void parseFile(const std::filesystem::path& path, FilePartial& out) {
+    {
+        std::ifstream in(path, std::ios::binary);
+        if (in) {
+            in.seekg(0, std::ios::end);
+            std::streamoff size = in.tellg();
+            in.seekg(0, std::ios::beg);
+            if (size > 0) {
+                out.text.resize(static_cast<size_t>(size));
+                in.read(&out.text[0], size);
+                out.text.resize(static_cast<size_t>(in.gcount()));
+            }
+        }
+    }
+
+    for (auto blk : splitBlockViews(out.text)) {
+        for (auto L : splitLineViews(blk)) {
+            int dots = (int)std::count(L.begin(), L.end(), '.');
+            if (dots > 1) out.lines.push_back({LineKind::Paragraph, L});
+            else if (dots == 1 && L.size() < 40) out.lines.push_back({LineKind::OneLiner, L});
+            else if (dots == 0) out.lines.push_back({LineKind::Topic, L});
+        }
+        out.blockEnds.push_back(out.lines.size());
+    }
+}
+
+} // namespace
+
 int processTopics(const std::filesystem::path& inDir, const std::filesystem::path& outDir) {
     try {
         if (!std::filesystem::exists(inDir)) {
@@ -41,57 +102,101 @@ int processTopics(const std::filesystem::path& inDir, const std::filesystem::pat
             std::filesystem::create_directories(outDir);
         }
 
-        std::vector<Node> nodes;
-        std::unordered_map<std::string, int> nodeIndex;
-        std::vector<std::string> oneLiners, paragraphs;
-        int subjectId = 0;
-
+        // Reader stage: fix the file order up front so the merge is deterministic.
+        std::vector<std::filesystem::path> files;
         for (auto& file : std::filesystem::directory_iterator(inDir)) {
             if (file.path().extension() != ".txt") continue;
+            files.push_back(file.path());
+        }
+
+        size_t threads = std::max(1u, std::thread::hardware_concurrency());
+        size_t window = threads * 4; // bounds how many file buffers are held at once
+
+        std::vector<std::unique_ptr<FilePartial>> partials(files.size());
+        std::mutex readyMutex;
+        std::condition_variable readyCond;
+
+        analytics::WorkerPool pool(std::min(threads, std::max<size_t>(files.size(), 1)));
+        size_t nextToEnqueue = 0;
+        auto enqueueNext = [&]() {
+            size_t i = nextToEnqueue++;
+            partials[i] = std::make_unique<FilePartial>();
+            FilePartial* partial = partials[i].get();
+            const std::filesystem::path* path = &files[i];
+            pool.enqueue([partial, path, &readyMutex, &readyCond]() {
+                try {
+                    parseFile(*path, *partial);
+                } catch (...) {
+                    partial->error = std::current_exception();
+                }
+                {
+                    std::lock_guard<std::mutex> lock(readyMutex);
+                    partial->ready = true;
+                }
+                readyCond.notify_all();
+            });
+        };
+        while (nextToEnqueue < files.size() && nextToEnqueue < window) enqueueNext();
+
+        // Merge stage: consume partials strictly in file order, dedup topics.
+        std::deque<Node> nodes; // deque keeps names stable for the view-keyed index
+        std::unordered_map<std::string_view, int> nodeIndex;
+        std::vector<std::string> oneLiners, paragraphs;
+        int subjectId = 0;
+        std::exception_ptr mergeError;
 
-            std::ifstream in(file.path());
-            std::stringstream buffer;
-            buffer << in.rdbuf();
-            std::string text = buffer.str();
+        for (size_t f = 0; f < files.size(); ++f) {
+            {
+                std::unique_lock<std::mutex> lock(readyMutex);
+                readyCond.wait(lock, [&]() { return partials[f]->ready; });
+            }
+            FilePartial& part = *partials[f];
+            if (part.error) {
+                mergeError = part.error;
+                break;
+            }
 
-            auto blocks = splitBlocks(text);
-            for (auto& blk : blocks) {
-                auto lines = splitLines(blk);
+            size_t lineIdx = 0;
+            for (size_t blockEnd : part.blockEnds) {
                 int w = 10;
                 int firstNodeIdx = -1;
-                for (auto& L : lines) {
-                    int dots = (int)std::count(L.begin(), L.end(), '.');
-                    bool isPara = dots > 1;
-                    bool isOne  = (dots == 1 && L.size() < 40);
-                    bool isTopic = (dots == 0);
-
-                    if (isPara) paragraphs.push_back(L);
-                    else if (isOne) oneLiners.push_back(L);
-                    else if (isTopic) {
-                        auto it = nodeIndex.find(L);
+                for (; lineIdx < blockEnd; ++lineIdx) {
+                    const auto& line = part.lines[lineIdx];
+                    if (line.kind == LineKind::Paragraph) {
+                        paragraphs.emplace_back(line.text);
+                    } else if (line.kind == LineKind::OneLiner) {
+                        oneLiners.emplace_back(line.text);
+                    } else {
+                        int idx;
+                        auto it = nodeIndex.find(line.text);
                         if (it == nodeIndex.end()) {
-                            int idx = (int)nodes.size();
-                            nodes.push_back({L, {}, std::max(w, 1), subjectId});
-                            nodeIndex[L] = idx;
+                            idx = (int)nodes.size();
+                            nodes.push_back({std::string(line.text), {}, std::max(w, 1), subjectId});
+                            nodeIndex.emplace(nodes.back().name, idx);
                             if (firstNodeIdx < 0) firstNodeIdx = idx;
                         } else {
-                            int idx = it->second;
+                            idx = it->second;
                             nodes[idx].weight = std::max(nodes[idx].weight, w);
                         }
 
                         w = std::max(1, w - 1);
 
-                        if (firstNodeIdx >= 0 && nodeIndex[L] != firstNodeIdx) {
-                            int currIdx = nodeIndex[L];
-                            nodes[firstNodeIdx].neigh.insert(currIdx);
-                            nodes[currIdx].neigh.insert(firstNodeIdx);
+                        if (firstNodeIdx >= 0 && idx != firstNodeIdx) {
+                            nodes[firstNodeIdx].neigh.insert(idx);
+                            nodes[idx].neigh.insert(firstNodeIdx);
                         }
                     }
                 }
                 subjectId++;
             }
+
+            partials[f].reset();
+            if (nextToEnqueue < files.size()) enqueueNext();
         }
 
+        pool.waitAll();
+        if (mergeError) std::rethrow_exception(mergeError);
+
         // CSV Export
         std::ofstream csv(outDir / "output.csv");
         csv << "Name,Index,Neighbors,Weight,SubjectIndex\n";
@@ -1,5 +1,6 @@
 #pragma once
 #include <string>
+#include <string_view>
 #include <vector>
 #include <set>
 #include <unordered_map>
@@ -15,6 +16,12 @@ namespace tp {
 
     std::vector<std::string> splitBlocks(const std::string& text);
     std::vector<std::string> splitLines(const std::string& block);
-    
+
+    // Zero-copy variants used by the ingestion pipeline; views borrow from the input.
+    std::vector<std::string_view> splitBlockViews(std::string_view text);
+    std::vector<std::string_view> splitLineViews(std::string_view block);
+
+    // Reads *.txt files on WorkerPool threads and merges them in directory order,
+    // so output is identical to a serial walk.
     int processTopics(const std::filesystem::path& inDir, const std::filesystem::path& outDir);
 }
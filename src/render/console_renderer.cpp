@@ -1,4 +1,6 @@
 #include "console_renderer.h"
+#include "edge_lod.h"
+#include "label_placer.h"
 #include "layout/layout_manager.h"
 #include "layout/book_view.h"
 #include "layout/minimap_renderer.h"
@@ -11,6 +13,7 @@
 #include <tuple>
 #include <limits>
 #include <algorithm>
+#include <cmath>
 #include <map>
 
 namespace render {
@@ -20,6 +23,7 @@ bool ConsoleRenderer::initialize(int width, int height) {
     height_ = height;
     frameBuffer_ = std::make_unique<FrameBuffer>(width, height);
     viewport_ = std::make_unique<Viewport>(width, height);
+    presenter_.invalidate();
     return true;
 }
 
@@ -35,28 +39,32 @@ void ConsoleRenderer::render(const Graph& graph, const ViewContext& view) {
 
 void ConsoleRenderer::renderWithUI(const Graph& graph, const ViewContext& view, const SearchState& search, const input::ShortcutManager& shortcutManager) {
     if (!frameBuffer_ || !viewport_) return;
+    renderFrame(*frameBuffer_, grid_, graph, view, search, shortcutManager);
+}
 
-    viewport_->setPan(view.panX, view.panY);
+void ConsoleRenderer::renderFrame(FrameBuffer& fb, LayoutGrid& grid, const Graph& graph, const ViewContext& view, const SearchState& search, const input::ShortcutManager& shortcutManager) const {
+    Viewport viewport(fb.getWidth(), fb.getHeight());
+    viewport.setPan(view.panX, view.panY);
 
     if (view.currentViewMode == VM_PERSPECTIVE) {
-        frameBuffer_->setTitle("Full Layout");
+        fb.setTitle("Full Layout");
     } else if (view.currentViewMode == VM_NEXUS_FLOW) {
-        frameBuffer_->setTitle("Nexus Flow");
+        fb.setTitle("Nexus Flow");
     } else if (view.currentViewMode == VM_BOOK_VIEW) {
-        frameBuffer_->setTitle("CBT Graph Viewer (Book View)");
+        fb.setTitle("CBT Graph Viewer (Book View)");
     }
 
     // --- Mode-Specific Rendering ---
 
     if (view.currentViewMode == VM_BOOK_VIEW) {
-        frameBuffer_->setTitle("Book View");
+        fb.setTitle("Book View");
         auto chapters = layout::BookView::createBookStructure(graph, view);
         int y = 2;
         for (const auto& ch : chapters) {
-            frameBuffer_->drawString(2, y++, "-- " + ch.chapterTitle + " (Depth " + std::to_string(ch.chapterDepth) + ") --", -1.0f);
+            fb.drawString(2, y++, "-- " + ch.chapterTitle + " (Depth " + std::to_string(ch.chapterDepth) + ") --", -1.0f);
             for (int nodeId : ch.nodeIds) {
                 bool isFocused = graph.isNodeFocused(nodeId);
-                bool isMatch = search.isActive && std::find(search.matches.begin(), search.matches.end(), nodeId) != search.matches.end();
+                bool isMatch = search.isHighlighted(nodeId);
                 bool isActiveMatch = search.getActiveMatchNodeId() == nodeId;
 
                 std::string prefix = "  ";
@@ -64,12 +72,12 @@ void ConsoleRenderer::renderWithUI(const Graph& graph, const ViewContext& view,
                 else if (isMatch) prefix = " >";
                 else if (isFocused) prefix = " o";
 
-                frameBuffer_->drawString(4, y++, prefix + "[" + graph.nodeMap.at(nodeId).label + "]", -1.0f);
+                fb.drawString(4, y++, prefix + "[" + graph.nodeMap.at(nodeId).label + "]", -1.0f);
             }
             y++;
         }
     } else if (view.currentViewMode == VM_PAGED) {
-        frameBuffer_->setTitle("Node Page View");
+        fb.setTitle("Node Page View");
         int nodeId = -1;
         if (!graph.focusedNodeIndices.empty()) {
             nodeId = *graph.focusedNodeIndices.begin();
@@ -78,46 +86,66 @@ void ConsoleRenderer::renderWithUI(const Graph& graph, const ViewContext& view,
         if (nodeId != -1 && graph.nodeExists(nodeId)) {
             const auto& n = graph.nodeMap.at(nodeId);
             int y = 2;
-            frameBuffer_->drawString(2, y++, "=== CBT Node Page View ===", -1.0f);
-            frameBuffer_->drawString(2, y++, "Label: " + n.label, -1.0f);
-            frameBuffer_->drawString(2, y++, "Index: " + std::to_string(n.index), -1.0f);
-            frameBuffer_->drawString(2, y++, "Subject: " + std::to_string(n.subjectIndex), -1.0f);
-            frameBuffer_->drawString(2, y++, "Weight: " + std::to_string(n.weight), -1.0f);
+            fb.drawString(2, y++, "=== CBT Node Page View ===", -1.0f);
+            fb.drawString(2, y++, "Label: " + n.label, -1.0f);
+            fb.drawString(2, y++, "Index: " + std::to_string(n.index), -1.0f);
+            fb.drawString(2, y++, "Subject: " + std::to_string(n.subjectIndex), -1.0f);
+            fb.drawString(2, y++, "Weight: " + std::to_string(n.weight), -1.0f);
 
             y++;
-            frameBuffer_->drawString(2, y++, "Neighbors:", -1.0f);
+            fb.drawString(2, y++, "Neighbors:", -1.0f);
             for (int nbr : n.neighbors) {
                 if (graph.nodeExists(nbr)) {
-                    frameBuffer_->drawString(4, y++, "• " + graph.nodeMap.at(nbr).label, -1.0f);
+                    fb.drawString(4, y++, "• " + graph.nodeMap.at(nbr).label, -1.0f);
                 }
             }
         } else {
-            frameBuffer_->drawString(2, 2, "No node selected for Page View.", -1.0f);
+            fb.drawString(2, 2, "No node selected for Page View.", -1.0f);
         }
     } else {
         // Full Layout or Nexus Flow (Spatial views)
-        // Render Edges
-        for (const auto& node : graph.nodes) {
-            if (graph.layoutPositions.count(node.index) == 0) continue;
-            Point2D p1 = viewport_->worldToScreen(graph.layoutPositions.at(node.index).x, graph.layoutPositions.at(node.index).y);
-
-            for (int neighbor_id : node.neighbors) {
-                if (graph.layoutPositions.count(neighbor_id) == 0) continue;
-                Point2D p2 = viewport_->worldToScreen(graph.layoutPositions.at(neighbor_id).x, graph.layoutPositions.at(neighbor_id).y);
-
-                frameBuffer_->drawLine(static_cast<int>(p1.x), static_cast<int>(p1.y),
-                                       static_cast<int>(p2.x), static_cast<int>(p2.y), '.', 1.0f);
-            }
+        grid.update(graph);
+        std::vector<int> visible;
+
+        // Render Edges: only those whose bounds reach the screen, clipped by drawLine.
+        // Screen coordinates truncate toward zero, so the band just left/above is visible too.
+        Point2D lo = viewport.screenToWorld(-1.0f, -1.0f);
+        Point2D hi = viewport.screenToWorld(static_cast<float>(fb.getWidth()), static_cast<float>(fb.getHeight()));
+        grid.queryEdges(lo.x, lo.y, hi.x, hi.y, visible);
+
+        // Zoomed out, edges between the same pair of cells merge into one density-coded bundle.
+        EdgeLod lod(EdgeLod::cellSizeFor(view.zoomLevel));
+        for (int id : visible) {
+            const auto& edge = grid.edge(id);
+            const auto& a = grid.node(edge.from);
+            const auto& b = grid.node(edge.to);
+            Point2D p1 = viewport.worldToScreen(a.x, a.y);
+            Point2D p2 = viewport.worldToScreen(b.x, b.y);
+            lod.add(static_cast<float>(static_cast<int>(p1.x)), static_cast<float>(static_cast<int>(p1.y)),
+                    static_cast<float>(static_cast<int>(p2.x)), static_cast<float>(static_cast<int>(p2.y)));
+        }
+        for (const auto& bundle : lod.bundles()) {
+            fb.drawLine(static_cast<int>(std::lround(bundle.x1)), static_cast<int>(std::lround(bundle.y1)),
+                        static_cast<int>(std::lround(bundle.x2)), static_cast<int>(std::lround(bundle.y2)),
+                        EdgeLod::glyphFor(bundle.count), 1.0f);
         }
 
-        // Render Nodes
-        for (const auto& node : graph.nodes) {
-            if (graph.layoutPositions.count(node.index) == 0) continue;
-            Point2D p = viewport_->worldToScreen(graph.layoutPositions.at(node.index).x, graph.layoutPositions.at(node.index).y);
+        // Render Nodes: widen the query by the largest node box plus label so
+        // anything partly on screen is still drawn.
+        float margin = static_cast<float>(graph.calculateNodeSize(static_cast<int>(grid.minDepth()), view.zoomLevel) +
+                                          grid.maxLabelLength() + 2);
+        grid.queryNodes(lo.x - margin, lo.y - margin, hi.x + margin, hi.y + margin, visible);
+        LabelPlacer labels(fb.getWidth(), fb.getHeight());
+        int baseLabelLength = grid.maxLabelLength() > 0 ? grid.maxLabelLength() : 10;
+        for (int id : visible) {
+            const auto& entry = grid.node(id);
+            const auto& node = graph.nodes[entry.slot];
+            Point2D p = viewport.worldToScreen(entry.x, entry.y);
 
             int depth = 0;
-            if (graph.nodePos.count(node.index)) {
-                depth = static_cast<int>(graph.nodePos.at(node.index).z);
+            auto pos = graph.nodePos.find(node.index);
+            if (pos != graph.nodePos.end()) {
+                depth = static_cast<int>(pos->second.z);
             }
 
             int size = graph.calculateNodeSize(depth, view.zoomLevel);
@@ -125,37 +153,46 @@ void ConsoleRenderer::renderWithUI(const Graph& graph, const ViewContext& view,
                          (node.subjectIndex % 4 == 0 ? '@' :
                           node.subjectIndex % 4 == 1 ? '#' : 'X');
 
-            if (search.isActive && std::find(search.matches.begin(), search.matches.end(), node.index) != search.matches.end()) {
+            if (search.isHighlighted(node.index)) {
                 glyph = (search.getActiveMatchNodeId() == node.index) ? 'S' : 's';
             }
 
             if (size <= 1) {
-                frameBuffer_->drawChar(static_cast<int>(p.x), static_cast<int>(p.y), glyph, static_cast<float>(depth));
+                fb.drawChar(static_cast<int>(p.x), static_cast<int>(p.y), glyph, static_cast<float>(depth));
             } else {
-                frameBuffer_->drawRect(static_cast<int>(p.x - size / 2), static_cast<int>(p.y - size / 2), size, size, glyph, static_cast<float>(depth));
+                fb.drawRect(static_cast<int>(p.x - size / 2), static_cast<int>(p.y - size / 2), size, size, glyph, static_cast<float>(depth));
             }
-
-            // Label
-            frameBuffer_->drawString(static_cast<int>(p.x + size / 2 + 1), static_cast<int>(p.y + size / 2 + 1), node.label, static_cast<float>(depth));
+            labels.reserve(static_cast<int>(p.x - size / 2), static_cast<int>(p.y - size / 2), size, size);
+
+            // Labels are placed after every node box is reserved: focus and search hits first,
+            // then nearer and heavier nodes.
+            bool hit = search.isHighlighted(node.index);
+            int tier = (hit && search.getActiveMatchNodeId() == node.index) ? 3 :
+                       graph.isNodeFocused(node.index) ? 2 : hit ? 1 : 0;
+            size_t maxLen = static_cast<size_t>(getAdaptiveLabelLength(depth, view.zoomLevel, baseLabelLength));
+            std::string_view text(node.label);
+            labels.add({static_cast<int>(p.x), static_cast<int>(p.y), size, text.substr(0, maxLen),
+                        static_cast<float>(depth), tier, depth, node.weight, id});
         }
+        labels.place(fb);
     }
 
 
     if (view.showMinimap && view.currentViewMode == VM_PERSPECTIVE) {
-        MinimapRenderer::draw(*frameBuffer_, width_ - 25, 2, graph, view);
+        MinimapRenderer::draw(fb, fb.getWidth() - 25, 2, graph, view);
     }
 
     if (view.showHelp) {
-        ui::MainMenu::draw(*frameBuffer_, view.height + 1, shortcutManager);
-        ui::StatusBar::draw(*frameBuffer_, view.height + 6, search);
+        ui::MainMenu::draw(fb, view.height + 1, shortcutManager);
+        ui::StatusBar::draw(fb, view.height + 6, search);
     } else {
-        ui::StatusBar::draw(*frameBuffer_, view.height + 1, search);
+        ui::StatusBar::draw(fb, view.height + 1, search);
     }
 }
 
 void ConsoleRenderer::present() {
     if (frameBuffer_) {
-        frameBuffer_->present();
+        presenter_.present(*frameBuffer_);
     }
 }
 
@@ -3,6 +3,8 @@
 
 #include "render_interface.h"
 #include "frame_buffer.h"
+#include "layout_grid.h"
+#include "terminal_presenter.h"
 #include "viewport.h"
 #include "../search_logic.h"
 #include "../input/shortcut_manager.h"
@@ -19,11 +21,17 @@ public:
     void clear() override;
     void render(const Graph& graph, const ViewContext& view) override;
     void renderWithUI(const Graph& graph, const ViewContext& view, const SearchState& search, const input::ShortcutManager& shortcutManager);
+    // Draws into a caller-owned buffer and culling grid; touches no renderer state,
+    // so it may run off the main thread.
+    void renderFrame(FrameBuffer& fb, LayoutGrid& grid, const Graph& graph, const ViewContext& view, const SearchState& search, const input::ShortcutManager& shortcutManager) const;
     void present() override;
     void shutdown() override;
 
     bool isWindowOpen() const override { return true; } // Console is always "open"
     void setStatusMessage(const std::string& message) override;
+    int getWidth() const { return width_; }
+    int getHeight() const { return height_; }
+    void invalidate() override { presenter_.invalidate(); }
     const FrameBuffer* getFrameBuffer() const { return frameBuffer_.get(); }
 
 private:
@@ -31,6 +39,8 @@ private:
     int height_ = 25;
     std::unique_ptr<FrameBuffer> frameBuffer_;
     std::unique_ptr<Viewport> viewport_;
+    TerminalPresenter presenter_;
+    LayoutGrid grid_;
 };
 
 } // namespace render
@@ -0,0 +1,63 @@
+#include "edge_lod.h"
+#include <algorithm>
+#include <cmath>
+#include <tuple>
+
+namespace render {
+
+EdgeLod::EdgeLod(float cellSize) : invCell_(1.0f / std::max(cellSize, 1e-3f)) {}
+
+size_t EdgeLod::CellPairHash::operator()(const CellPair& k) const {
+    uint64_t a = (static_cast<uint64_t>(static_cast<uint32_t>(k.ax)) << 32) | static_cast<uint32_t>(k.ay);
+    uint64_t b = (static_cast<uint64_t>(static_cast<uint32_t>(k.bx)) << 32) | static_cast<uint32_t>(k.by);
+    return std::hash<uint64_t>{}(a * 0x9E3779B97F4A7C15ULL ^ b);
+}
+
+bool EdgeLod::add(float x1, float y1, float x2, float y2) {
+    auto cellOf = [&](float v) {
+        return static_cast<int32_t>(std::clamp(std::floor(v * invCell_), -2147483648.0f, 2147483520.0f));
+    };
+    CellPair key{cellOf(x1), cellOf(y1), cellOf(x2), cellOf(y2)};
+    if (key.ax == key.bx && key.ay == key.by) {
+        ++skipped_;
+        return false;
+    }
+    // Orient each pair the same way so A->B and B->A share a bundle and draw identically.
+    if (std::tie(key.ay, key.ax) > std::tie(key.by, key.bx)) {
+        std::swap(key.ax, key.bx);
+        std::swap(key.ay, key.by);
+        std::swap(x1, x2);
+        std::swap(y1, y2);
+    }
+
+    auto [it, inserted] = index_.emplace(key, bundles_.size());
+    if (inserted) {
+        bundles_.push_back({x1, y1, x2, y2, 1});
+        return true;
+    }
+    // Running mean keeps the bundle centred on its members.
+    EdgeBundle& b = bundles_[it->second];
+    float n = static_cast<float>(++b.count);
+    b.x1 += (x1 - b.x1) / n;
+    b.y1 += (y1 - b.y1) / n;
+    b.x2 += (x2 - b.x2) / n;
+    b.y2 += (y2 - b.y2) / n;
+    return true;
+}
+
+float EdgeLod::cellSizeFor(ZoomLevel zoom) {
+    switch (zoom) {
+        case ZoomLevel::Z1: return 4.0f;
+        case ZoomLevel::Z2: return 2.0f;
+        default: return 1.0f;
+    }
+}
+
+char EdgeLod::glyphFor(int count) {
+    if (count >= 8) return '*';
+    if (count >= 4) return '+';
+    if (count >= 2) return ':';
+    return '.';
+}
+
+} // namespace render
@@ -0,0 +1,54 @@
+#ifndef EDGE_LOD_H
+#define EDGE_LOD_H
+
+#include "../map_logic.h"
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace render {
+
+// One drawn stand-in for every edge between the same pair of cells.
+struct EdgeBundle {
+    float x1, y1, x2, y2; // mean endpoints of the member edges
+    int count;
+};
+
+// Level-of-detail stage for edges. Coordinates are in the caller's output
+// space (screen cells, minimap cells, SVG pixels); edges whose endpoints land
+// in the same pair of cellSize-wide cells collapse into one bundle, and edges
+// that start and end in the same cell are dropped.
+class EdgeLod {
+public:
+    explicit EdgeLod(float cellSize);
+
+    // Returns false if the edge was too short to draw at this level.
+    bool add(float x1, float y1, float x2, float y2);
+    const std::vector<EdgeBundle>& bundles() const { return bundles_; }
+    size_t skipped() const { return skipped_; }
+
+    // Cell size in screen characters for a console zoom level.
+    static float cellSizeFor(ZoomLevel zoom);
+    // Density ramp for console and minimap bundles.
+    static char glyphFor(int count);
+
+private:
+    struct CellPair {
+        int32_t ax, ay, bx, by;
+        bool operator==(const CellPair& o) const {
+            return ax == o.ax && ay == o.ay && bx == o.bx && by == o.by;
+        }
+    };
+    struct CellPairHash {
+        size_t operator()(const CellPair& k) const;
+    };
+
+    float invCell_;
+    std::unordered_map<CellPair, size_t, CellPairHash> index_;
+    std::vector<EdgeBundle> bundles_;
+    size_t skipped_ = 0;
+};
+
+} // namespace render
+
+#endif // EDGE_LOD_H
@@ -1,44 +1,150 @@
 #include "frame_buffer.h"
-#include <iostream>
+#include "terminal_presenter.h"
 #include <algorithm>
+#include <cmath>
+#include <cstring>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 namespace render {
 
 FrameBuffer::FrameBuffer(int width, int height)
-    : width_(width), height_(height),
-      buffer_(height, std::string(width, ' ')),
-      depthBuffer_(height, std::vector<float>(width, std::numeric_limits<float>::infinity())) {}
+    : width_(std::max(width, 0)), height_(std::max(height, 0)),
+      cells_(static_cast<size_t>(width_) * height_, ' '),
+      depth_(static_cast<size_t>(width_) * height_, std::numeric_limits<float>::infinity()) {}
 
 void FrameBuffer::clear() {
-    for (auto& row : buffer_) {
-        std::fill(row.begin(), row.end(), ' ');
-    }
-    for (auto& row : depthBuffer_) {
-        std::fill(row.begin(), row.end(), std::numeric_limits<float>::infinity());
+    if (!cells_.empty()) std::memset(cells_.data(), ' ', cells_.size());
+
+    float* d = depth_.data();
+    size_t n = depth_.size(), i = 0;
+#if defined(__SSE2__)
+    const __m128 inf = _mm_set1_ps(std::numeric_limits<float>::infinity());
+    for (; i + 16 <= n; i += 16) {
+        _mm_storeu_ps(d + i, inf);
+        _mm_storeu_ps(d + i + 4, inf);
+        _mm_storeu_ps(d + i + 8, inf);
+        _mm_storeu_ps(d + i + 12, inf);
     }
+#endif
+    std::fill(d + i, d + n, std::numeric_limits<float>::infinity());
+
     title_.clear();
     statusMessage_.clear();
 }
 
 void FrameBuffer::drawChar(int x, int y, char c, float depth) {
-    if (x >= 0 && x < width_ && y >= 0 && y < height_) {
-        if (depth <= depthBuffer_[y][x]) {
-            buffer_[y][x] = c;
-            depthBuffer_[y][x] = depth;
+    if (static_cast<unsigned>(x) >= static_cast<unsigned>(width_) ||
+        static_cast<unsigned>(y) >= static_cast<unsigned>(height_)) {
+        return;
+    }
+    size_t i = static_cast<size_t>(y) * width_ + x;
+    if (depth <= depth_[i]) {
+        cells_[i] = c;
+        depth_[i] = depth;
+    }
+}
+
+void FrameBuffer::writeSpan(int y, int x0, int x1, const char* src, char c, float depth) {
+    size_t base = static_cast<size_t>(y) * width_;
+    char* cells = cells_.data() + base;
+    float* d = depth_.data() + base;
+    int x = x0;
+#if defined(__SSE2__)
+    const __m128 dv = _mm_set1_ps(depth);
+    for (; x + 4 <= x1; x += 4) {
+        __m128 old = _mm_loadu_ps(d + x);
+        __m128 pass = _mm_cmple_ps(dv, old);
+        int mask = _mm_movemask_ps(pass);
+        if (mask == 0) continue;
+        _mm_storeu_ps(d + x, _mm_or_ps(_mm_and_ps(pass, dv), _mm_andnot_ps(pass, old)));
+        if (mask == 0xF) {
+            if (src) std::memcpy(cells + x, src + (x - x0), 4);
+            else std::memset(cells + x, c, 4);
+        } else {
+            for (int k = 0; k < 4; ++k) {
+                if (mask & (1 << k)) cells[x + k] = src ? src[x - x0 + k] : c;
+            }
         }
     }
+#endif
+    for (; x < x1; ++x) {
+        if (depth <= d[x]) {
+            cells[x] = src ? src[x - x0] : c;
+            d[x] = depth;
+        }
+    }
+}
+
+void FrameBuffer::fillSpan(int x, int y, int length, char c, float depth) {
+    if (y < 0 || y >= height_ || length <= 0) return;
+    int x0 = std::max(x, 0);
+    int x1 = static_cast<int>(std::min<long long>(static_cast<long long>(x) + length, width_));
+    if (x0 < x1) writeSpan(y, x0, x1, nullptr, c, depth);
 }
 
 void FrameBuffer::drawString(int x, int y, const std::string& str, float depth) {
-    if (y < 0 || y >= height_) return;
-    for (size_t i = 0; i < str.length(); ++i) {
-        if (x + (int)i >= 0 && x + (int)i < width_) {
-            drawChar(x + i, y, str[i], depth);
+    if (y < 0 || y >= height_ || str.empty()) return;
+    int x0 = std::max(x, 0);
+    int x1 = static_cast<int>(std::min<long long>(static_cast<long long>(x) + str.size(), width_));
+    if (x0 < x1) writeSpan(y, x0, x1, str.data() + (x0 - x), ' ', depth);
+}
+
+// Cohen-Sutherland outcodes against [0, w) x [0, h).
+static int outCode(long long x, long long y, int w, int h) {
+    int code = 0;
+    if (x < 0) code |= 1;
+    else if (x >= w) code |= 2;
+    if (y < 0) code |= 4;
+    else if (y >= h) code |= 8;
+    return code;
+}
+
+// Clips the segment to the buffer. Returns false if nothing of it is visible.
+static bool clipLine(int& x1, int& y1, int& x2, int& y2, int w, int h) {
+    long long ax = x1, ay = y1, bx = x2, by = y2;
+    int codeA = outCode(ax, ay, w, h);
+    int codeB = outCode(bx, by, w, h);
+    // Rounding can push a clipped point just past a corner; a few passes always settle.
+    for (int pass = 0; codeA | codeB; ++pass) {
+        if ((codeA & codeB) || pass == 8) return false;
+        int out = codeA ? codeA : codeB;
+        long long x, y;
+        double dx = static_cast<double>(bx - ax), dy = static_cast<double>(by - ay);
+        if (out & 8) {
+            y = h - 1;
+            x = ax + std::llround(dx * (y - ay) / dy);
+        } else if (out & 4) {
+            y = 0;
+            x = ax + std::llround(dx * (y - ay) / dy);
+        } else if (out & 2) {
+            x = w - 1;
+            y = ay + std::llround(dy * (x - ax) / dx);
+        } else {
+            x = 0;
+            y = ay + std::llround(dy * (x - ax) / dx);
+        }
+        if (out == codeA) {
+            ax = x; ay = y;
+            codeA = outCode(ax, ay, w, h);
+        } else {
+            bx = x; by = y;
+            codeB = outCode(bx, by, w, h);
         }
     }
+    x1 = static_cast<int>(ax); y1 = static_cast<int>(ay);
+    x2 = static_cast<int>(bx); y2 = static_cast<int>(by);
+    return true;
 }
 
 void FrameBuffer::drawLine(int x1, int y1, int x2, int y2, char c, float depth) {
+    if (!clipLine(x1, y1, x2, y2, width_, height_)) return;
+    if (y1 == y2) {
+        fillSpan(std::min(x1, x2), y1, std::abs(x2 - x1) + 1, c, depth);
+        return;
+    }
+
     int dx = std::abs(x2 - x1);
     int dy = std::abs(y2 - y1);
     int sx = (x1 < x2) ? 1 : -1;
@@ -61,13 +167,14 @@ void FrameBuffer::drawLine(int x1, int y1, int x2, int y2, char c, float depth)
 }
 
 void FrameBuffer::drawRect(int x, int y, int w, int h, char c, float depth) {
-    for (int i = 0; i < w; ++i) {
-        drawChar(x + i, y, c, depth);
-        drawChar(x + i, y + h - 1, c, depth);
-    }
-    for (int i = 1; i < h - 1; ++i) {
-        drawChar(x, y + i, c, depth);
-        drawChar(x + w - 1, y + i, c, depth);
+    fillSpan(x, y, w, c, depth);
+    fillSpan(x, y + h - 1, w, c, depth);
+    if (w <= 0) return;
+    int top = std::max(y + 1, 0);
+    int bottom = std::min(y + h - 1, height_);
+    for (int row = top; row < bottom; ++row) {
+        drawChar(x, row, c, depth);
+        drawChar(x + w - 1, row, c, depth);
     }
 }
 
@@ -80,23 +187,7 @@ void FrameBuffer::setStatusMessage(const std::string& message) {
 }
 
 void FrameBuffer::present() const {
-#ifdef _WIN32
-    // For Windows, we might want to use a more efficient way to avoid flicker
-    system("cls");
-#else
-    // ANSI escape code to move cursor to top-left (0,0) and clear screen
-    std::cout << "\033[H\033[J";
-#endif
-
-    if (!title_.empty()) {
-        std::cout << "=== " << title_ << " ===\n";
-    }
-    for (const auto& row : buffer_) {
-        std::cout << row << "\n";
-    }
-    if (!statusMessage_.empty()) {
-        std::cout << "Status: " << statusMessage_ << "\n";
-    }
+    TerminalPresenter().present(*this);
 }
 
 } // namespace render
@@ -3,10 +3,13 @@
 
 #include <vector>
 #include <string>
+#include <string_view>
 #include <limits>
 
 namespace render {
 
+// Character cells and their depth values live in two flat row-major planes
+// (width * height), so a row is one contiguous span in each.
 class FrameBuffer {
 public:
     FrameBuffer(int width, int height);
@@ -16,22 +19,30 @@ public:
     void drawString(int x, int y, const std::string& str, float depth = 0.0f);
     void drawLine(int x1, int y1, int x2, int y2, char c, float depth = 0.0f);
     void drawRect(int x, int y, int w, int h, char c, float depth = 0.0f);
+    void fillSpan(int x, int y, int length, char c, float depth = 0.0f);
 
     void setTitle(const std::string& title);
     void setStatusMessage(const std::string& message);
-    void present() const;
+    void present() const; // full redraw; see TerminalPresenter for incremental output
 
     int getWidth() const { return width_; }
     int getHeight() const { return height_; }
-    const std::vector<std::string>& getBuffer() const { return buffer_; }
+    std::string_view getRow(int y) const {
+        return std::string_view(cells_.data() + static_cast<size_t>(y) * width_, width_);
+    }
+    float getDepth(int x, int y) const { return depth_[static_cast<size_t>(y) * width_ + x]; }
     const std::string& getTitle() const { return title_; }
     const std::string& getStatusMessage() const { return statusMessage_; }
 
 private:
+    // Depth-tested write of cells [x0, x1) on row y, already clipped. Copies
+    // from src when given, otherwise fills with c.
+    void writeSpan(int y, int x0, int x1, const char* src, char c, float depth);
+
     int width_;
     int height_;
-    std::vector<std::string> buffer_;
-    std::vector<std::vector<float>> depthBuffer_;
+    std::vector<char> cells_;
+    std::vector<float> depth_;
     std::string title_;
     std::string statusMessage_;
 };
@@ -0,0 +1,114 @@
+#include "label_placer.h"
+#include <algorithm>
+#include <bitset>
+#include <string>
+
+namespace render {
+
+namespace {
+
+// Bits [from, to) of a 64-bit word.
+inline uint64_t bitRange(int from, int to) {
+    uint64_t hi = (to >= 64) ? ~0ULL : ((1ULL << to) - 1);
+    return hi & ~((1ULL << from) - 1);
+}
+
+} // namespace
+
+LabelPlacer::LabelPlacer(int width, int height)
+    : width_(std::max(0, width)), height_(std::max(0, height)),
+      wordsPerRow_((width_ + 63) / 64),
+      bits_(static_cast<size_t>(wordsPerRow_) * height_, 0),
+      freeCells_(static_cast<long>(width_) * height_) {}
+
+bool LabelPlacer::isOccupied(int x, int y) const {
+    if (x < 0 || x >= width_ || y < 0 || y >= height_) return true;
+    return (bits_[static_cast<size_t>(y) * wordsPerRow_ + x / 64] >> (x % 64)) & 1ULL;
+}
+
+bool LabelPlacer::spanFree(int x, int y, int len) const {
+    if (len <= 0 || y < 0 || y >= height_ || x < 0 || x + len > width_) return false;
+    const uint64_t* row = &bits_[static_cast<size_t>(y) * wordsPerRow_];
+    int end = x + len;
+    for (int w = x / 64; w * 64 < end; ++w) {
+        int from = std::max(x - w * 64, 0);
+        int to = std::min(end - w * 64, 64);
+        if (row[w] & bitRange(from, to)) return false;
+    }
+    return true;
+}
+
+void LabelPlacer::markSpan(int x, int y, int len) {
+    if (y < 0 || y >= height_) return;
+    int x0 = std::max(x, 0);
+    int x1 = std::min(x + len, width_);
+    uint64_t* row = &bits_[static_cast<size_t>(y) * wordsPerRow_];
+    for (int w = x0 / 64; w * 64 < x1; ++w) {
+        uint64_t mask = bitRange(std::max(x0 - w * 64, 0), std::min(x1 - w * 64, 64));
+        freeCells_ -= static_cast<long>(std::bitset<64>(mask & ~row[w]).count());
+        row[w] |= mask;
+    }
+}
+
+int LabelPlacer::freeRunFrom(int x, int y, int maxLen) const {
+    int run = 0;
+    while (run < maxLen && !isOccupied(x + run, y)) ++run;
+    return run;
+}
+
+void LabelPlacer::reserve(int x, int y, int w, int h) {
+    for (int row = y; row < y + h; ++row) markSpan(x, row, w);
+}
+
+int LabelPlacer::place(FrameBuffer& fb) {
+    std::sort(candidates_.begin(), candidates_.end(), [](const Candidate& a, const Candidate& b) {
+        if (a.tier != b.tier) return a.tier > b.tier;
+        if (a.focusDistance != b.focusDistance) return a.focusDistance < b.focusDistance;
+        if (a.weight != b.weight) return a.weight > b.weight;
+        return a.order < b.order;
+    });
+
+    int placed = 0;
+    for (const auto& c : candidates_) {
+        if (freeCells_ <= 0) break;
+        int len = static_cast<int>(c.text.size());
+        if (len == 0) continue;
+
+        // Node box spans [x - size/2, x - size/2 + size).
+        int left = c.x - c.size / 2;
+        int top = c.y - c.size / 2;
+        const int anchors[][2] = {
+            {c.x + c.size / 2 + 1, c.y + c.size / 2 + 1}, // below right
+            {left + c.size + 1, c.y},                     // right
+            {left - 1 - len, c.y},                        // left
+            {c.x - len / 2, top - 1},                     // above
+            {c.x - len / 2, top + c.size},                // below
+        };
+
+        int ax = 0, ay = 0, fit = 0;
+        for (const auto& a : anchors) {
+            if (spanFree(a[0], a[1], len)) {
+                ax = a[0];
+                ay = a[1];
+                fit = len;
+                break;
+            }
+        }
+        // Nothing fits whole: keep a truncated label at the primary anchor.
+        if (fit == 0) {
+            int run = freeRunFrom(anchors[0][0], anchors[0][1], len);
+            if (run < 3) continue;
+            ax = anchors[0][0];
+            ay = anchors[0][1];
+            fit = run;
+        }
+
+        fb.drawString(ax, ay, std::string(c.text.substr(0, fit)), c.depth);
+        markSpan(ax, ay, fit);
+        ++placed;
+    }
+    candidates_.clear();
+    return placed;
+}
+
+} // namespace render
@@ -0,0 +1,52 @@
+#ifndef LABEL_PLACER_H
+#define LABEL_PLACER_H
+
+#include "frame_buffer.h"
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace render {
+
+// Greedy screen-space label placement. Node boxes are reserved first, then
+// labels are placed in priority order at the first free anchor around their
+// node, so labels never overwrite nodes or each other. Placement stops once
+// the occupancy bitmap is full, bounding the work by screen area.
+class LabelPlacer {
+public:
+    struct Candidate {
+        int x, y;          // node center in screen cells
+        int size;          // node box size
+        std::string_view text; // must outlive place()
+        float depth;
+        int tier;          // higher places first (focus, active match, ...)
+        int focusDistance; // lower places first
+        int weight;        // higher places first
+        int order;         // tie-break, usually draw order
+    };
+
+    LabelPlacer(int width, int height);
+
+    void reserve(int x, int y, int w, int h);
+    void add(const Candidate& candidate) { candidates_.push_back(candidate); }
+
+    // Draws every label that fits; returns how many were placed.
+    int place(FrameBuffer& fb);
+
+    bool isOccupied(int x, int y) const;
+
+private:
+    bool spanFree(int x, int y, int len) const;
+    void markSpan(int x, int y, int len);
+    int freeRunFrom(int x, int y, int maxLen) const;
+
+    int width_, height_;
+    int wordsPerRow_;
+    std::vector<uint64_t> bits_;
+    long freeCells_;
+    std::vector<Candidate> candidates_;
+};
+
+} // namespace render
+
+#endif // LABEL_PLACER_H
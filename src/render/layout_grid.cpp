@@ -0,0 +1,199 @@
+#include "layout_grid.h"
+#include <algorithm>
+#include <cmath>
+#include <unordered_set>
+
+namespace render {
+
+namespace {
+
+// Edges whose bounding box covers more cells than this are checked on every query.
+constexpr int kMaxEdgeCells = 64;
+constexpr int kMaxGridSide = 1024;
+
+} // namespace
+
+void LayoutGrid::update(const Graph& graph) {
+    if (revision_ != 0 && revision_ == graph.layoutRevision &&
+        nodeCountKey_ == graph.nodes.size() && positionCountKey_ == graph.layoutPositions.size()) {
+        return;
+    }
+    build(graph);
+    revision_ = graph.layoutRevision;
+    nodeCountKey_ = graph.nodes.size();
+    positionCountKey_ = graph.layoutPositions.size();
+}
+
+// Clamps before converting so far-off query bounds cannot overflow int.
+static int toCell(float offset, float invSize, int count) {
+    float f = offset * invSize;
+    if (!(f > 0.0f)) return 0;
+    if (f >= static_cast<float>(count)) return count - 1;
+    return static_cast<int>(f);
+}
+
+int LayoutGrid::cellX(float x) const {
+    return toCell(x - originX_, invCellW_, cols_);
+}
+
+int LayoutGrid::cellY(float y) const {
+    return toCell(y - originY_, invCellH_, rows_);
+}
+
+void LayoutGrid::build(const Graph& graph) {
+    ++builds_;
+    nodes_.clear();
+    edges_.clear();
+    longEdges_.clear();
+    maxLabelLength_ = 0;
+    minDepth_ = 0.0f;
+
+    std::unordered_map<int, int> entryOf;
+    entryOf.reserve(graph.layoutPositions.size());
+    for (size_t slot = 0; slot < graph.nodes.size(); ++slot) {
+        const auto& node = graph.nodes[slot];
+        auto pos = graph.layoutPositions.find(node.index);
+        if (pos == graph.layoutPositions.end()) continue;
+        entryOf.emplace(node.index, static_cast<int>(nodes_.size()));
+        nodes_.push_back({static_cast<int>(slot), pos->second.x, pos->second.y});
+        maxLabelLength_ = std::max(maxLabelLength_, static_cast<int>(node.label.size()));
+        auto depth = graph.nodePos.find(node.index);
+        if (depth != graph.nodePos.end()) minDepth_ = std::min(minDepth_, depth->second.z);
+    }
+    // Neighbor lists are symmetric; keep each undirected edge once, in first-seen orientation.
+    std::unordered_set<uint64_t> seen;
+    for (const auto& entry : nodes_) {
+        int from = entryOf[graph.nodes[entry.slot].index];
+        for (int neighbor : graph.nodes[entry.slot].neighbors) {
+            auto to = entryOf.find(neighbor);
+            if (to == entryOf.end()) continue;
+            uint64_t lo = static_cast<uint32_t>(std::min(from, to->second));
+            uint64_t hi = static_cast<uint32_t>(std::max(from, to->second));
+            if (seen.insert(lo << 32 | hi).second) edges_.push_back({from, to->second});
+        }
+    }
+
+    float minX = 0, minY = 0, maxX = 0, maxY = 0;
+    if (!nodes_.empty()) {
+        minX = maxX = nodes_[0].x;
+        minY = maxY = nodes_[0].y;
+        for (const auto& n : nodes_) {
+            minX = std::min(minX, n.x); maxX = std::max(maxX, n.x);
+            minY = std::min(minY, n.y); maxY = std::max(maxY, n.y);
+        }
+    }
+    int side = std::clamp(static_cast<int>(std::sqrt(static_cast<double>(nodes_.size()))), 1, kMaxGridSide);
+    cols_ = rows_ = side;
+    originX_ = minX;
+    originY_ = minY;
+    invCellW_ = cols_ / std::max(maxX - minX, 1e-3f);
+    invCellH_ = rows_ / std::max(maxY - minY, 1e-3f);
+    size_t cellCount = static_cast<size_t>(cols_) * rows_;
+
+    // Counting sort of nodes into cells.
+    nodeCellStart_.assign(cellCount + 1, 0);
+    std::vector<uint32_t> nodeCell(nodes_.size());
+    for (size_t i = 0; i < nodes_.size(); ++i) {
+        nodeCell[i] = static_cast<uint32_t>(cellY(nodes_[i].y) * cols_ + cellX(nodes_[i].x));
+        ++nodeCellStart_[nodeCell[i] + 1];
+    }
+    for (size_t c = 0; c < cellCount; ++c) nodeCellStart_[c + 1] += nodeCellStart_[c];
+    nodeCellItems_.resize(nodes_.size());
+    {
+        std::vector<uint32_t> fill(nodeCellStart_.begin(), nodeCellStart_.end() - 1);
+        for (size_t i = 0; i < nodes_.size(); ++i) nodeCellItems_[fill[nodeCell[i]]++] = static_cast<uint32_t>(i);
+    }
+
+    // Edges go into every cell their bounding box covers, unless that is too many.
+    edgeCellStart_.assign(cellCount + 1, 0);
+    auto forEachEdgeCell = [&](const EdgeEntry& e, auto&& fn) {
+        const NodeEntry& a = nodes_[e.from];
+        const NodeEntry& b = nodes_[e.to];
+        int c0 = cellX(std::min(a.x, b.x)), c1 = cellX(std::max(a.x, b.x));
+        int r0 = cellY(std::min(a.y, b.y)), r1 = cellY(std::max(a.y, b.y));
+        for (int r = r0; r <= r1; ++r) {
+            for (int c = c0; c <= c1; ++c) fn(static_cast<size_t>(r) * cols_ + c);
+        }
+    };
+    auto cellSpan = [&](const EdgeEntry& e) {
+        const NodeEntry& a = nodes_[e.from];
+        const NodeEntry& b = nodes_[e.to];
+        long long w = std::abs(cellX(a.x) - cellX(b.x)) + 1;
+        long long h = std::abs(cellY(a.y) - cellY(b.y)) + 1;
+        return w * h;
+    };
+    std::vector<bool> isLong(edges_.size());
+    for (size_t i = 0; i < edges_.size(); ++i) {
+        if (cellSpan(edges_[i]) > kMaxEdgeCells) {
+            isLong[i] = true;
+            longEdges_.push_back(static_cast<int>(i));
+            continue;
+        }
+        forEachEdgeCell(edges_[i], [&](size_t cell) { ++edgeCellStart_[cell + 1]; });
+    }
+    for (size_t c = 0; c < cellCount; ++c) edgeCellStart_[c + 1] += edgeCellStart_[c];
+    edgeCellItems_.resize(edgeCellStart_[cellCount]);
+    {
+        std::vector<uint32_t> fill(edgeCellStart_.begin(), edgeCellStart_.end() - 1);
+        for (size_t i = 0; i < edges_.size(); ++i) {
+            if (isLong[i]) continue;
+            forEachEdgeCell(edges_[i], [&](size_t cell) { edgeCellItems_[fill[cell]++] = static_cast<uint32_t>(i); });
+        }
+    }
+
+    edgeStamp_.assign(edges_.size(), 0);
+    stamp_ = 0;
+}
+
+void LayoutGrid::queryNodes(float minX, float minY, float maxX, float maxY, std::vector<int>& out) const {
+    out.clear();
+    if (nodes_.empty() || maxX < minX || maxY < minY) return;
+    int c0 = cellX(minX), c1 = cellX(maxX);
+    int r0 = cellY(minY), r1 = cellY(maxY);
+    for (int r = r0; r <= r1; ++r) {
+        for (int c = c0; c <= c1; ++c) {
+            size_t cell = static_cast<size_t>(r) * cols_ + c;
+            for (uint32_t k = nodeCellStart_[cell]; k < nodeCellStart_[cell + 1]; ++k) {
+                const NodeEntry& n = nodes_[nodeCellItems_[k]];
+                if (n.x >= minX && n.x <= maxX && n.y >= minY && n.y <= maxY) out.push_back(nodeCellItems_[k]);
+            }
+        }
+    }
+    std::sort(out.begin(), out.end());
+}
+
+void LayoutGrid::queryEdges(float minX, float minY, float maxX, float maxY, std::vector<int>& out) const {
+    out.clear();
+    if (edges_.empty() || maxX < minX || maxY < minY) return;
+    if (++stamp_ == 0) {
+        std::fill(edgeStamp_.begin(), edgeStamp_.end(), 0);
+        stamp_ = 1;
+    }
+
+    auto overlaps = [&](const EdgeEntry& e) {
+        const NodeEntry& a = nodes_[e.from];
+        const NodeEntry& b = nodes_[e.to];
+        return std::max(a.x, b.x) >= minX && std::min(a.x, b.x) <= maxX &&
+               std::max(a.y, b.y) >= minY && std::min(a.y, b.y) <= maxY;
+    };
+
+    int c0 = cellX(minX), c1 = cellX(maxX);
+    int r0 = cellY(minY), r1 = cellY(maxY);
+    for (int r = r0; r <= r1; ++r) {
+        for (int c = c0; c <= c1; ++c) {
+            size_t cell = static_cast<size_t>(r) * cols_ + c;
+            for (uint32_t k = edgeCellStart_[cell]; k < edgeCellStart_[cell + 1]; ++k) {
+                uint32_t id = edgeCellItems_[k];
+                if (edgeStamp_[id] == stamp_) continue;
+                edgeStamp_[id] = stamp_;
+                if (overlaps(edges_[id])) out.push_back(static_cast<int>(id));
+            }
+        }
+    }
+    for (int id : longEdges_) {
+        if (overlaps(edges_[id])) out.push_back(id);
+    }
+    std::sort(out.begin(), out.end());
+}
+
+} // namespace render
@@ -0,0 +1,70 @@
+#ifndef LAYOUT_GRID_H
+#define LAYOUT_GRID_H
+
+#include "../map_logic.h"
+#include <cstdint>
+#include <vector>
+
+namespace render {
+
+// Uniform 2D grid over Graph::layoutPositions, used to cull nodes and edges
+// against the visible rectangle. Entries are numbered in the renderer's draw
+// order (graph.nodes order, then each node's neighbor order, each undirected
+// edge once), and queries return ids in that order.
+class LayoutGrid {
+public:
+    struct NodeEntry {
+        int slot; // index into graph.nodes
+        float x, y;
+    };
+
+    struct EdgeEntry {
+        int from, to; // node entry ids
+    };
+
+    // Rebuilds the grid if the graph's layout changed since the last update.
+    void update(const Graph& graph);
+    void invalidate() { revision_ = 0; }
+
+    void queryNodes(float minX, float minY, float maxX, float maxY, std::vector<int>& out) const;
+    // Returns every edge whose bounding box may overlap the rectangle.
+    void queryEdges(float minX, float minY, float maxX, float maxY, std::vector<int>& out) const;
+
+    const NodeEntry& node(int id) const { return nodes_[id]; }
+    const EdgeEntry& edge(int id) const { return edges_[id]; }
+    size_t nodeCount() const { return nodes_.size(); }
+    size_t edgeCount() const { return edges_.size(); }
+    int maxLabelLength() const { return maxLabelLength_; }
+    float minDepth() const { return minDepth_; }
+    uint64_t buildCount() const { return builds_; }
+
+private:
+    void build(const Graph& graph);
+    int cellX(float x) const;
+    int cellY(float y) const;
+
+    uint64_t revision_ = 0;
+    uint64_t builds_ = 0;
+    size_t nodeCountKey_ = 0;
+    size_t positionCountKey_ = 0;
+
+    std::vector<NodeEntry> nodes_;
+    std::vector<EdgeEntry> edges_;
+    int maxLabelLength_ = 0;
+    float minDepth_ = 0.0f;
+
+    float originX_ = 0.0f, originY_ = 0.0f;
+    float invCellW_ = 1.0f, invCellH_ = 1.0f;
+    int cols_ = 1, rows_ = 1;
+    // Cell contents in CSR form: items of cell c are [start[c], start[c + 1]).
+    std::vector<uint32_t> nodeCellStart_, nodeCellItems_;
+    std::vector<uint32_t> edgeCellStart_, edgeCellItems_;
+    std::vector<int> longEdges_; // spans too many cells to bucket
+
+    mutable std::vector<uint32_t> edgeStamp_;
+    mutable uint32_t stamp_ = 0;
+};
+
+} // namespace render
+
+#endif // LAYOUT_GRID_H
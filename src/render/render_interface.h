@@ -17,6 +17,9 @@ public:
 
     virtual bool isWindowOpen() const = 0;
     virtual void setStatusMessage(const std::string& message) = 0;
+
+    // Forces the next present() to redraw everything, e.g. after other output.
+    virtual void invalidate() {}
 };
 
 } // namespace render
@@ -0,0 +1,198 @@
+#include "render_pipeline.h"
+#include "layout/layout_manager.h"
+#include <algorithm>
+
+namespace render {
+
+RenderPipeline::RenderPipeline(const ConsoleRenderer& renderer, const input::ShortcutManager& shortcuts,
+                               int targetFps, bool presentToTerminal)
+    : renderer_(renderer), shortcuts_(shortcuts),
+      frameInterval_(std::chrono::nanoseconds(1000000000LL / std::max(targetFps, 1))),
+      presentToTerminal_(presentToTerminal) {
+    buffers_[0] = std::make_unique<FrameBuffer>(renderer.getWidth(), renderer.getHeight());
+    buffers_[1] = std::make_unique<FrameBuffer>(renderer.getWidth(), renderer.getHeight());
+}
+
+RenderPipeline::~RenderPipeline() {
+    stop();
+}
+
+void RenderPipeline::start() {
+    std::lock_guard<std::mutex> lock(stateMutex_);
+    if (running_) return;
+    running_ = true;
+    thread_ = std::thread(&RenderPipeline::renderLoop, this);
+}
+
+void RenderPipeline::stop() {
+    {
+        std::lock_guard<std::mutex> lock(stateMutex_);
+        running_ = false;
+    }
+    stateCond_.notify_all();
+    if (thread_.joinable()) thread_.join();
+}
+
+RenderPipeline::GraphKey RenderPipeline::GraphKey::of(const Graph& graph) {
+    return {graph.layoutRevision, graph.focusedNodeIndices, graph.focusedNodeIndex,
+            graph.subjectFilterOnly, graph.focusOnlyAtMaxZoom, graph.showLines};
+}
+
+bool RenderPipeline::GraphKey::operator==(const GraphKey& other) const {
+    return layoutRevision == other.layoutRevision && focusedNodeIndices == other.focusedNodeIndices &&
+           focusedNodeIndex == other.focusedNodeIndex && subjectFilterOnly == other.subjectFilterOnly &&
+           focusOnlyAtMaxZoom == other.focusOnlyAtMaxZoom && showLines == other.showLines;
+}
+
+void RenderPipeline::submit(const Graph& graph, const ViewContext& view, const SearchState& search) {
+    auto snapshot = std::make_unique<Snapshot>();
+    GraphKey key = GraphKey::of(graph);
+    if (graph.needsLayoutReset || !submittedKey_ || !(*submittedKey_ == key)) {
+        snapshot->graph = std::make_unique<Graph>(graph);
+        submittedKey_ = std::make_unique<GraphKey>(std::move(key));
+        graphCopies_.fetch_add(1);
+    }
+    snapshot->view = view;
+    snapshot->search = search;
+
+    std::lock_guard<std::mutex> lock(stateMutex_);
+    if (pending_ && pending_->graph) {
+        // A graph the render thread has not seen yet stays unless replaced, and
+        // so does a reset request.
+        if (!snapshot->graph) snapshot->graph = std::move(pending_->graph);
+        else if (pending_->graph->needsLayoutReset) snapshot->graph->needsLayoutReset = true;
+    }
+    pending_ = std::move(snapshot);
+}
+
+void RenderPipeline::setStatusMessage(const std::string& message) {
+    std::lock_guard<std::mutex> lock(stateMutex_);
+    statusMessage_ = message;
+    statusChanged_ = true;
+}
+
+void RenderPipeline::suspend() {
+    {
+        std::lock_guard<std::mutex> lock(stateMutex_);
+        suspended_ = true;
+    }
+    std::lock_guard<std::mutex> frameLock(frameMutex_);
+    drawFrame(true);
+}
+
+void RenderPipeline::resume() {
+    {
+        std::lock_guard<std::mutex> frameLock(frameMutex_);
+        presenter_.invalidate();
+    }
+    std::lock_guard<std::mutex> lock(stateMutex_);
+    suspended_ = false;
+    statusChanged_ = true; // forces the redraw even when nothing else changed
+}
+
+bool RenderPipeline::waitForFrame(std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(stateMutex_);
+    uint64_t seen = framesPresented_.load();
+    return stateCond_.wait_for(lock, timeout, [&]() { return framesPresented_.load() > seen; });
+}
+
+FrameBuffer RenderPipeline::frontBuffer() const {
+    std::lock_guard<std::mutex> lock(frontMutex_);
+    return *buffers_[front_];
+}
+
+void RenderPipeline::renderLoop() {
+    auto next = std::chrono::steady_clock::now();
+    std::unique_lock<std::mutex> lock(stateMutex_);
+    while (running_) {
+        stateCond_.wait_until(lock, next, [&]() { return !running_; });
+        if (!running_) break;
+        lock.unlock();
+        {
+            std::lock_guard<std::mutex> frameLock(frameMutex_);
+            drawFrame(false);
+        }
+        lock.lock();
+
+        // Fixed cadence; a frame that overran skips ahead instead of bursting.
+        next += frameInterval_;
+        auto now = std::chrono::steady_clock::now();
+        if (next < now) next = now;
+    }
+}
+
+void RenderPipeline::drawFrame(bool force) {
+    std::string status;
+    bool changed = force;
+    {
+        std::lock_guard<std::mutex> lock(stateMutex_);
+        if (suspended_ && !force) return;
+        if (pending_) {
+            if (!pending_->graph) {
+                if (working_) pending_->graph = std::move(working_->graph);
+            } else {
+                uint64_t source = pending_->graph->layoutRevision;
+                if (working_ && !pending_->graph->needsLayoutReset) carryLayout(*working_->graph, *pending_->graph);
+                sourceRevision_ = source;
+            }
+            if (pending_->graph) {
+                working_ = std::move(pending_);
+                changed = true;
+            }
+            pending_.reset();
+        }
+        if (statusChanged_) {
+            statusChanged_ = false;
+            changed = true;
+        }
+        status = statusMessage_;
+    }
+    if (!working_) return;
+
+    // Force-directed layout animates on its own; everything else only redraws on change.
+    ViewMode mode = working_->view.currentViewMode;
+    if (!changed && mode != VM_NEXUS_FLOW) return;
+
+    auto start = std::chrono::steady_clock::now();
+    if (mode == VM_PERSPECTIVE) {
+        layout::LayoutManager::applyPerspectiveBFS(*working_->graph, working_->view);
+    } else if (mode == VM_NEXUS_FLOW) {
+        layout::LayoutManager::applyForceDirected(*working_->graph, working_->view);
+    }
+
+    FrameBuffer& back = *buffers_[1 - front_];
+    back.clear();
+    renderer_.renderFrame(back, grid_, *working_->graph, working_->view, working_->search, shortcuts_);
+    gridBuilds_.store(grid_.buildCount());
+    back.setStatusMessage(status);
+    {
+        std::lock_guard<std::mutex> lock(frontMutex_);
+        front_ = 1 - front_;
+    }
+    if (presentToTerminal_) presenter_.present(*buffers_[front_]);
+
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    working_->graph->summary.timeToRenderMs = ms;
+    lastFrameMs_.store(ms);
+    {
+        std::lock_guard<std::mutex> lock(stateMutex_);
+        framesPresented_.fetch_add(1);
+    }
+    stateCond_.notify_all();
+}
+
+// The submitted copy's layoutDirty is never cleared on the input side, so it
+// says nothing; compare against the previous snapshot instead. Unchanged
+// nodes, edges and focus keep the layout and its revision, so the grid and the
+// BFS layout are not rebuilt for a pan.
+void RenderPipeline::carryLayout(Graph& from, Graph& to) {
+    bool structureChanged = to.layoutRevision != sourceRevision_;
+    bool focusChanged = to.focusedNodeIndices != from.focusedNodeIndices;
+    to.layoutPositions = std::move(from.layoutPositions);
+    to.nodePos = std::move(from.nodePos);
+    to.layoutDirty = from.layoutDirty || structureChanged || focusChanged;
+    if (structureChanged) to.touchLayout();
+    else to.layoutRevision = from.layoutRevision;
+}
+
+} // namespace render
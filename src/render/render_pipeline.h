@@ -0,0 +1,126 @@
+#ifndef RENDER_PIPELINE_H
+#define RENDER_PIPELINE_H
+
+#include "console_renderer.h"
+#include "frame_buffer.h"
+#include "layout_grid.h"
+#include "terminal_presenter.h"
+#include "../map_logic.h"
+#include "../search_logic.h"
+#include "../input/shortcut_manager.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+
+namespace render {
+
+// Runs layout and rendering on a dedicated thread so the input loop never
+// waits on a frame. The input thread publishes snapshots with submit(); the
+// render thread lays out its own copy of the graph, draws into the back
+// buffer and swaps it to the front at the target frame rate.
+class RenderPipeline {
+public:
+    RenderPipeline(const ConsoleRenderer& renderer, const input::ShortcutManager& shortcuts,
+                   int targetFps = 30, bool presentToTerminal = true);
+    ~RenderPipeline();
+
+    void start();
+    void stop();
+
+    // Copies the state to draw. The graph is copied only when its nodes, edges,
+    // focus or display toggles changed since the last submit; a pan sends just
+    // the view and search. A snapshot with needsLayoutReset discards the layout
+    // the render thread has accumulated; otherwise positions and their revision
+    // carry over, and are only recomputed when nodes, edges or the focus changed.
+    // Call from one thread.
+    void submit(const Graph& graph, const ViewContext& view, const SearchState& search);
+    void setStatusMessage(const std::string& message);
+
+    // Presents the latest state from the calling thread and stops the render
+    // thread from drawing, so the caller may use the terminal (prompts, overlays).
+    void suspend();
+    // Resumes drawing with a full redraw.
+    void resume();
+
+    // Blocks until a frame has been presented after this call or the timeout expires.
+    bool waitForFrame(std::chrono::milliseconds timeout);
+
+    double lastFrameMs() const { return lastFrameMs_.load(); }
+    uint64_t framesPresented() const { return framesPresented_.load(); }
+    // Times the culling grid was rebuilt because the layout changed.
+    uint64_t gridBuilds() const { return gridBuilds_.load(); }
+    // Submits that copied the graph.
+    uint64_t graphCopies() const { return graphCopies_.load(); }
+
+    // Copy of the most recently swapped front buffer.
+    FrameBuffer frontBuffer() const;
+
+private:
+    struct Snapshot {
+        std::unique_ptr<Graph> graph; // null when unchanged since the previous snapshot
+        ViewContext view;
+        SearchState search;
+    };
+
+    // What the render thread's copy of the graph depends on, besides node and
+    // edge contents (covered by layoutRevision).
+    struct GraphKey {
+        uint64_t layoutRevision = 0;
+        std::set<int> focusedNodeIndices;
+        int focusedNodeIndex = 0;
+        bool subjectFilterOnly = false;
+        bool focusOnlyAtMaxZoom = false;
+        bool showLines = false;
+
+        static GraphKey of(const Graph& graph);
+        bool operator==(const GraphKey& other) const;
+    };
+
+    void renderLoop();
+    // Caller holds frameMutex_.
+    void drawFrame(bool force);
+    // Caller holds stateMutex_ and frameMutex_.
+    void carryLayout(Graph& from, Graph& to);
+
+    const ConsoleRenderer& renderer_;
+    const input::ShortcutManager& shortcuts_;
+    std::chrono::nanoseconds frameInterval_;
+    bool presentToTerminal_;
+
+    // Only touched by the submitting thread.
+    std::unique_ptr<GraphKey> submittedKey_;
+
+    // Guarded by stateMutex_.
+    mutable std::mutex stateMutex_;
+    std::condition_variable stateCond_;
+    std::unique_ptr<Snapshot> pending_;
+    std::string statusMessage_;
+    bool statusChanged_ = false;
+    bool running_ = false;
+    bool suspended_ = false;
+
+    // Guarded by frameMutex_; only the thread drawing a frame touches these.
+    std::mutex frameMutex_;
+    std::unique_ptr<Snapshot> working_;
+    uint64_t sourceRevision_ = 0; // layoutRevision of the submitted graph behind working_
+    std::unique_ptr<FrameBuffer> buffers_[2];
+    int front_ = 0;
+    TerminalPresenter presenter_;
+    LayoutGrid grid_;
+
+    mutable std::mutex frontMutex_;
+    std::atomic<double> lastFrameMs_{0.0};
+    std::atomic<uint64_t> framesPresented_{0};
+    std::atomic<uint64_t> gridBuilds_{0};
+    std::atomic<uint64_t> graphCopies_{0};
+    std::thread thread_;
+};
+
+} // namespace render
+
+#endif // RENDER_PIPELINE_H
@@ -1,76 +1,406 @@
 #include "spatial_index.h"
+#include <algorithm>
+#include <numeric>
 
 namespace render {
 
-void OctreeIndex::insert(int nodeId, float x, float y, float z) {
-    if (!contains(bounds_, x, y, z)) return;
+namespace {
 
-    if (subdivided_) {
-        for (int i = 0; i < 8; ++i) {
-            children_[i]->insert(nodeId, x, y, z);
-        }
-        return;
+constexpr uint32_t kCells = 1u << 21;
+
+// Spreads the low 21 bits of v so they occupy every third bit.
+uint64_t spreadBits(uint32_t v) {
+    uint64_t x = v & 0x1fffffu;
+    x = (x | (x << 32)) & 0x1f00000000ffffULL;
+    x = (x | (x << 16)) & 0x1f0000ff0000ffULL;
+    x = (x | (x << 8)) & 0x100f00f00f00f00fULL;
+    x = (x | (x << 4)) & 0x10c30c30c30c30c3ULL;
+    x = (x | (x << 2)) & 0x1249249249249249ULL;
+    return x;
+}
+
+uint32_t toCell(float v, float origin, float scale) {
+    float t = (v - origin) * scale;
+    if (!(t > 0.0f)) return 0;
+    if (t >= static_cast<float>(kCells)) return kCells - 1;
+    return static_cast<uint32_t>(t);
+}
+
+} // namespace
+
+OctreeIndex::OctreeIndex(SpatialBounds bounds, int capacity)
+    : bounds_(bounds), capacity_(std::max(1, capacity)) {
+    auto scaleFor = [](float lo, float hi) { return hi > lo ? static_cast<float>(kCells) / (hi - lo) : 0.0f; };
+    scaleX_ = scaleFor(bounds.x1, bounds.x2);
+    scaleY_ = scaleFor(bounds.y1, bounds.y2);
+    scaleZ_ = scaleFor(bounds.z1, bounds.z2);
+    cellX_ = scaleX_ > 0.0f ? 1.0f / scaleX_ : 0.0f;
+    cellY_ = scaleY_ > 0.0f ? 1.0f / scaleY_ : 0.0f;
+    cellZ_ = scaleZ_ > 0.0f ? 1.0f / scaleZ_ : 0.0f;
+    clear();
+}
+
+int OctreeIndex::maxDepth() {
+    return std::min(std::max(Config::maxSpatialDepth, 0), kCodeBits);
+}
+
+uint64_t OctreeIndex::mortonCode(const Cell& c) {
+    return spreadBits(c.x) | (spreadBits(c.y) << 1) | (spreadBits(c.z) << 2);
+}
+
+OctreeIndex::Cell OctreeIndex::quantize(float x, float y, float z) const {
+    return {toCell(x, bounds_.x1, scaleX_), toCell(y, bounds_.y1, scaleY_), toCell(z, bounds_.z1, scaleZ_)};
+}
+
+SpatialBounds OctreeIndex::cellBox(const Cell& base, int depth) const {
+    // Padded by a cell on each side to absorb rounding in quantize().
+    float size = static_cast<float>(1u << (kCodeBits - depth));
+    return SpatialBounds{
+        bounds_.x1 + (static_cast<float>(base.x) - 1.0f) * cellX_,
+        bounds_.y1 + (static_cast<float>(base.y) - 1.0f) * cellY_,
+        bounds_.z1 + (static_cast<float>(base.z) - 1.0f) * cellZ_,
+        bounds_.x1 + (static_cast<float>(base.x) + size + 1.0f) * cellX_,
+        bounds_.y1 + (static_cast<float>(base.y) + size + 1.0f) * cellY_,
+        bounds_.z1 + (static_cast<float>(base.z) + size + 1.0f) * cellZ_
+    };
+}
+
+uint32_t OctreeIndex::findLeaf(const Cell& c, int* depthOut) const {
+    uint32_t index = 0;
+    int depth = 0;
+    while (nodes_[index].firstChild != 0) {
+        index = nodes_[index].firstChild + static_cast<uint32_t>(octantAt(c, depth));
+        ++depth;
     }
+    if (depthOut) *depthOut = depth;
+    return index;
+}
 
-    if (entries_.size() < (size_t)capacity_ || depth_ >= get_max_depth()) {
-        entries_.push_back({nodeId, x, y, z});
-        return;
+void OctreeIndex::append(uint32_t leaf, const SpatialEntry& entry) {
+    Node& node = nodes_[leaf];
+    if (node.count == node.capacity) {
+        // Move the block to the end of the arena with room to grow.
+        uint32_t capacity = std::max<uint32_t>(static_cast<uint32_t>(capacity_), node.capacity * 2);
+        uint32_t begin = static_cast<uint32_t>(entries_.size());
+        entries_.resize(entries_.size() + capacity);
+        std::copy(entries_.begin() + node.begin, entries_.begin() + node.begin + node.count, entries_.begin() + begin);
+        deadSlots_ += node.capacity;
+        node.begin = begin;
+        node.capacity = capacity;
+    }
+    entries_[node.begin + node.count++] = entry;
+}
+
+void OctreeIndex::split(uint32_t leaf, int depth) {
+    uint32_t firstChild = static_cast<uint32_t>(nodes_.size());
+    nodes_.resize(nodes_.size() + 8, Node{0, 0, 0, 0});
+    Node old = nodes_[leaf];
+    nodes_[leaf] = Node{firstChild, 0, 0, 0};
+    for (uint32_t i = 0; i < old.count; ++i) {
+        const SpatialEntry e = entries_[old.begin + i];
+        append(firstChild + static_cast<uint32_t>(octantAt(quantize(e.x, e.y, e.z), depth)), e);
     }
+    deadSlots_ += old.capacity;
+}
 
-    subdivide();
+void OctreeIndex::compact() {
+    std::vector<SpatialEntry> packed;
+    packed.reserve(size_ + size_ / 2);
+    for (Node& node : nodes_) {
+        if (node.firstChild != 0) continue;
+        uint32_t begin = static_cast<uint32_t>(packed.size());
+        packed.insert(packed.end(), entries_.begin() + node.begin, entries_.begin() + node.begin + node.count);
+        node.begin = begin;
+        node.capacity = node.count;
+    }
+    entries_.swap(packed);
+    deadSlots_ = 0;
+}
 
-    // After subdivision, this node is empty and subdivided_ is true
-    // Need to re-insert the current node as well
-    insert(nodeId, x, y, z);
+void OctreeIndex::insert(int nodeId, float x, float y, float z) {
+    if (!contains(bounds_, x, y, z)) return;
+    Cell c = quantize(x, y, z);
+    int depth = 0;
+    uint32_t leaf = findLeaf(c, &depth);
+    while (nodes_[leaf].count >= static_cast<uint32_t>(capacity_) && depth < maxDepth()) {
+        split(leaf, depth);
+        leaf = nodes_[leaf].firstChild + static_cast<uint32_t>(octantAt(c, depth));
+        ++depth;
+    }
+    append(leaf, {nodeId, x, y, z});
+    ++size_;
+    if (deadSlots_ > 1024 && deadSlots_ > entries_.size() / 2) compact();
 }
 
+bool OctreeIndex::remove(int nodeId, float x, float y, float z) {
+    if (!contains(bounds_, x, y, z)) return false;
+    Node& node = nodes_[findLeaf(quantize(x, y, z), nullptr)];
+    SpatialEntry* first = entries_.data() + node.begin;
+    SpatialEntry* last = first + node.count;
+    SpatialEntry* it = std::find_if(first, last, [&](const SpatialEntry& e) {
+        return e.nodeId == nodeId && e.x == x && e.y == y && e.z == z;
+    });
+    if (it == last) return false;
+    *it = *(last - 1);
+    --node.count;
+    --size_;
+    return true;
+}
 
 std::vector<int> OctreeIndex::queryRange(const SpatialBounds& bounds) {
     std::vector<int> found;
-    if (!intersects(bounds_, bounds)) return found;
+    queryRange(bounds, found);
+    return found;
+}
+
+void OctreeIndex::queryRange(const SpatialBounds& bounds, std::vector<int>& out) const {
+    forEachInRange(bounds, [&out](const SpatialEntry& e) {
+        out.push_back(e.nodeId);
+        return true;
+    });
+}
+
+std::vector<SpatialHit> OctreeIndex::nearest(float x, float y, float z, size_t k, float maxDistance) const {
+    std::vector<SpatialHit> hits;
+    if (k == 0) return hits;
+    forEachNearest(x, y, z, maxDistance, [&](const SpatialEntry& e, float distance) {
+        hits.push_back({e.nodeId, distance});
+        return hits.size() < k;
+    });
+    return hits;
+}
+
+void OctreeIndex::queryRadius(float x, float y, float z, float radius, std::vector<int>& out) const {
+    float r2 = radius * radius;
+    forEachInRange(SpatialBounds{x - radius, y - radius, z - radius, x + radius, y + radius, z + radius},
+                   [&](const SpatialEntry& e) {
+        float dx = e.x - x, dy = e.y - y, dz = e.z - z;
+        if (dx * dx + dy * dy + dz * dz <= r2) out.push_back(e.nodeId);
+        return true;
+    });
+}
 
-    for (const auto& entry : entries_) {
-        if (contains(bounds, entry.x, entry.y, entry.z)) {
-            found.push_back(entry.nodeId);
+namespace {
+
+// Slab test; returns the parameter where the ray enters the box, or -1 on a miss.
+float rayEnter(const SpatialRay& ray, const SpatialBounds& b) {
+    float tEnter = 0.0f, tExit = ray.maxT;
+    const float o[3] = {ray.ox, ray.oy, ray.oz};
+    const float d[3] = {ray.dx, ray.dy, ray.dz};
+    const float lo[3] = {b.x1, b.y1, b.z1};
+    const float hi[3] = {b.x2, b.y2, b.z2};
+    for (int axis = 0; axis < 3; ++axis) {
+        if (d[axis] == 0.0f) {
+            if (o[axis] < lo[axis] || o[axis] > hi[axis]) return -1.0f;
+            continue;
         }
+        float t1 = (lo[axis] - o[axis]) / d[axis];
+        float t2 = (hi[axis] - o[axis]) / d[axis];
+        if (t1 > t2) std::swap(t1, t2);
+        tEnter = std::max(tEnter, t1);
+        tExit = std::min(tExit, t2);
+        if (tEnter > tExit) return -1.0f;
     }
+    return tEnter;
+}
+
+} // namespace
+
+bool OctreeIndex::raycast(const SpatialRay& ray, float radius, SpatialHit& hit) const {
+    float len2 = ray.dx * ray.dx + ray.dy * ray.dy + ray.dz * ray.dz;
+    if (size_ == 0 || len2 == 0.0f) return false;
+    float r2 = radius * radius;
+
+    // Best-first by entry parameter into each radius-padded node box; the walk ends
+    // once the next box starts beyond the best hit so far.
+    struct Item {
+        float t;
+        uint32_t node;
+        int depth;
+        Cell base;
+        bool operator<(const Item& o) const { return t > o.t; }
+    };
+    auto padded = [radius](SpatialBounds b) {
+        return SpatialBounds{b.x1 - radius, b.y1 - radius, b.z1 - radius, b.x2 + radius, b.y2 + radius, b.z2 + radius};
+    };
 
-    if (subdivided_) {
-        for (int i = 0; i < 8; ++i) {
-            auto childFound = children_[i]->queryRange(bounds);
-            found.insert(found.end(), childFound.begin(), childFound.end());
+    bool found = false;
+    float bestT = ray.maxT;
+    std::priority_queue<Item> queue;
+    float t0 = rayEnter(ray, padded(cellBox({0, 0, 0}, 0)));
+    if (t0 >= 0.0f) queue.push({t0, 0, 0, {0, 0, 0}});
+    while (!queue.empty()) {
+        Item item = queue.top();
+        queue.pop();
+        if (found && item.t > bestT) break;
+        const Node& node = nodes_[item.node];
+        if (node.firstChild == 0) {
+            for (uint32_t i = node.begin; i < node.begin + node.count; ++i) {
+                const SpatialEntry& e = entries_[i];
+                float px = e.x - ray.ox, py = e.y - ray.oy, pz = e.z - ray.oz;
+                float t = (px * ray.dx + py * ray.dy + pz * ray.dz) / len2;
+                t = std::min(std::max(t, 0.0f), ray.maxT);
+                float cx = px - ray.dx * t, cy = py - ray.dy * t, cz = pz - ray.dz * t;
+                if (cx * cx + cy * cy + cz * cz > r2) continue;
+                if (!found || t < bestT || (t == bestT && e.nodeId < hit.nodeId)) {
+                    hit = {e.nodeId, t};
+                    bestT = t;
+                    found = true;
+                }
+            }
+            continue;
+        }
+        for (int oct = 0; oct < 8; ++oct) {
+            uint32_t child = node.firstChild + static_cast<uint32_t>(oct);
+            const Node& c = nodes_[child];
+            if (c.firstChild == 0 && c.count == 0) continue;
+            Cell b = childBase(item.base, item.depth, oct);
+            float t = rayEnter(ray, padded(cellBox(b, item.depth + 1)));
+            if (t >= 0.0f && (!found || t <= bestT)) queue.push({t, child, item.depth + 1, b});
         }
     }
-
     return found;
 }
 
-void OctreeIndex::subdivide() {
-    float midX = (bounds_.x1 + bounds_.x2) / 2.0f;
-    float midY = (bounds_.y1 + bounds_.y2) / 2.0f;
-    float midZ = (bounds_.z1 + bounds_.z2) / 2.0f;
+void OctreeIndex::clear() {
+    nodes_.assign(1, Node{0, 0, 0, 0});
+    entries_.clear();
+    size_ = 0;
+    deadSlots_ = 0;
+}
 
-    int nextDepth = depth_ + 1;
-    children_[0] = std::make_unique<OctreeIndex>(SpatialBounds{bounds_.x1, bounds_.y1, bounds_.z1, midX, midY, midZ}, capacity_, nextDepth);
-    children_[1] = std::make_unique<OctreeIndex>(SpatialBounds{midX, bounds_.y1, bounds_.z1, bounds_.x2, midY, midZ}, capacity_, nextDepth);
-    children_[2] = std::make_unique<OctreeIndex>(SpatialBounds{bounds_.x1, midY, bounds_.z1, midX, bounds_.y2, midZ}, capacity_, nextDepth);
-    children_[3] = std::make_unique<OctreeIndex>(SpatialBounds{midX, midY, bounds_.z1, bounds_.x2, bounds_.y2, midZ}, capacity_, nextDepth);
-    children_[4] = std::make_unique<OctreeIndex>(SpatialBounds{bounds_.x1, bounds_.y1, midZ, midX, midY, bounds_.z2}, capacity_, nextDepth);
-    children_[5] = std::make_unique<OctreeIndex>(SpatialBounds{midX, bounds_.y1, midZ, bounds_.x2, midY, bounds_.z2}, capacity_, nextDepth);
-    children_[6] = std::make_unique<OctreeIndex>(SpatialBounds{bounds_.x1, midY, midZ, midX, bounds_.y2, bounds_.z2}, capacity_, nextDepth);
-    children_[7] = std::make_unique<OctreeIndex>(SpatialBounds{midX, midY, midZ, bounds_.x2, bounds_.y2, bounds_.z2}, capacity_, nextDepth);
+void OctreeIndex::build(std::vector<SpatialEntry> entries) {
+    clear();
+    auto outside = std::remove_if(entries.begin(), entries.end(), [this](const SpatialEntry& e) {
+        return !contains(bounds_, e.x, e.y, e.z);
+    });
+    entries.erase(outside, entries.end());
+    if (entries.empty()) return;
 
-    subdivided_ = true;
+    // Sort once by Morton code; every octant at every depth is then a contiguous run.
+    std::vector<uint64_t> codes(entries.size());
+    for (size_t i = 0; i < entries.size(); ++i) codes[i] = mortonCode(quantize(entries[i].x, entries[i].y, entries[i].z));
+    std::vector<uint32_t> order(entries.size());
+    std::iota(order.begin(), order.end(), 0u);
+    std::stable_sort(order.begin(), order.end(), [&codes](uint32_t a, uint32_t b) { return codes[a] < codes[b]; });
 
-    // Move existing entries to children
-    for (const auto& entry : entries_) {
-        for (int i = 0; i < 8; ++i) {
-            children_[i]->insert(entry.nodeId, entry.x, entry.y, entry.z);
-        }
+    entries_.resize(entries.size());
+    std::vector<uint64_t> sortedCodes(entries.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        entries_[i] = entries[order[i]];
+        sortedCodes[i] = codes[order[i]];
+    }
+    size_ = entries_.size();
+    buildNode(0, sortedCodes.data(), 0, static_cast<uint32_t>(size_), 0);
+}
+
+void OctreeIndex::buildNode(uint32_t index, const uint64_t* codes, uint32_t first, uint32_t last, int depth) {
+    uint32_t count = last - first;
+    if (count <= static_cast<uint32_t>(capacity_) || depth >= maxDepth()) {
+        nodes_[index] = Node{0, first, count, count};
+        return;
+    }
+
+    uint32_t firstChild = static_cast<uint32_t>(nodes_.size());
+    nodes_.resize(nodes_.size() + 8, Node{0, 0, 0, 0});
+    nodes_[index] = Node{firstChild, 0, 0, 0};
+
+    int shift = 3 * (kCodeBits - 1 - depth);
+    uint32_t begin = first;
+    for (int oct = 0; oct < 8; ++oct) {
+        const uint64_t* end = std::partition_point(codes + begin, codes + last, [shift, oct](uint64_t code) {
+            return static_cast<int>((code >> shift) & 7u) <= oct;
+        });
+        uint32_t stop = static_cast<uint32_t>(end - codes);
+        buildNode(firstChild + static_cast<uint32_t>(oct), codes, begin, stop, depth + 1);
+        begin = stop;
     }
-    entries_.clear();
 }
 
+void OctreeIndex::buildFromNodePositions(const Graph& graph) {
+    std::vector<SpatialEntry> entries;
+    entries.reserve(graph.nodePos.size());
+    for (const auto& [id, pos] : graph.nodePos) entries.push_back({id, pos.x, pos.y, pos.z});
+    build(std::move(entries));
+}
+
+void OctreeIndex::buildFromLayout(const Graph& graph) {
+    std::vector<SpatialEntry> entries;
+    entries.reserve(graph.layoutPositions.size());
+    for (const auto& [id, pos] : graph.layoutPositions) {
+        auto depth = graph.nodePos.find(id);
+        entries.push_back({id, pos.x, pos.y, depth != graph.nodePos.end() ? depth->second.z : 0.0f});
+    }
+    build(std::move(entries));
+}
+
+void OctreeIndex::snapshot(std::vector<OctreeSnapshotNode>& nodes, std::vector<SpatialEntry>& entries) const {
+    snapshotNode(0, nodes, entries);
+}
+
+void OctreeIndex::snapshotNode(uint32_t index, std::vector<OctreeSnapshotNode>& nodes,
+                               std::vector<SpatialEntry>& entries) const {
+    const Node& node = nodes_[index];
+    if (node.firstChild == 0) {
+        nodes.push_back({node.count, 0u});
+        entries.insert(entries.end(), entries_.begin() + node.begin, entries_.begin() + node.begin + node.count);
+        return;
+    }
+    nodes.push_back({0u, 1u});
+    for (uint32_t i = 0; i < 8; ++i) snapshotNode(node.firstChild + i, nodes, entries);
+}
+
+bool OctreeIndex::restore(const OctreeSnapshotNode* nodes, size_t nodeCount, const SpatialEntry* entries, size_t entryCount) {
+    clear();
+    if (entryCount > UINT32_MAX || nodeCount > UINT32_MAX) return false;
+    entries_.assign(entries, entries + entryCount);
+    size_t nodePos = 0, entryPos = 0;
+    bool ok = restoreNode(0, 0, Cell{0, 0, 0}, nodes, nodeCount, nodePos, entries, entryCount, entryPos) &&
+              nodePos == nodeCount && entryPos == entryCount;
+    if (!ok) {
+        clear();
+        return false;
+    }
+    size_ = entryCount;
+    return true;
+}
+
+bool OctreeIndex::restoreNode(uint32_t index, int depth, const Cell& base, const OctreeSnapshotNode* nodes,
+                              size_t nodeCount, size_t& nodePos, const SpatialEntry* entries, size_t entryCount,
+                              size_t& entryPos) {
+    if (nodePos >= nodeCount || depth > kCodeBits) return false;
+    const OctreeSnapshotNode& snap = nodes[nodePos++];
+
+    if (!snap.subdivided) {
+        if (snap.entryCount > entryCount - entryPos) return false;
+        // Every entry must sit in the leaf its position descends to.
+        int shift = kCodeBits - depth;
+        for (size_t i = entryPos; i < entryPos + snap.entryCount; ++i) {
+            const SpatialEntry& e = entries[i];
+            if (!contains(bounds_, e.x, e.y, e.z)) return false;
+            if (shift < kCodeBits) {
+                Cell c = quantize(e.x, e.y, e.z);
+                if ((c.x >> shift) != (base.x >> shift) || (c.y >> shift) != (base.y >> shift) ||
+                    (c.z >> shift) != (base.z >> shift)) return false;
+            }
+        }
+        nodes_[index] = Node{0, static_cast<uint32_t>(entryPos), snap.entryCount, snap.entryCount};
+        entryPos += snap.entryCount;
+        return true;
+    }
+
+    if (snap.entryCount != 0 || depth == kCodeBits) return false;
+    uint32_t firstChild = static_cast<uint32_t>(nodes_.size());
+    nodes_.resize(nodes_.size() + 8, Node{0, 0, 0, 0});
+    nodes_[index] = Node{firstChild, 0, 0, 0};
+    uint32_t half = 1u << (kCodeBits - 1 - depth);
+    for (int oct = 0; oct < 8; ++oct) {
+        Cell b{base.x + ((oct & 1) ? half : 0), base.y + ((oct & 2) ? half : 0), base.z + ((oct & 4) ? half : 0)};
+        if (!restoreNode(firstChild + static_cast<uint32_t>(oct), depth + 1, b, nodes, nodeCount, nodePos,
+                         entries, entryCount, entryPos)) return false;
+    }
+    return true;
+}
 
 bool OctreeIndex::contains(const SpatialBounds& b, float x, float y, float z) const {
     return x >= b.x1 && x <= b.x2 && y >= b.y1 && y <= b.y2 && z >= b.z1 && z <= b.z2;
@@ -82,5 +412,4 @@ bool OctreeIndex::intersects(const SpatialBounds& a, const SpatialBounds& b) con
            (a.z1 <= b.z2 && a.z2 >= b.z1);
 }
 
-
 } // namespace render
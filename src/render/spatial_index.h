@@ -1,8 +1,13 @@
 #ifndef SPATIAL_INDEX_H
 #define SPATIAL_INDEX_H
 
+#include <algorithm>
 #include <vector>
 #include <memory>
+#include <cstdint>
+#include <cmath>
+#include <limits>
+#include <queue>
 #include "../map_logic.h"
 
 namespace render {
@@ -12,41 +17,233 @@ struct SpatialBounds {
     float x2, y2, z2;
 };
 
+struct SpatialEntry {
+    int nodeId;
+    float x, y, z;
+};
+
+struct SpatialHit {
+    int nodeId;
+    float distance; // from the query point, or along a ray in units of its direction
+};
+
+// Ray from (ox, oy, oz) along (dx, dy, dz); a finite maxT makes it a segment.
+struct SpatialRay {
+    float ox, oy, oz;
+    float dx, dy, dz;
+    float maxT = std::numeric_limits<float>::infinity();
+};
+
+// One node of a preorder octree snapshot; subdivided nodes are followed by their 8 children.
+struct OctreeSnapshotNode {
+    uint32_t entryCount;
+    uint32_t subdivided;
+};
+
 class SpatialIndex {
 public:
     virtual ~SpatialIndex() = default;
     virtual void insert(int nodeId, float x, float y, float z) = 0;
+    // Position must match the one the entry was inserted with.
+    virtual bool remove(int nodeId, float x, float y, float z) = 0;
     virtual std::vector<int> queryRange(const SpatialBounds& bounds) = 0;
+    virtual void clear() = 0;
+
+    // Up to k entries closest to the point, nearest first, none farther than maxDistance.
+    virtual std::vector<SpatialHit> nearest(float x, float y, float z, size_t k,
+                                            float maxDistance = std::numeric_limits<float>::infinity()) const = 0;
+    // Appends the ids within `radius` of the point.
+    virtual void queryRadius(float x, float y, float z, float radius, std::vector<int>& out) const = 0;
+    // Finds the entry within `radius` of the ray with the smallest ray parameter.
+    virtual bool raycast(const SpatialRay& ray, float radius, SpatialHit& hit) const = 0;
+
+    // Replaces the contents with `entries` in one pass.
+    virtual void build(std::vector<SpatialEntry> entries) {
+        clear();
+        for (const auto& e : entries) insert(e.nodeId, e.x, e.y, e.z);
+    }
 };
 
+// Octree stored in one node array. Points are placed by their quantized
+// position, so each point lives in exactly one leaf and descent picks the
+// child directly from the octant bits. Leaf entries live in blocks of a
+// shared entry array; blocks vacated by splits or growth are reclaimed by
+// compaction.
 class OctreeIndex : public SpatialIndex {
 public:
-    OctreeIndex(SpatialBounds bounds, int capacity = 8, int depth = 0)
-        : bounds_(bounds), capacity_(capacity), depth_(depth), subdivided_(false) {}
+    explicit OctreeIndex(SpatialBounds bounds, int capacity = 8);
 
     void insert(int nodeId, float x, float y, float z) override;
+    bool remove(int nodeId, float x, float y, float z) override;
     std::vector<int> queryRange(const SpatialBounds& bounds) override;
+    void clear() override;
+
+    // Bulk build: sorts the points by Morton code and cuts the sorted run into octants.
+    void build(std::vector<SpatialEntry> entries) override;
+    // Indexes graph.nodePos, keyed by node index.
+    void buildFromNodePositions(const Graph& graph);
+    // Indexes the picture the console renderer draws: layout x and y, with nodePos depth as z.
+    void buildFromLayout(const Graph& graph);
+
+    std::vector<SpatialHit> nearest(float x, float y, float z, size_t k,
+                                    float maxDistance = std::numeric_limits<float>::infinity()) const override;
+    void queryRadius(float x, float y, float z, float radius, std::vector<int>& out) const override;
+    bool raycast(const SpatialRay& ray, float radius, SpatialHit& hit) const override;
+    // Best-first walk: calls visit(const SpatialEntry&, float distance) in order of increasing
+    // distance until it returns false or maxDistance is passed.
+    template <typename Visitor>
+    void forEachNearest(float x, float y, float z, float maxDistance, Visitor&& visit) const;
+
+    // Appends the ids inside `bounds` to `out`.
+    void queryRange(const SpatialBounds& bounds, std::vector<int>& out) const;
+    // Calls visit(const SpatialEntry&) for each entry inside `bounds` until it returns false.
+    template <typename Visitor>
+    void forEachInRange(const SpatialBounds& bounds, Visitor&& visit) const;
+
+    size_t size() const { return size_; }
+    size_t nodeCount() const { return nodes_.size(); }
+
+    // Flat preorder copy of the tree, for persisting a prebuilt index.
+    void snapshot(std::vector<OctreeSnapshotNode>& nodes, std::vector<SpatialEntry>& entries) const;
+    // Rebuilds the tree from a snapshot without re-partitioning. Returns false if it is malformed.
+    bool restore(const OctreeSnapshotNode* nodes, size_t nodeCount, const SpatialEntry* entries, size_t entryCount);
 
 private:
-    static int get_max_depth() { return Config::maxSpatialDepth; }
-    void subdivide();
-    bool contains(const SpatialBounds& b, float x, float y, float z) const;
-    bool intersects(const SpatialBounds& a, const SpatialBounds& b) const;
+    static constexpr int kCodeBits = 21; // per axis; 63-bit Morton codes
 
-    struct Entry {
-        int nodeId;
-        float x, y, z;
+    struct Node {
+        uint32_t firstChild; // 0 for leaves; children are [firstChild, firstChild + 8)
+        uint32_t begin;      // leaf entries are entries_[begin, begin + count)
+        uint32_t count;
+        uint32_t capacity;   // slots reserved for this leaf's block
     };
 
+    struct Cell {
+        uint32_t x, y, z;
+    };
+
+    static int maxDepth();
+    static int octantAt(const Cell& c, int depth) {
+        int shift = kCodeBits - 1 - depth;
+        return static_cast<int>(((c.x >> shift) & 1u) | (((c.y >> shift) & 1u) << 1) | (((c.z >> shift) & 1u) << 2));
+    }
+    static uint64_t mortonCode(const Cell& c);
+
+    Cell quantize(float x, float y, float z) const;
+    // World box that conservatively holds every point quantized into the cell block.
+    SpatialBounds cellBox(const Cell& base, int depth) const;
+    static float boxDistance2(const SpatialBounds& b, float x, float y, float z) {
+        float dx = std::max(std::max(b.x1 - x, 0.0f), x - b.x2);
+        float dy = std::max(std::max(b.y1 - y, 0.0f), y - b.y2);
+        float dz = std::max(std::max(b.z1 - z, 0.0f), z - b.z2);
+        return dx * dx + dy * dy + dz * dz;
+    }
+    static Cell childBase(const Cell& base, int depth, int octant) {
+        uint32_t half = 1u << (kCodeBits - 1 - depth);
+        return {base.x + ((octant & 1) ? half : 0), base.y + ((octant & 2) ? half : 0), base.z + ((octant & 4) ? half : 0)};
+    }
+    bool contains(const SpatialBounds& b, float x, float y, float z) const;
+    bool intersects(const SpatialBounds& a, const SpatialBounds& b) const;
+    uint32_t findLeaf(const Cell& c, int* depthOut) const;
+    void append(uint32_t leaf, const SpatialEntry& entry);
+    void split(uint32_t leaf, int depth);
+    void compact();
+    void buildNode(uint32_t index, const uint64_t* codes, uint32_t first, uint32_t last, int depth);
+    void snapshotNode(uint32_t index, std::vector<OctreeSnapshotNode>& nodes, std::vector<SpatialEntry>& entries) const;
+    bool restoreNode(uint32_t index, int depth, const Cell& base, const OctreeSnapshotNode* nodes, size_t nodeCount,
+                     size_t& nodePos, const SpatialEntry* entries, size_t entryCount, size_t& entryPos);
+
     SpatialBounds bounds_;
+    float scaleX_, scaleY_, scaleZ_; // world units to cells
+    float cellX_, cellY_, cellZ_;    // cells to world units
     int capacity_;
-    int depth_;
-    std::vector<Entry> entries_;
-    std::unique_ptr<OctreeIndex> children_[8];
-    bool subdivided_;
+    std::vector<Node> nodes_;
+    std::vector<SpatialEntry> entries_;
+    size_t size_ = 0;
+    size_t deadSlots_ = 0;
 };
 
+template <typename Visitor>
+void OctreeIndex::forEachInRange(const SpatialBounds& bounds, Visitor&& visit) const {
+    if (size_ == 0 || !intersects(bounds_, bounds)) return;
+    // Quantization is monotonic, so a point inside `bounds` has its cell inside [lo, hi].
+    Cell lo = quantize(bounds.x1, bounds.y1, bounds.z1);
+    Cell hi = quantize(bounds.x2, bounds.y2, bounds.z2);
+
+    struct Frame {
+        uint32_t node;
+        int depth;
+        Cell base;
+    };
+    Frame stack[8 * (kCodeBits + 1)];
+    int top = 0;
+    stack[top++] = {0, 0, {0, 0, 0}};
+    while (top > 0) {
+        Frame f = stack[--top];
+        const Node& node = nodes_[f.node];
+        if (node.firstChild == 0) {
+            const SpatialEntry* e = entries_.data() + node.begin;
+            for (uint32_t i = 0; i < node.count; ++i) {
+                if (contains(bounds, e[i].x, e[i].y, e[i].z) && !visit(e[i])) return;
+            }
+            continue;
+        }
+        uint32_t half = 1u << (kCodeBits - 1 - f.depth);
+        // Push in reverse so children are visited in octant order.
+        for (int oct = 7; oct >= 0; --oct) {
+            Cell b = childBase(f.base, f.depth, oct);
+            if (b.x > hi.x || b.x + half - 1 < lo.x || b.y > hi.y || b.y + half - 1 < lo.y ||
+                b.z > hi.z || b.z + half - 1 < lo.z) continue;
+            stack[top++] = {node.firstChild + static_cast<uint32_t>(oct), f.depth + 1, b};
+        }
+    }
+}
+
+template <typename Visitor>
+void OctreeIndex::forEachNearest(float x, float y, float z, float maxDistance, Visitor&& visit) const {
+    if (size_ == 0) return;
+    float maxD2 = maxDistance * maxDistance;
 
+    // Nodes are keyed by their box distance and entries by their exact distance, so
+    // an entry is only reported once nothing unexplored can be closer.
+    struct Item {
+        float d2;
+        int64_t entry; // -1 for a tree node
+        uint32_t node;
+        int depth;
+        Cell base;
+        bool operator<(const Item& o) const { return d2 > o.d2; }
+    };
+    std::priority_queue<Item> queue;
+    queue.push({boxDistance2(cellBox({0, 0, 0}, 0), x, y, z), -1, 0, 0, {0, 0, 0}});
+    while (!queue.empty()) {
+        Item item = queue.top();
+        queue.pop();
+        if (item.d2 > maxD2) return;
+        if (item.entry >= 0) {
+            if (!visit(entries_[static_cast<size_t>(item.entry)], std::sqrt(item.d2))) return;
+            continue;
+        }
+        const Node& node = nodes_[item.node];
+        if (node.firstChild == 0) {
+            for (uint32_t i = node.begin; i < node.begin + node.count; ++i) {
+                const SpatialEntry& e = entries_[i];
+                float dx = e.x - x, dy = e.y - y, dz = e.z - z;
+                float d2 = dx * dx + dy * dy + dz * dz;
+                if (d2 <= maxD2) queue.push({d2, static_cast<int64_t>(i), 0, 0, {0, 0, 0}});
+            }
+            continue;
+        }
+        for (int oct = 0; oct < 8; ++oct) {
+            uint32_t child = node.firstChild + static_cast<uint32_t>(oct);
+            const Node& c = nodes_[child];
+            if (c.firstChild == 0 && c.count == 0) continue;
+            Cell b = childBase(item.base, item.depth, oct);
+            float d2 = boxDistance2(cellBox(b, item.depth + 1), x, y, z);
+            if (d2 <= maxD2) queue.push({d2, -1, child, item.depth + 1, b});
+        }
+    }
+}
 
 } // namespace render
 
@@ -0,0 +1,142 @@
+#include "terminal_presenter.h"
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+#ifndef _WIN32
+#include <cerrno>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+namespace render {
+
+namespace {
+
+// Unchanged gaps shorter than this are rewritten rather than skipped with
+// a cursor move, which costs about as many bytes.
+constexpr size_t kMergeGap = 8;
+
+void moveCursor(std::string& out, size_t row, size_t col) {
+    out += "\033[";
+    out += std::to_string(row + 1);
+    out += ';';
+    out += std::to_string(col + 1);
+    out += 'H';
+}
+
+bool hasMultiByte(const std::string& s) {
+    return std::any_of(s.begin(), s.end(), [](char c) { return static_cast<unsigned char>(c) >= 0x80; });
+}
+
+void composeLines(const FrameBuffer& fb, std::vector<std::string>& lines) {
+    size_t count = fb.getHeight() + (fb.getTitle().empty() ? 0 : 1) + (fb.getStatusMessage().empty() ? 0 : 1);
+    lines.resize(count);
+    size_t i = 0;
+    if (!fb.getTitle().empty()) lines[i++] = "=== " + fb.getTitle() + " ===";
+    for (int y = 0; y < fb.getHeight(); ++y) lines[i++].assign(fb.getRow(y));
+    if (!fb.getStatusMessage().empty()) lines[i++] = "Status: " + fb.getStatusMessage();
+}
+
+// Emits the runs of `next` that differ from `prev` on one screen row.
+void diffLine(size_t row, const std::string& prev, const std::string& next, std::string& out) {
+    if (prev == next) return;
+
+    // Column positions are byte offsets, which only hold for single-byte text.
+    if (hasMultiByte(prev) || hasMultiByte(next)) {
+        moveCursor(out, row, 0);
+        out += next;
+        out += "\033[K";
+        return;
+    }
+
+    size_t common = std::min(prev.size(), next.size());
+    size_t i = 0;
+    while (i < next.size()) {
+        while (i < common && prev[i] == next[i]) ++i;
+        if (i >= next.size()) break;
+
+        size_t end = i + 1;
+        size_t same = 0;
+        for (size_t k = end; k < next.size(); ++k) {
+            if (k < common && prev[k] == next[k]) {
+                if (++same >= kMergeGap) break;
+            } else {
+                same = 0;
+                end = k + 1;
+            }
+        }
+        moveCursor(out, row, i);
+        out.append(next, i, end - i);
+        i = end;
+    }
+
+    if (next.size() < prev.size()) {
+        moveCursor(out, row, next.size());
+        out += "\033[K";
+    }
+}
+
+// Returns false if the terminal did not receive every byte.
+bool writeAll(const std::string& bytes) {
+    std::cout.flush();
+#ifdef _WIN32
+    bool ok = std::fwrite(bytes.data(), 1, bytes.size(), stdout) == bytes.size();
+    return std::fflush(stdout) == 0 && ok;
+#else
+    const char* p = bytes.data();
+    size_t left = bytes.size();
+    while (left > 0) {
+        ssize_t n = ::write(STDOUT_FILENO, p, left);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            // stdout may share the non-blocking tty description set up for input.
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                pollfd pfd{STDOUT_FILENO, POLLOUT, 0};
+                if (::poll(&pfd, 1, -1) >= 0 || errno == EINTR) continue;
+            }
+            return false;
+        }
+        p += n;
+        left -= static_cast<size_t>(n);
+    }
+    return true;
+#endif
+}
+
+} // namespace
+
+void TerminalPresenter::buildUpdate(const FrameBuffer& fb, std::string& out) {
+    composeLines(fb, next_);
+
+    if (!valid_) {
+        out += "\033[H\033[J";
+        for (const auto& line : next_) {
+            out += line;
+            out += '\n';
+        }
+        valid_ = true;
+    } else {
+        size_t before = out.size();
+        for (size_t row = 0; row < next_.size(); ++row) {
+            static const std::string empty;
+            diffLine(row, row < lines_.size() ? lines_[row] : empty, next_[row], out);
+        }
+        if (next_.size() < lines_.size()) {
+            moveCursor(out, next_.size(), 0);
+            out += "\033[J";
+        }
+        // Leave the cursor below the frame, where a full redraw would.
+        if (out.size() != before) moveCursor(out, next_.size(), 0);
+    }
+
+    lines_.swap(next_);
+}
+
+void TerminalPresenter::present(const FrameBuffer& fb) {
+    out_.clear();
+    buildUpdate(fb, out_);
+    // A partial frame leaves the screen out of step with lines_; repaint next time.
+    if (!out_.empty() && !writeAll(out_)) invalidate();
+}
+
+} // namespace render
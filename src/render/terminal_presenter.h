@@ -0,0 +1,32 @@
+#ifndef TERMINAL_PRESENTER_H
+#define TERMINAL_PRESENTER_H
+
+#include "frame_buffer.h"
+#include <string>
+#include <vector>
+
+namespace render {
+
+// Presents FrameBuffers to an ANSI terminal, emitting only the cells that
+// changed since the previous frame. Each frame is one write to stdout.
+class TerminalPresenter {
+public:
+    void present(const FrameBuffer& fb);
+
+    // Appends the escape sequences that turn the last built frame into fb.
+    // Appends nothing when the frame is unchanged.
+    void buildUpdate(const FrameBuffer& fb, std::string& out);
+
+    // The next frame is drawn in full; call after anything else wrote to the terminal.
+    void invalidate() { valid_ = false; }
+
+private:
+    std::vector<std::string> lines_;
+    std::vector<std::string> next_;
+    std::string out_;
+    bool valid_ = false;
+};
+
+} // namespace render
+
+#endif // TERMINAL_PRESENTER_H
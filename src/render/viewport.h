@@ -16,6 +16,10 @@ public:
         return { (x + panX_) * zoom_, (y + panY_) * zoom_ };
     }
 
+    Point2D screenToWorld(float x, float y) const {
+        return { x / zoom_ - panX_, y / zoom_ - panY_ };
+    }
+
     bool isVisible(int x, int y) const {
         return x >= 0 && x < width_ && y >= 0 && y < height_;
     }
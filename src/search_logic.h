@@ -2,12 +2,16 @@
 #define SEARCH_LOGIC_H
 
 #include "map_logic.h"
+#include <algorithm>
 #include <vector>
 #include <string>
+#include <utility>
 
 struct SearchState {
     std::string keyword;
-    std::vector<int> matches;
+    std::vector<int> matches;   // populate through setMatches so matchMask stays in sync
+    std::vector<bool> matchMask; // indexed by node id, built once per query
+    std::vector<int> sparseMatches; // sorted; replaces matchMask when ids are far apart
     int activeMatchIndex = -1;
     bool isActive = false;
     bool lastSearchHadNoResults = false;
@@ -15,11 +19,55 @@ struct SearchState {
     void clear() {
         keyword.clear();
         matches.clear();
+        matchMask.clear();
+        sparseMatches.clear();
         activeMatchIndex = -1;
         isActive = false;
         lastSearchHadNoResults = false;
     }
 
+    // Replaces the result set and resets the cursor to the first match.
+    void setMatches(std::vector<int> ids) {
+        matches = std::move(ids);
+        matchMask.clear();
+        sparseMatches.clear();
+        int maxId = -1;
+        for (int id : matches) maxId = std::max(maxId, id);
+        // A mask costs a bit per id up to the largest one; past a few words per
+        // match, a sorted list is cheaper.
+        if ((size_t)maxId + 1 <= matches.size() * 64 + 4096) {
+            matchMask.assign(maxId + 1, false);
+            for (int id : matches) {
+                if (id >= 0) matchMask[id] = true;
+            }
+        } else {
+            for (int id : matches) {
+                if (id >= 0) sparseMatches.push_back(id);
+            }
+            std::sort(sparseMatches.begin(), sparseMatches.end());
+        }
+        activeMatchIndex = matches.empty() ? -1 : 0;
+    }
+
+    bool isMatch(int nodeId) const {
+        if (nodeId < 0) return false;
+        if (nodeId < (int)matchMask.size()) return matchMask[nodeId];
+        return std::binary_search(sparseMatches.begin(), sparseMatches.end(), nodeId);
+    }
+
+    // True when the node should be drawn as a search hit this frame.
+    bool isHighlighted(int nodeId) const {
+        return isActive && isMatch(nodeId);
+    }
+
+    // Moves the cursor by `delta` matches, wrapping at either end.
+    int stepActiveMatch(int delta) {
+        if (matches.empty()) return -1;
+        int n = (int)matches.size();
+        activeMatchIndex = ((activeMatchIndex + delta) % n + n) % n;
+        return matches[activeMatchIndex];
+    }
+
     int getActiveMatchNodeId() const {
         if (activeMatchIndex >= 0 && activeMatchIndex < (int)matches.size()) {
             return matches[activeMatchIndex];
@@ -4,8 +4,8 @@
 #include "layout/nexus_flow_view.h"
 #include "layout/book_view.h"
 #include "layout/page_view.h"
-#include "render/renderer_factory.h"
 #include "render/console_renderer.h"
+#include "render/render_pipeline.h"
 #include "layout/layout_manager.h"
 #include "ui/main_menu.h"
 #include <cstdio>
@@ -66,7 +66,7 @@ void renderGraph(const Graph& graph, const ViewContext& view, const SearchState&
                     node.subjectIndex % 4 == 1 ? '#' :
                     node.subjectIndex % 4 == 2 ? 'O' : 'X');
 
-        if (search.isActive && std::find(search.matches.begin(), search.matches.end(), node.index) != search.matches.end()) {
+        if (search.isHighlighted(node.index)) {
             glyph = (search.getActiveMatchNodeId() == node.index) ? 'S' : 's';
         }
 
@@ -175,8 +175,15 @@ void runEditor(Graph& graph, bool runTests) {
     input::ShortcutManager shortcutManager;
     SearchState searchState;
 
-    auto renderer = render::RendererFactory::createRenderer(render::RendererType::CONSOLE);
-    renderer->initialize(view.width, view.height + 10);
+    render::ConsoleRenderer renderer;
+    renderer.initialize(view.width, view.height + 10);
+    render::RenderPipeline pipeline(renderer, shortcutManager);
+
+    // Shows the prompt and hands the terminal to the caller until pipeline.resume().
+    auto prompt = [&](const std::string& message) {
+        pipeline.setStatusMessage(message);
+        pipeline.suspend();
+    };
 
     shortcutManager.registerAction("ADD_NODE", [&]() {
         int newIndex = 0;
@@ -195,38 +202,39 @@ void runEditor(Graph& graph, bool runTests) {
     shortcutManager.registerAction("TOGGLE_AUTOSCALE", [&]() { Config::autoScaleDepth = !Config::autoScaleDepth; });
     shortcutManager.registerAction("TOGGLE_WEIGHTS", [&]() { Config::showTopicWeights = !Config::showTopicWeights; });
     shortcutManager.registerAction("ADD_FOCUS", [&]() {
-        renderer->setStatusMessage("Enter node index to ADD as focus: ");
-        renderer->present();
+        prompt("Enter node index to ADD as focus: ");
         int idx; std::cin >> idx; std::cin.ignore(1000, '\n');
+        pipeline.resume();
         graph.addFocus(idx);
-        renderer->setStatusMessage("Focused node " + std::to_string(idx));
+        pipeline.setStatusMessage("Focused node " + std::to_string(idx));
     });
     shortcutManager.registerAction("REMOVE_FOCUS", [&]() {
-        renderer->setStatusMessage("Enter focus index to REMOVE: ");
-        renderer->present();
+        prompt("Enter focus index to REMOVE: ");
         int idx; std::cin >> idx; std::cin.ignore(1000, '\n');
+        pipeline.resume();
         graph.removeFocus(idx);
-        renderer->setStatusMessage("Unfocused node " + std::to_string(idx));
+        pipeline.setStatusMessage("Unfocused node " + std::to_string(idx));
     });
     shortcutManager.registerAction("SET_DIST", [&]() {
-        renderer->setStatusMessage("Enter new max render distance: ");
-        renderer->present();
+        prompt("Enter new max render distance: ");
         int d; std::cin >> d; std::cin.ignore(1000, '\n');
+        pipeline.resume();
         view.maxRenderDistance = d;
+        pipeline.setStatusMessage("Max render distance " + std::to_string(d));
     });
     shortcutManager.registerAction("SEARCH", [&]() {
-        renderer->setStatusMessage("Enter search keyword: ");
-        renderer->present();
+        prompt("Enter search keyword: ");
         std::string keyword;
         std::getline(std::cin, keyword);
+        pipeline.resume();
         if (!keyword.empty()) {
             std::vector<int> matches = findSimilarTopics(graph, keyword);
             if (!matches.empty()) {
                 graph.clearFocuses();
                 for (int idx : matches) graph.addFocus(idx);
-                renderer->setStatusMessage("Found " + std::to_string(matches.size()) + " matches.");
+                pipeline.setStatusMessage("Found " + std::to_string(matches.size()) + " matches.");
             } else {
-                renderer->setStatusMessage("No matches found.");
+                pipeline.setStatusMessage("No matches found.");
             }
         }
         searchState.isActive = true;
@@ -239,10 +247,11 @@ void runEditor(Graph& graph, bool runTests) {
     shortcutManager.registerAction("PAN_RIGHT", [&]() { view.pan(1, 0); });
     shortcutManager.registerAction("BOOK_VIEW", [&]() { view.currentViewMode = VM_BOOK_VIEW; });
     shortcutManager.registerAction("PAGE_VIEW", [&]() {
-        renderer->setStatusMessage("Enter node index for Page View: ");
-        renderer->present();
+        prompt("Enter node index for Page View: ");
         int idx; std::cin >> idx; std::cin.ignore();
         layout::PageView::renderNodePage(graph, idx);
+        pipeline.resume();
+        pipeline.setStatusMessage("");
     });
     shortcutManager.registerAction("TOGGLE_MULTI_FOCI", [&]() { Config::allowMultiFocus = !Config::allowMultiFocus; });
     shortcutManager.registerAction("TOGGLE_HELP", [&]() { view.showHelp = !view.showHelp; });
@@ -258,11 +267,15 @@ void runEditor(Graph& graph, bool runTests) {
 
     io::RecoveryManager::initialize("tests/temp/autosave.csv");
     if (io::RecoveryManager::detectAndRestore(graph)) {
-        renderer->setStatusMessage("Recovered state from autosave.");
+        pipeline.setStatusMessage("Recovered state from autosave.");
     }
 
     auto lastAutosave = std::chrono::steady_clock::now();
 
+    pipeline.submit(graph, view, searchState);
+    graph.needsLayoutReset = false;
+    pipeline.start();
+
     while (true) {
         auto now = std::chrono::steady_clock::now();
         if (std::chrono::duration_cast<std::chrono::seconds>(now - lastAutosave).count() > 30) {
@@ -270,22 +283,14 @@ void runEditor(Graph& graph, bool runTests) {
             lastAutosave = now;
         }
 
-        if (view.currentViewMode == VM_PERSPECTIVE) {
-            layout::LayoutManager::applyPerspectiveBFS(graph, view);
-        } else if (view.currentViewMode == VM_NEXUS_FLOW) {
-            layout::LayoutManager::applyForceDirected(graph, view);
-        }
+        // Layout and drawing happen on the render thread; this loop only handles input.
+        graph.summary.timeToRenderMs = pipeline.lastFrameMs();
 
-        renderer->clear();
-        auto consoleRenderer = dynamic_cast<render::ConsoleRenderer*>(renderer.get());
-        if (consoleRenderer) {
-            consoleRenderer->renderWithUI(graph, view, searchState, shortcutManager);
-        } else {
-            renderer->render(graph, view);
+        if (Config::viewerOverlayMode) {
+            pipeline.suspend();
+            AnalyticsEngine::drawAnalyticsPanelOverlay(graph);
+            pipeline.resume();
         }
-        renderer->present();
-
-        if (Config::viewerOverlayMode) AnalyticsEngine::drawAnalyticsPanelOverlay(graph);
 
         int key = get_char_non_blocking();
 
@@ -297,16 +302,12 @@ void runEditor(Graph& graph, bool runTests) {
                         searchState.isActive = false;
                     } else if (next_key == '[') {
                         int arrow_key = get_char_non_blocking();
-                        if (!searchState.matches.empty()) {
-                            if (arrow_key == 'A' || arrow_key == 'D') {
-                                searchState.activeMatchIndex = (searchState.activeMatchIndex - 1 + searchState.matches.size()) % searchState.matches.size();
-                            } else if (arrow_key == 'B' || arrow_key == 'C') {
-                                searchState.activeMatchIndex = (searchState.activeMatchIndex + 1) % searchState.matches.size();
-                            }
-                            if (searchState.activeMatchIndex != -1) {
-                                graph.clearFocuses();
-                                graph.addFocus(searchState.matches[searchState.activeMatchIndex]);
-                            }
+                        int delta = (arrow_key == 'A' || arrow_key == 'D') ? -1 :
+                                    (arrow_key == 'B' || arrow_key == 'C') ? 1 : 0;
+                        int target = searchState.stepActiveMatch(delta);
+                        if (target != -1) {
+                            graph.clearFocuses();
+                            graph.addFocus(target);
                         }
                     }
                 } else if (key == 10 || key == 13) {
@@ -314,15 +315,13 @@ void runEditor(Graph& graph, bool runTests) {
                 } else if (key == 127 || key == 8) {
                     if (!searchState.keyword.empty()) {
                         searchState.keyword.pop_back();
-                        searchState.matches = findSimilarTopics(graph, searchState.keyword);
+                        searchState.setMatches(findSimilarTopics(graph, searchState.keyword));
                         searchState.lastSearchHadNoResults = !searchState.keyword.empty() && searchState.matches.empty();
-                        searchState.activeMatchIndex = searchState.matches.empty() ? -1 : 0;
                     }
                 } else if (isprint(key)) {
                     searchState.keyword += static_cast<char>(key);
-                    searchState.matches = findSimilarTopics(graph, searchState.keyword);
+                    searchState.setMatches(findSimilarTopics(graph, searchState.keyword));
                     searchState.lastSearchHadNoResults = searchState.matches.empty();
-                    searchState.activeMatchIndex = searchState.matches.empty() ? -1 : 0;
 
                     if (!searchState.matches.empty()) {
                         graph.clearFocuses();
@@ -349,9 +348,13 @@ void runEditor(Graph& graph, bool runTests) {
                     shortcutManager.handleKey(c);
                 }
             }
+
+            pipeline.submit(graph, view, searchState);
+            graph.needsLayoutReset = false;
         }
         std::this_thread::sleep_for(std::chrono::milliseconds(16));
     }
+    pipeline.stop();
     restore_terminal();
 }
 
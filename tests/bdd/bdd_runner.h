@@ -90,7 +90,7 @@ struct BDDContext {
     bool success = true;
 
     BDDContext() {
-        spatialIndex = std::make_unique<OctreeIndex>(SpatialBounds{-1000, -1000, -1000, 1000, 1000, 1000}, 8, 0);
+        spatialIndex = std::make_unique<OctreeIndex>(SpatialBounds{-1000, -1000, -1000, 1000, 1000, 1000}, 8);
         webServer = std::make_unique<WebServerStub>();
         kernel = std::make_shared<SimulationKernel>();
         overlayService = std::make_shared<OverlayService>();
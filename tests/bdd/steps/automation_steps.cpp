@@ -105,11 +105,8 @@ void registerAutomationSteps() {
     });
 
     runner.registerStep("an Octree spatial index is used", [](BDDContext& ctx, const std::vector<std::string>& args) {
-        ctx.spatialIndex = std::make_unique<OctreeIndex>(SpatialBounds{-10000, -10000, -10000, 10000, 10000, 10000}, 8, 0);
-        for(const auto& node : ctx.graph.nodes) {
-            auto pos = ctx.graph.nodePos[node.index];
-            ctx.spatialIndex->insert(node.index, pos.x, pos.y, pos.z);
-        }
+        ctx.spatialIndex = std::make_unique<OctreeIndex>(SpatialBounds{-10000, -10000, -10000, 10000, 10000, 10000}, 8);
+        ctx.spatialIndex->buildFromNodePositions(ctx.graph);
     });
 
     runner.registerStep("I query nodes within a \\((.*), (.*), (.*)\\) bounding box", [](BDDContext& ctx, const std::vector<std::string>& args) {
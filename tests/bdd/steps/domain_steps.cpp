@@ -15,6 +15,12 @@ class MockOverlayService : public IOverlayService {
 public:
     bool load_overlays_from_file(const std::string& path) override { return true; }
     void add_overlay(const OverlaySpec& spec) override {
+        for (auto& existing : active_overlays_) {
+            if (existing.id == spec.id && existing.anchor_entity_id == spec.anchor_entity_id) {
+                existing = spec;
+                return;
+            }
+        }
         active_overlays_.push_back(spec);
     }
     std::vector<OverlaySpec> get_active_overlays_for_entity(const std::string& entity_id) const override {
@@ -47,12 +53,14 @@ public:
     void restore_snapshot(const SimulationSnapshot& snapshot) override {
         current_time_ms_ = snapshot.timestamp_ms;
     }
-    void set_seed(uint64_t seed) override {}
+    void set_seed(uint64_t seed) override { seed_ = seed; }
+    uint64_t seed() const override { return seed_; }
     uint64_t current_time_ms() const override { return current_time_ms_; }
     bool is_running() const override { return is_running_; }
 
     uint64_t current_time_ms_ = 0;
     bool is_running_ = false;
+    uint64_t seed_ = 0;
 };
 
 void registerDomainSteps() {
@@ -2,6 +2,17 @@
 #include "viewer_logic.h"
 #include "io/io_manager.h"
 #include "layout/book_view.h"
+#include "io/xml_parser.h"
+#include "io/xml_extractor.h"
+#include "render/frame_buffer.h"
+#include "render/terminal_presenter.h"
+#include "render/render_pipeline.h"
+#include "render/layout_grid.h"
+#include "render/edge_lod.h"
+#include "render/label_placer.h"
+#include "processor_logic.h"
+#include <filesystem>
+#include <fstream>
 #include <iostream>
 #include <iomanip>
 #include <cmath>
@@ -309,6 +320,334 @@ void testComputeSummaryEnhancements() {
   TEST("diameter == 1", g.summary.diameter == 1);
 }
 
+void testXmlTreeAndMeshExtraction() {
+  std::string xml =
+    "<?xml version=\"1.0\"?><!DOCTYPE PubmedArticleSet>"
+    "<Rules><Command key=\"A\" description=\"a &gt; b\"/><Group><Command key='B'/></Group></Rules>";
+  io::XmlNode root = io::XmlParser::parse(xml);
+  TEST("XML tree keeps nesting", root.children.size() == 1 && root.children[0].children.size() == 2);
+  TEST("XML attribute decoded", root.children[0].children[0].attributes["description"] == "a > b");
+  TEST("XML grandchild parsed", root.children[0].children[1].children.size() == 1 &&
+                                root.children[0].children[1].children[0].attributes["key"] == "B");
+
+  std::string pubmed =
+    "<PubmedArticleSet><DescriptorNameList><DescriptorName MajorTopicYN=\"N\"> Alzheimer Disease </DescriptorName>"
+    "<!-- <DescriptorName>Ignored</DescriptorName> -->"
+    "<DescriptorName><![CDATA[Amyloid]]></DescriptorName><DescriptorName>Tau &amp; Tangles</DescriptorName>"
+    "<DescriptorName><![CDATA[a &amp; b]]></DescriptorName>"
+    "</DescriptorNameList></PubmedArticleSet>";
+  auto terms = io::XmlExtractor::extractMeshTerms(pubmed);
+  TEST("MeSH terms extracted", terms.size() == 4 && terms.count("Alzheimer Disease") && terms.count("Amyloid"));
+  TEST("MeSH entities decoded", terms.count("Tau & Tangles") == 1);
+  TEST("MeSH CDATA kept literal", terms.count("a &amp; b") == 1);
+
+  io::XmlNode cdata = io::XmlParser::parse("<T>x &lt; <![CDATA[a &amp; <b>]]></T>");
+  TEST("XML CDATA kept literal", cdata.children.size() == 1 && cdata.children[0].text == "x < a &amp; <b>");
+}
+
+void testFrameBufferSpans() {
+  render::FrameBuffer fb(10, 3);
+  fb.drawString(-2, 0, "abcdefghijklmn", 1.0f);
+  TEST("drawString clips both edges", fb.getRow(0) == "cdefghijkl");
+  fb.drawString(3, 0, "XYZ", 2.0f);
+  TEST("drawString respects depth", fb.getRow(0) == "cdefghijkl");
+  fb.drawString(3, 0, "XYZ", 0.5f);
+  TEST("drawString overwrites nearer", fb.getRow(0) == "cdeXYZijkl" && fb.getDepth(4, 0) == 0.5f);
+
+  fb.fillSpan(0, 1, 10, '#', 3.0f);
+  fb.drawChar(5, 1, '*', 1.0f);
+  fb.fillSpan(2, 1, 6, '=', 2.0f);
+  TEST("fillSpan keeps nearer cells", fb.getRow(1) == "##===*==##");
+
+  fb.drawRect(7, 1, 5, 5, 'o', 0.0f);
+  TEST("drawRect clipped", fb.getRow(1) == "##===*=ooo" && fb.getRow(2)[7] == 'o');
+
+  fb.clear();
+  TEST("clear resets cells and depth", fb.getRow(0) == "          " &&
+       fb.getDepth(9, 2) == std::numeric_limits<float>::infinity());
+}
+
+void testTerminalPresenterDiff() {
+  render::FrameBuffer fb(40, 4);
+  render::TerminalPresenter presenter;
+  fb.drawString(0, 1, "hello world", 0.0f);
+  fb.setStatusMessage("ready");
+
+  std::string out;
+  presenter.buildUpdate(fb, out);
+  TEST("first frame is a full redraw", out.rfind("\033[H\033[J", 0) == 0 &&
+       out.find("hello world") != std::string::npos && out.find("Status: ready") != std::string::npos);
+
+  out.clear();
+  presenter.buildUpdate(fb, out);
+  TEST("unchanged frame emits nothing", out.empty());
+
+  fb.drawChar(6, 1, 'W', -1.0f);
+  out.clear();
+  presenter.buildUpdate(fb, out);
+  TEST("single cell change emits one run", out == "\033[2;7HW\033[6;1H");
+
+  fb.drawChar(0, 3, 'a', -1.0f);
+  fb.drawChar(39, 3, 'z', -1.0f);
+  fb.setStatusMessage("ok");
+  out.clear();
+  presenter.buildUpdate(fb, out);
+  TEST("distant changes use separate runs", out.find("\033[4;1Ha") != std::string::npos &&
+       out.find("\033[4;40Hz") != std::string::npos);
+  TEST("shorter line is erased to end", out.find("\033[5;9Hok\033[5;11H\033[K") != std::string::npos);
+
+  presenter.invalidate();
+  out.clear();
+  presenter.buildUpdate(fb, out);
+  TEST("invalidate forces full redraw", out.rfind("\033[H\033[J", 0) == 0);
+}
+
+void testRenderPipelineFrames() {
+  Graph g;
+  g.addNode(GraphNode("Alpha", 0));
+  g.addNode(GraphNode("Beta", 1));
+  g.addEdge(0, 1);
+  ViewContext view;
+  SearchState search;
+  input::ShortcutManager shortcuts;
+  render::ConsoleRenderer renderer;
+  renderer.initialize(view.width, view.height + 10);
+
+  render::RenderPipeline pipeline(renderer, shortcuts, 120, false);
+  pipeline.submit(g, view, search);
+  pipeline.start();
+  bool drew = pipeline.waitForFrame(std::chrono::seconds(5));
+  TEST("render thread presents a frame", drew && pipeline.framesPresented() >= 1);
+  TEST("front buffer holds the snapshot", pipeline.frontBuffer().getTitle() == "Full Layout");
+  TEST("frame time recorded", pipeline.lastFrameMs() > 0.0);
+
+  pipeline.setStatusMessage("busy");
+  pipeline.waitForFrame(std::chrono::seconds(5));
+  TEST("status reaches front buffer", pipeline.frontBuffer().getStatusMessage() == "busy");
+
+  pipeline.suspend();
+  uint64_t frames = pipeline.framesPresented();
+  pipeline.setStatusMessage("idle");
+  bool drewWhileSuspended = pipeline.waitForFrame(std::chrono::milliseconds(100));
+  TEST("suspended pipeline does not draw", !drewWhileSuspended && pipeline.framesPresented() == frames);
+  pipeline.resume();
+  pipeline.waitForFrame(std::chrono::seconds(5));
+  TEST("resume redraws", pipeline.frontBuffer().getStatusMessage() == "idle");
+
+  g.needsLayoutReset = false; // as the viewer does after its first submit
+  uint64_t builds = pipeline.gridBuilds();
+  uint64_t copies = pipeline.graphCopies();
+  for (int i = 0; i < 2; ++i) {
+    view.pan(1, 0);
+    pipeline.submit(g, view, search);
+    pipeline.waitForFrame(std::chrono::seconds(5));
+  }
+  TEST("pans reuse the layout grid", builds >= 1 && pipeline.gridBuilds() == builds);
+  TEST("pans do not copy the graph", copies >= 1 && pipeline.graphCopies() == copies);
+  g.addFocus(1);
+  pipeline.submit(g, view, search);
+  pipeline.waitForFrame(std::chrono::seconds(5));
+  TEST("focus change rebuilds the layout grid", pipeline.gridBuilds() == builds + 1);
+  g.addNode(GraphNode("Gamma", 2));
+  view.pan(-1, 0);
+  pipeline.submit(g, view, search);
+  view.pan(-1, 0);
+  pipeline.submit(g, view, search); // supersedes the unseen graph without dropping it
+  pipeline.waitForFrame(std::chrono::seconds(5));
+  TEST("graph edits are copied once", pipeline.graphCopies() == copies + 2 && pipeline.gridBuilds() == builds + 2);
+  pipeline.stop();
+}
+
+void testFrustumCulledRender() {
+  // A 40x40 lattice spanning well beyond the screen, plus long diagonals.
+  Graph g;
+  for (int i = 0; i < 1600; ++i) g.addNode(GraphNode("n" + std::to_string(i), i));
+  for (int i = 0; i < 1600; ++i) {
+    if (i % 40 != 39) g.addEdge(i, i + 1);
+    if (i + 40 < 1600) g.addEdge(i, i + 40);
+  }
+  g.addEdge(0, 1599);
+  g.addEdge(39, 1560);
+  for (int i = 0; i < 1600; ++i) g.layoutPositions[i] = { (i % 40) * 7.0f - 60.0f, (i / 40) * 4.0f - 40.0f };
+  g.touchLayout();
+
+  render::LayoutGrid grid;
+  grid.update(g);
+  std::vector<int> hits;
+  grid.queryNodes(9.5f, -0.5f, 10.5f, 0.5f, hits);
+  TEST("grid node query", hits.size() == 1 && grid.node(hits[0]).slot == 410);
+
+  ViewContext view;
+  view.showMinimap = false;
+  view.showHelp = false;
+  view.panX = 13;
+  view.panY = 9;
+  SearchState search;
+  input::ShortcutManager shortcuts;
+  render::ConsoleRenderer renderer;
+  renderer.initialize(view.width, view.height);
+  renderer.renderWithUI(g, view, search, shortcuts);
+
+  // Reference: draw every edge once, oriented top-to-bottom, and let the buffer clip.
+  render::FrameBuffer ref(view.width, view.height);
+  for (const auto& node : g.nodes) {
+    const auto& p1 = g.layoutPositions.at(node.index);
+    for (int nbr : node.neighbors) {
+      if (nbr < node.index) continue;
+      const auto& p2 = g.layoutPositions.at(nbr);
+      int x1 = static_cast<int>(p1.x + view.panX), y1 = static_cast<int>(p1.y + view.panY);
+      int x2 = static_cast<int>(p2.x + view.panX), y2 = static_cast<int>(p2.y + view.panY);
+      if (std::make_pair(y1, x1) > std::make_pair(y2, x2)) { std::swap(x1, x2); std::swap(y1, y2); }
+      ref.drawLine(x1, y1, x2, y2, '.', 1.0f);
+    }
+  }
+  render::LabelPlacer labels(view.width, view.height);
+  for (const auto& node : g.nodes) {
+    const auto& p = g.layoutPositions.at(node.index);
+    float x = p.x + view.panX, y = p.y + view.panY;
+    int size = g.calculateNodeSize(0, view.zoomLevel);
+    ref.drawRect(static_cast<int>(x - size / 2), static_cast<int>(y - size / 2), size, size, 'X', 0.0f);
+    labels.reserve(static_cast<int>(x - size / 2), static_cast<int>(y - size / 2), size, size);
+    labels.add({static_cast<int>(x), static_cast<int>(y), size, node.label, 0.0f, 0, 0, node.weight, node.index});
+  }
+  labels.place(ref);
+
+  bool same = true;
+  for (int y = 0; y < view.height; ++y) {
+    if (renderer.getFrameBuffer()->getRow(y) != ref.getRow(y)) same = false;
+  }
+  TEST("culled frame matches full draw", same);
+
+  // Moving the layout must rebuild the grid.
+  for (auto& [id, p] : g.layoutPositions) p.x += 500.0f;
+  g.touchLayout();
+  renderer.clear();
+  renderer.renderWithUI(g, view, search, shortcuts);
+  bool blank = true;
+  for (int y = 0; y < view.height; ++y) {
+    if (renderer.getFrameBuffer()->getRow(y).find_first_not_of(' ') != std::string_view::npos) blank = false;
+  }
+  TEST("grid rebuilt after layout change", blank);
+}
+
+void testEdgeLodBundles() {
+  render::EdgeLod lod(4.0f);
+  TEST("sub-cell edge skipped", !lod.add(1, 1, 2, 3) && lod.skipped() == 1);
+  lod.add(0, 0, 10, 0);
+  lod.add(11, 2, 2, 1);   // reversed, same cell pair
+  lod.add(0, 0, 0, 12);
+  TEST("edges binned per cell pair", lod.bundles().size() == 2 && lod.bundles()[0].count == 2);
+  TEST("bundle keeps mean endpoints", lod.bundles()[0].x1 == 1.0f && lod.bundles()[0].x2 == 10.5f);
+  TEST("density glyph ramp", render::EdgeLod::glyphFor(1) == '.' && render::EdgeLod::glyphFor(3) == ':' &&
+       render::EdgeLod::glyphFor(9) == '*');
+
+  // Zoomed out, a fan of parallel edges draws as one dense bundle.
+  Graph g;
+  for (int i = 0; i < 12; ++i) g.addNode(GraphNode("", i));
+  for (int i = 0; i < 6; ++i) {
+    g.addEdge(i, i + 6);
+    g.layoutPositions[i] = { 10.0f, 10.0f + (i % 2) };
+    g.layoutPositions[i + 6] = { 40.0f, 10.0f + (i % 2) };
+  }
+  g.touchLayout();
+  ViewContext view;
+  view.showMinimap = false;
+  view.showHelp = false;
+  view.zoomLevel = ZoomLevel::Z1;
+  SearchState search;
+  input::ShortcutManager shortcuts;
+  render::ConsoleRenderer renderer;
+  renderer.initialize(view.width, view.height);
+  renderer.renderWithUI(g, view, search, shortcuts);
+  std::string_view row = renderer.getFrameBuffer()->getRow(11); // mean of rows 10 and 11, rounded
+  TEST("zoomed-out edges drawn as one bundle", row.find('+') != std::string_view::npos &&
+       row.find('.') == std::string_view::npos);
+}
+
+void testSearchMatchMask() {
+  SearchState search;
+  search.setMatches({7, 2, 40});
+  TEST("match mask built from results", search.isMatch(2) && search.isMatch(40) && !search.isMatch(3) &&
+       !search.isMatch(41) && !search.isMatch(-1));
+  TEST("highlight requires active search", !search.isHighlighted(7));
+  search.isActive = true;
+  TEST("cursor starts on first match", search.isHighlighted(7) && search.getActiveMatchNodeId() == 7);
+  TEST("cursor wraps backwards", search.stepActiveMatch(-1) == 40 && search.activeMatchIndex == 2);
+  TEST("cursor wraps forwards", search.stepActiveMatch(1) == 7);
+  search.setMatches({});
+  TEST("empty result clears mask and cursor", !search.isMatch(7) && search.activeMatchIndex == -1 &&
+       search.stepActiveMatch(1) == -1);
+  search.setMatches({2000000000, 5, -3});
+  TEST("sparse ids skip the dense mask", search.matchMask.empty() && search.isMatch(2000000000) &&
+       search.isMatch(5) && !search.isMatch(6) && !search.isMatch(-3) && search.getActiveMatchNodeId() == 2000000000);
+  search.setMatches({7});
+  TEST("dense ids rebuild the mask", search.sparseMatches.empty() && search.isMatch(7) && !search.isMatch(2000000000));
+}
+
+void testLabelPlacement() {
+  render::LabelPlacer placer(20, 5);
+  placer.reserve(4, 2, 1, 1);
+  std::string a = "alpha", b = "beta", c = "gamma";
+  // Two nodes side by side: the heavier label wins the shared anchor, the other moves.
+  placer.add({4, 1, 1, b, 0.0f, 0, 1, 1, 0});
+  placer.add({4, 2, 1, a, 0.0f, 0, 1, 5, 1});
+  placer.add({4, 2, 1, c, 0.0f, 2, 3, 1, 2});
+  render::FrameBuffer fb(20, 5);
+  TEST("every label placed", placer.place(fb) == 3);
+  TEST("tier beats distance", fb.getRow(3).substr(5, 5) == "gamma");
+  TEST("weight picks next anchor", fb.getRow(2).substr(6, 5) == "alpha");
+  TEST("loser moves to a free anchor", fb.getRow(1).substr(6, 4) == "beta");
+  TEST("node cell never overwritten", fb.getRow(2)[4] == ' ' && placer.isOccupied(4, 2));
+
+  // Crowded single row: a label that no longer fits is truncated, then the row is full.
+  render::LabelPlacer row(8, 1);
+  std::string shortLabel = "abc", longLabel = "abcdef";
+  row.add({-1, -1, 1, shortLabel, 0.0f, 0, 0, 2, 0});
+  row.add({2, -1, 1, longLabel, 0.0f, 0, 0, 1, 1});
+  row.add({4, -1, 1, longLabel, 0.0f, 0, 0, 0, 2});
+  render::FrameBuffer strip(8, 1);
+  TEST("crowded labels truncate then drop", row.place(strip) == 2 && strip.getRow(0) == "abcabcde");
+}
+
+void testProcessTopicsMergesAcrossFiles() {
+  std::filesystem::path testIn = "tests/temp/processor_source_multi";
+  std::filesystem::path testOut = "tests/temp/processor_target_multi";
+  std::filesystem::remove_all(testIn);
+  std::filesystem::remove_all(testOut);
+  std::filesystem::create_directories(testIn);
+
+  // Shared topics across files must dedupe onto the first occurrence.
+  for (int i = 0; i < 16; ++i) {
+    std::ofstream ofs(testIn / ("part" + std::to_string(i) + ".txt"));
+    ofs << "Shared\nTopic" << i << "\n\nShared\r\nNote.";
+  }
+  TEST("processTopics succeeds on many files", tp::processTopics(testIn, testOut) == 0);
+
+  std::string line;
+  int rows = 0, sharedRows = 0;
+  {
+    std::ifstream csv(testOut / "output.csv");
+    std::getline(csv, line);
+    while (std::getline(csv, line)) {
+      ++rows;
+      if (line.rfind("\"Shared\",", 0) == 0) ++sharedRows;
+    }
+  }
+  TEST("processTopics merges shared topics", rows == 17 && sharedRows == 1);
+
+  int oneCount = 0, otherLines = 0;
+  {
+    std::ifstream ones(testOut / "onelines.txt");
+    while (std::getline(ones, line)) {
+      if (line == "Note.") ++oneCount;
+      else ++otherLines;
+    }
+  }
+  TEST("processTopics keeps every one-liner", oneCount == 16 && otherLines == 0);
+
+  std::filesystem::remove_all(testIn);
+  std::filesystem::remove_all(testOut);
+}
 
 void runAllTests() {
       testNodeCreationAndEdges();
@@ -333,6 +672,15 @@ void runAllTests() {
       testGraphSerialization();
       testGraphSerializationJSON();
       testBaselinePersistence();
+      testXmlTreeAndMeshExtraction();
+      testFrameBufferSpans();
+      testTerminalPresenterDiff();
+      testRenderPipelineFrames();
+      testFrustumCulledRender();
+      testEdgeLodBundles();
+      testSearchMatchMask();
+      testLabelPlacement();
+      testProcessTopicsMergesAcrossFiles();
 
       int total = testsPassed + testsFailed;
       std::cout << "\nResults: " << testsPassed
@@ -2,9 +2,30 @@
 #include "model/brain_model.h"
 #include "render/spatial_index.h"
 #include "model/model_repository.h"
+#include "model/atlas_cache.h"
+#include "model/core/DeterministicEventBus.h"
+#include "model/core/EventLog.h"
+#include "model/core/ModelGraphStore.h"
+#include "model/core/OverlayService.h"
+#include "model/core/SimulationKernel.h"
+#include "model/core/SystemScheduler.h"
+#include "model/app/IntegratedBrainModel.h"
+#include "model/domains/dopamine/DopamineDomainPlugin.h"
+#include "model/domains/emotion/EmotionDomainPlugin.h"
+#include "model/domains/synapse/SynapseDomainPlugin.h"
+#include "model/pathway_tessellator.h"
+#include "model/slice_cache.h"
+#include "model/slice_rasterizer.h"
+#include "input/input_manager.h"
+#include <algorithm>
 #include <iostream>
 #include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
 #include <fstream>
+#include <string>
+#include <thread>
 #include <vector>
 
 using namespace model;
@@ -39,6 +60,227 @@ void testOctreeSubdivision() {
     TEST_PHASE1("Octree range query", results2.size() == 3);
 }
 
+void testOctreeBulkBuild() {
+    Config::maxSpatialDepth = 8;
+    SpatialBounds bounds{-100, -100, -100, 100, 100, 100};
+    OctreeIndex index(bounds, 2);
+
+    std::vector<SpatialEntry> entries;
+    for (int i = 0; i < 64; ++i) {
+        entries.push_back({i, -90.0f + i * 3.0f, 10.0f, (i % 2) ? 40.0f : -40.0f});
+    }
+    entries.push_back({999, 500, 500, 500}); // outside bounds, dropped
+    index.build(entries);
+
+    auto all = index.queryRange(bounds);
+    TEST_PHASE1("Bulk build keeps in-bounds entries once", all.size() == 64);
+    auto upper = index.queryRange(SpatialBounds{-100, -100, 0, 100, 100, 100});
+    TEST_PHASE1("Bulk build octant query", upper.size() == 32);
+
+    index.clear();
+    TEST_PHASE1("Octree clear", index.queryRange(bounds).empty());
+    Config::maxSpatialDepth = 0;
+}
+
+void testFlatOctree() {
+    Config::maxSpatialDepth = 8;
+    SpatialBounds bounds{-100, -100, -100, 100, 100, 100};
+    std::vector<SpatialEntry> points;
+    for (int i = 0; i < 500; ++i) {
+        points.push_back({i, (i * 37) % 200 - 99.5f, (i * 91) % 200 - 99.5f, (i * 53) % 200 - 99.5f});
+    }
+    points.push_back({500, 0, 0, 0}); // on every splitting plane of the root
+
+    OctreeIndex incremental(bounds, 4);
+    for (const auto& p : points) incremental.insert(p.nodeId, p.x, p.y, p.z);
+    OctreeIndex bulk(bounds, 4);
+    bulk.build(points);
+
+    SpatialBounds box{-20, -50, 0, 60, 10, 100};
+    std::vector<int> expected;
+    for (const auto& p : points) {
+        if (p.x >= box.x1 && p.x <= box.x2 && p.y >= box.y1 && p.y <= box.y2 && p.z >= box.z1 && p.z <= box.z2) {
+            expected.push_back(p.nodeId);
+        }
+    }
+    std::vector<int> a, b;
+    incremental.queryRange(box, a);
+    bulk.queryRange(box, b);
+    std::sort(a.begin(), a.end());
+    std::sort(b.begin(), b.end());
+    TEST_PHASE1("Flat octree incremental matches brute force", a == expected);
+    TEST_PHASE1("Flat octree bulk build matches brute force", b == expected);
+    TEST_PHASE1("Flat octree subdivides", bulk.nodeCount() > 1 && incremental.size() == points.size());
+
+    std::vector<int> origin;
+    bulk.queryRange(SpatialBounds{0, 0, 0, 0, 0, 0}, origin);
+    TEST_PHASE1("Boundary point stored once", origin.size() == 1 && origin[0] == 500);
+
+    int visited = 0;
+    bulk.forEachInRange(bounds, [&](const SpatialEntry&) { return ++visited < 3; });
+    TEST_PHASE1("Visitor stops early", visited == 3);
+
+    TEST_PHASE1("Flat octree remove", incremental.remove(500, 0, 0, 0) && !incremental.remove(500, 0, 0, 0) &&
+                incremental.queryRange(SpatialBounds{0, 0, 0, 0, 0, 0}).empty());
+
+    std::vector<OctreeSnapshotNode> nodes;
+    std::vector<SpatialEntry> entries;
+    bulk.snapshot(nodes, entries);
+    OctreeIndex restored(bounds, 4);
+    std::vector<int> c;
+    bool ok = restored.restore(nodes.data(), nodes.size(), entries.data(), entries.size());
+    restored.queryRange(box, c);
+    std::sort(c.begin(), c.end());
+    TEST_PHASE1("Snapshot round trip", ok && c == expected);
+
+    // An entry moved out of its leaf's cell is rejected rather than silently lost to queries.
+    std::swap(entries.front(), entries.back());
+    TEST_PHASE1("Misplaced snapshot entry rejected",
+                !restored.restore(nodes.data(), nodes.size(), entries.data(), entries.size()) && restored.size() == 0);
+
+    Graph g;
+    for (int i = 0; i < 3; ++i) g.nodePos[i] = {float(i), float(i), float(i)};
+    OctreeIndex graphIndex(bounds);
+    graphIndex.buildFromNodePositions(g);
+    TEST_PHASE1("Index graph positions", graphIndex.queryRange(SpatialBounds{0.5f, 0.5f, 0.5f, 5, 5, 5}).size() == 2);
+    Config::maxSpatialDepth = 0;
+}
+
+void testSpatialQueries() {
+    Config::maxSpatialDepth = 8;
+    SpatialBounds bounds{-100, -100, -100, 100, 100, 100};
+    std::vector<SpatialEntry> points;
+    for (int i = 0; i < 200; ++i) { // distinct positions, so no distance ties
+        points.push_back({i, (i * 37) % 200 - 99.5f, (i * 91) % 200 - 99.5f, (i * 53) % 200 - 99.5f});
+    }
+    OctreeIndex index(bounds, 4);
+    index.build(points);
+
+    auto dist = [](const SpatialEntry& e, float x, float y, float z) {
+        return std::sqrt((e.x - x) * (e.x - x) + (e.y - y) * (e.y - y) + (e.z - z) * (e.z - z));
+    };
+    std::vector<std::pair<float, int>> byDistance;
+    for (const auto& p : points) byDistance.push_back({dist(p, 3, -7, 11), p.nodeId});
+    std::sort(byDistance.begin(), byDistance.end());
+
+    auto hits = index.nearest(3, -7, 11, 5);
+    bool ordered = hits.size() == 5;
+    for (size_t i = 0; ordered && i < hits.size(); ++i) ordered = hits[i].nodeId == byDistance[i].second;
+    TEST_PHASE1("k-NN returns the k closest in order", ordered);
+    TEST_PHASE1("k-NN respects max distance",
+                index.nearest(3, -7, 11, 50, (byDistance[2].first + byDistance[3].first) / 2).size() == 3);
+
+    std::vector<int> inRadius;
+    index.queryRadius(3, -7, 11, 40, inRadius);
+    size_t expected = std::count_if(byDistance.begin(), byDistance.end(),
+                                    [](const std::pair<float, int>& d) { return d.first <= 40; });
+    TEST_PHASE1("Radius query matches brute force", inRadius.size() == expected);
+
+    // Ray along +z through a column of points picks the first one it passes.
+    OctreeIndex column(bounds, 2);
+    std::vector<SpatialEntry> stack;
+    for (int i = 0; i < 10; ++i) stack.push_back({i, 5.0f, 5.0f, 40.0f - i * 8.0f});
+    stack.push_back({99, 30.0f, 5.0f, -90.0f});
+    column.build(stack);
+    SpatialHit hit{};
+    TEST_PHASE1("Ray hits the nearest entry along it",
+                column.raycast(SpatialRay{5.2f, 5.1f, -100.0f, 0, 0, 1}, 0.5f, hit) && hit.nodeId == 9);
+    TEST_PHASE1("Segment stops short", !column.raycast(SpatialRay{5, 5, -100, 0, 0, 1, 40.0f}, 0.5f, hit));
+    TEST_PHASE1("Ray misses outside radius", !column.raycast(SpatialRay{7, 5, -100, 0, 0, 1}, 0.5f, hit));
+
+    // Right-click picking through the layout index.
+    Graph g;
+    g.layoutPositions[1] = {10.2f, 4.9f};
+    g.layoutPositions[2] = {10.7f, 4.1f};
+    g.nodePos[1] = {0, 0, 2};
+    g.nodePos[2] = {0, 0, 1};
+    OctreeIndex layout(bounds);
+    layout.buildFromLayout(g);
+    input::InputManager input;
+    input.setPickIndex(&layout);
+    ViewContext view;
+    view.panX = 3;
+    view.panY = 1;
+    input.processMouse(view, 13, 5, false, true);
+    TEST_PHASE1("Mouse pick takes the front-most node", input.getPickedNode() == 2);
+    TEST_PHASE1("Mouse pick on empty cell", input.pickNode(view, 20, 20) == -1);
+    Config::maxSpatialDepth = 0;
+}
+
+void testChunkedAtlasParse() {
+    auto& repo = ModelRepository::getInstance();
+    repo.clearAll();
+
+    std::ofstream tmp("tests/temp/tmp_atlas_chunked.csv", std::ios::binary);
+    tmp << "# comment\r\n";
+    tmp << "REGION,CTX,Cortex,0,0,0,50\r\n";
+    tmp << "REGION,BAD,Short,1,2\n";
+    tmp << "REGION,PFC,Prefrontal, 10,+20,-5.5,8,PFC,0,0,CTX\r\n";
+    tmp << "PATHWAY,P1,Link,CTX,PFC,1,0.75,2\n";
+    tmp << "PATHWAY,P2,Broken,CTX,PFC,x";
+    tmp.close();
+
+    repo.loadAtlas("tests/temp/tmp_atlas_chunked.csv");
+    const auto& model = repo.getModel();
+    const BrainRegion* pfc = model.getRegion("PFC");
+    TEST_PHASE1("Chunked parse region count", model.getRegions().size() == 2);
+    TEST_PHASE1("Chunked parse numeric fields", pfc && pfc->center.y == 20.0f && pfc->center.z == -5.5f);
+    TEST_PHASE1("Chunked parse strips CR", pfc && pfc->parentId == "CTX");
+    TEST_PHASE1("Chunked parse pathways", model.getPathways().size() == 1 &&
+                model.getPathway("P1")->strength == 0.75f);
+    TEST_PHASE1("Bulk index finds region", model.findRegionAt({1, 1, 1}) == "CTX");
+}
+
+void testAtlasBinaryCache() {
+    auto& repo = ModelRepository::getInstance();
+    repo.clearAll();
+    Config::maxSpatialDepth = 4;
+
+    const std::string path = "tests/temp/tmp_atlas_cached.csv";
+    const std::string cachePath = AtlasCache::cachePathFor(path);
+    std::remove(cachePath.c_str());
+    {
+        std::ofstream tmp(path);
+        tmp << "REGION,CTX,Cortex,0,0,0,50,CTX,1,2,\n";
+        tmp << "REGION,PFC,Prefrontal,30,20,-10,8,PFC,0,0,CTX\n";
+        tmp << "REGION,OCC,Occipital,-40,-40,-40,6\n";
+        tmp << "PATHWAY,P1,Link,CTX,PFC,1,0.75,2\n";
+    }
+
+    repo.loadAtlas(path);
+    std::ifstream written(cachePath, std::ios::binary);
+    TEST_PHASE1("Atlas cache written on first load", written.good());
+    written.close();
+
+    repo.clearAll();
+    repo.loadAtlas(path);
+    const auto& model = repo.getModel();
+    const BrainRegion* pfc = model.getRegion("PFC");
+    TEST_PHASE1("Cached load restores regions", model.getRegions().size() == 3 && pfc &&
+                pfc->center.x == 30.0f && pfc->parentId == "CTX" && pfc->radius == 8.0f);
+    TEST_PHASE1("Cached load restores pathways", model.getPathways().size() == 1 &&
+                model.getPathway("P1")->strength == 0.75f);
+    TEST_PHASE1("Cached load answers region lookups", model.findRegionAt({-40, -40, -40}) == "OCC" &&
+                model.findRegionAt({31, 20, -10}) == "PFC");
+
+    // Editing the source invalidates the cache.
+    {
+        std::ofstream tmp(path, std::ios::app);
+        tmp << "REGION,CB,Cerebellum,0,-60,-30,5\n";
+    }
+    repo.clearAll();
+    repo.loadAtlas(path);
+    TEST_PHASE1("Stale cache ignored", repo.getModel().getRegions().size() == 4);
+
+    // A truncated cache falls back to parsing.
+    std::filesystem::resize_file(cachePath, 64);
+    repo.clearAll();
+    repo.loadAtlas(path);
+    TEST_PHASE1("Corrupt cache falls back to source", repo.getModel().getRegions().size() == 4 &&
+                repo.getModel().findRegionAt({0, -60, -30}) == "CB");
+    Config::maxSpatialDepth = 0;
+}
+
 void testSplineInterpolationPoints() {
     BrainPathway pathway;
     pathway.controlPoints = { {0,0,0}, {10,10,10}, {20,0,20} };
@@ -49,6 +291,418 @@ void testSplineInterpolationPoints() {
     TEST_PHASE1("Spline end point", points.back().x == 20);
 }
 
+void testPathwayTessellator() {
+    BrainModel model;
+    BrainPathway curved;
+    curved.id = "ARC";
+    curved.controlPoints = {{0, 0, 0}, {10, 10, 10}, {20, 0, 20}, {35, -5, 5}};
+    BrainPathway straight;
+    straight.id = "LINE";
+    straight.controlPoints = {{0, 0, 0}, {5, 0, 0}};
+    model.addPathways({curved, straight});
+
+    PathwayTessellator tessellator(0.5f);
+    size_t built = tessellator.tessellate(model, 1.0f);
+    const TessellatedPathway* arc = tessellator.get("ARC");
+    size_t coarse = arc ? arc->size() : 0;
+    TEST_PHASE1("Tessellates every pathway", built == 2 && arc && tessellator.get("LINE")->size() >= 2);
+    TEST_PHASE1("Tessellation keeps the end points",
+                arc && arc->x[0] == 0.0f && arc->x.back() == 35.0f && arc->z.back() == 5.0f);
+    TEST_PHASE1("Unchanged pathways come from the cache", tessellator.tessellate(model, 0.9f) == 0);
+
+    tessellator.tessellate(model, 16.0f);
+    arc = tessellator.get("ARC");
+    TEST_PHASE1("Closer zoom adds segments", arc->size() > coarse);
+
+    // Every point of a dense reference sampling lies within the tolerance of the polyline.
+    float worst = 0.0f;
+    for (const auto& p : model.getPathway("ARC")->getInterpolatedPoints(64)) {
+        float best = INFINITY;
+        for (size_t i = 0; i + 1 < arc->size(); ++i) {
+            float ax = arc->x[i], ay = arc->y[i], az = arc->z[i];
+            float dx = arc->x[i + 1] - ax, dy = arc->y[i + 1] - ay, dz = arc->z[i + 1] - az;
+            float len2 = dx * dx + dy * dy + dz * dz;
+            float t = len2 > 0 ? std::clamp(((p.x - ax) * dx + (p.y - ay) * dy + (p.z - az) * dz) / len2, 0.0f, 1.0f) : 0.0f;
+            float ex = ax + t * dx - p.x, ey = ay + t * dy - p.y, ez = az + t * dz - p.z;
+            best = std::min(best, std::sqrt(ex * ex + ey * ey + ez * ez));
+        }
+        worst = std::max(worst, best);
+    }
+    TEST_PHASE1("Tessellation stays within tolerance", worst * 16.0f <= 0.5f);
+
+    curved.controlPoints.back() = {40, 0, 0};
+    model.addPathway(curved);
+    model.removePathway("LINE");
+    TEST_PHASE1("Edited pathway is re-tessellated", tessellator.tessellate(model, 16.0f) == 1 &&
+                tessellator.get("ARC")->x.back() == 40.0f && tessellator.size() == 1);
+}
+
+void testSymbolInterning() {
+    Symbol a("AMYG_L");
+    Symbol b(std::string("AMYG_") + "L");
+    TEST_PHASE1("Equal strings share a handle", a == b && a.handle() == b.handle() && a.handle() != 0);
+    TEST_PHASE1("Empty symbol is handle zero", Symbol().empty() && Symbol("").handle() == 0);
+    TEST_PHASE1("Symbol reads back its text", a.str() == "AMYG_L" && a == "AMYG_L" && "AMYG_L" == a && a.substr(0, 4) == "AMYG");
+
+    size_t before = Symbol::tableSize();
+    TEST_PHASE1("Find does not intern", Symbol::find("never-interned-id").empty() && Symbol::tableSize() == before &&
+                Symbol::find("AMYG_L") == a);
+    TEST_PHASE1("Symbols order by text", !(Symbol("zeta") < Symbol("alpha")) && Symbol("alpha") < Symbol("zeta"));
+
+    // Concurrent interning agrees on one handle per string.
+    std::vector<std::vector<uint32_t>> handles(4);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([t, &handles] {
+            for (int i = 0; i < 5000; ++i) handles[t].push_back(Symbol("sym-" + std::to_string(i)).handle());
+        });
+    }
+    for (auto& th : threads) th.join();
+    bool agree = true;
+    for (int t = 1; t < 4; ++t) agree = agree && handles[t] == handles[0];
+    TEST_PHASE1("Concurrent interning is consistent", agree && Symbol::fromHandle(handles[0][4321]) == "sym-4321");
+}
+
+void testModelGraphStoreVersions() {
+    using brain_model::core::ModelGraphStore;
+    using brain_model::core::contracts::GraphNode;
+    ModelGraphStore store;
+    std::vector<GraphNode> batch;
+    for (int i = 0; i < 300; ++i) {
+        batch.push_back({"n" + std::to_string(i), i % 3 == 0 ? "anatomy" : "function", i % 2 ? "region" : "tract",
+                         {{"weight", i}, {"label", std::string("L") + std::to_string(i)}}});
+    }
+    store.add_nodes(batch);
+    TEST_PHASE1("Batch write is one version", store.current_version() == 1 && store.snapshot().node_count() == 300);
+    TEST_PHASE1("Domain index returns only matches", store.find_nodes_by_domain("anatomy").size() == 100 &&
+                store.find_nodes_by_domain("unknown-domain").empty());
+    TEST_PHASE1("Type index returns only matches", store.find_nodes_by_type("region").size() == 150);
+
+    auto pinned = store.snapshot();
+    store.add_node({"n3", "function", "region", {{"weight", 99}}});
+    store.add_node({"extra", "anatomy", "tract", {}});
+    const auto* n3 = store.snapshot().node(Symbol("n3"));
+    TEST_PHASE1("Rewrite moves node between domains", store.find_nodes_by_domain("anatomy").size() == 100 &&
+                n3 && n3->domain == "function" && std::get<int>(*n3->attribute(Symbol("weight"))) == 99 &&
+                !n3->attribute(Symbol("label")));
+    size_t pinnedAnatomy = 0;
+    pinned.for_each_node_in_domain(Symbol("anatomy"), [&](const ModelGraphStore::NodeRecord&) { ++pinnedAnatomy; });
+    TEST_PHASE1("Pinned snapshot ignores later writes", pinned.version() == 1 && pinnedAnatomy == 100 &&
+                pinned.node(Symbol("n3"))->domain == "anatomy" && !pinned.node(Symbol("extra")));
+
+    store.checkout_version(1);
+    auto node = store.get_node("n3");
+    TEST_PHASE1("Checkout restores earlier state", store.current_version() == 1 && !store.get_node("extra") &&
+                node && node->domain == "anatomy" && std::get<std::string>(node->attributes.at("label")) == "L3");
+    store.add_edge({"e1", "n0", "n1", "anatomy", {}});
+    TEST_PHASE1("Writes after checkout continue the history", store.current_version() == 2 &&
+                store.snapshot().edge_count() == 1 && store.snapshot_at(1).edge_count() == 0);
+}
+
+void testModelGraphStoreHistory() {
+    using brain_model::core::ModelGraphStore;
+    ModelGraphStore store;
+    store.add_node({"first", "anatomy", "region", {}});
+    auto early = store.snapshot();
+    store.set_history_limit(64);
+    for (int i = 0; i < 10000; ++i) store.add_node({"h" + std::to_string(i), "anatomy", "region", {}});
+    TEST_PHASE1("History stays within its limit", store.retained_versions() == 64 &&
+                store.current_version() == 10001 && store.snapshot().node_count() == 10001);
+    TEST_PHASE1("Released versions resolve to the head", store.snapshot_at(1).version() == 10001 &&
+                store.snapshot_at(9990).node_count() == 9990);
+    TEST_PHASE1("Pinned snapshot outlives its release", early.version() == 1 && early.node_count() == 1 &&
+                early.node(Symbol("first")) && !early.node(Symbol("h0")));
+
+    store.checkout_version(5);
+    store.release_versions_before(9995);
+    TEST_PHASE1("Release keeps later versions", store.current_version() == 10001 && store.retained_versions() == 7 &&
+                store.snapshot_at(9995).node_count() == 9995);
+    store.release_versions_before(20000);
+    store.checkout_version(9995);
+    TEST_PHASE1("Release never drops the head", store.retained_versions() == 1 && store.current_version() == 10001);
+}
+
+void testModelGraphStoreTraversal() {
+    using brain_model::core::ModelGraphStore;
+    using brain_model::core::contracts::GraphEdge;
+    using brain_model::core::contracts::GraphNode;
+    ModelGraphStore store;
+    // Chain a0 -> a1 -> ... -> a5 in anatomy, with a function-domain shortcut a0 -> f0 -> a4.
+    std::vector<GraphNode> nodes;
+    for (int i = 0; i < 6; ++i) nodes.push_back({"a" + std::to_string(i), "anatomy", "region", {}});
+    nodes.push_back({"f0", "function", "network", {}});
+    store.add_nodes(nodes);
+    std::vector<GraphEdge> edges;
+    for (int i = 0; i < 5; ++i) {
+        edges.push_back({"c" + std::to_string(i), "a" + std::to_string(i), "a" + std::to_string(i + 1), "anatomy",
+                         {{"kind", std::string("structural")}}});
+    }
+    edges.push_back({"x0", "a0", "f0", "cross", {{"kind", std::string("functional")}}});
+    edges.push_back({"x1", "f0", "a4", "cross", {{"kind", std::string("functional")}}});
+    store.add_edges(edges);
+
+    TEST_PHASE1("Adjacency indexes both endpoints", store.get_out_edges("a0").size() == 2 &&
+                store.get_in_edges("a4").size() == 2 && store.get_in_edges("a0").empty() &&
+                store.get_edge("x1")->target_id == "a4");
+    TEST_PHASE1("K-hop neighborhood is nearest first", store.get_neighborhood("a0", 2, "") ==
+                std::vector<std::string>({"a1", "f0", "a2", "a4"}));
+    TEST_PHASE1("Neighborhood filters by node domain", store.get_neighborhood("a0", 1, "anatomy") ==
+                std::vector<std::string>({"a1"}));
+    TEST_PHASE1("Shortest path takes the shortcut", store.find_shortest_path("a0", "a5") ==
+                std::vector<std::string>({"a0", "f0", "a4", "a5"}) && store.find_shortest_path("a5", "a0").empty());
+
+    auto snapshot = store.snapshot();
+    ModelGraphStore::EdgeFilter structural;
+    structural.attribute = Symbol("kind");
+    structural.value = std::string("structural");
+    TEST_PHASE1("Attribute filter restricts traversal", snapshot.shortest_path(Symbol("a0"), Symbol("a5"), structural).size() == 6);
+    TEST_PHASE1("Reverse traversal follows in-edges",
+                snapshot.neighborhood(Symbol("a5"), 1, {}, ModelGraphStore::Direction::In).size() == 1);
+
+    store.add_edge({"x1", "f0", "a3", "cross", {}});
+    size_t intoA4 = 0;
+    store.snapshot().for_each_in_edge(Symbol("a4"), [&](const ModelGraphStore::EdgeRecord&) { ++intoA4; });
+    size_t pinnedIntoA4 = 0;
+    snapshot.for_each_in_edge(Symbol("a4"), [&](const ModelGraphStore::EdgeRecord&) { ++pinnedIntoA4; });
+    TEST_PHASE1("Rewired edge leaves its old target", intoA4 == 1 && pinnedIntoA4 == 2 &&
+                store.get_in_edges("a3").size() == 2);
+}
+
+void testEventBusDispatch() {
+    using brain_model::core::DeterministicEventBus;
+    using brain_model::core::contracts::Event;
+    DeterministicEventBus bus;
+    std::vector<std::string> log;
+    bus.subscribe("tick", [&](const Event& e) {
+        log.push_back("tick" + std::to_string(std::get<int64_t>(e.payload)));
+        bus.publish({"tock", e.timestamp_ms, e.payload});
+    });
+    bus.subscribe("tock", [&](const Event& e) { log.push_back("tock" + std::to_string(std::get<int64_t>(e.payload))); });
+
+    bus.start_recording();
+    bus.publish({"tick", 1, int64_t(1)});
+    bus.publish({"tick", 2, int64_t(2)});
+    bus.stop_recording();
+    TEST_PHASE1("Handlers publish without deadlock, cascades in order",
+                log == std::vector<std::string>({"tick1", "tock1", "tick2", "tock2"}));
+
+    auto history = bus.get_recorded_history();
+    log.clear();
+    bus.replay(history);
+    TEST_PHASE1("Replay reproduces the recorded cascade", history.size() == 4 &&
+                log == std::vector<std::string>({"tick1", "tock1", "tick2", "tock2"}));
+
+    // Several producers: every event is delivered once, each producer's in order.
+    DeterministicEventBus shared;
+    const int producers = 4, perProducer = 50000;
+    std::vector<int64_t> lastSeen(producers, -1);
+    bool ordered = true;
+    size_t delivered = 0;
+    shared.subscribe("count", [&](const Event& e) {
+        int64_t v = std::get<int64_t>(e.payload);
+        int64_t& last = lastSeen[v >> 32];
+        ordered = ordered && (v & 0xffffffff) == last + 1;
+        last = v & 0xffffffff;
+        ++delivered;
+    });
+    std::vector<std::thread> threads;
+    for (int t = 0; t < producers; ++t) {
+        threads.emplace_back([&, t] {
+            for (int64_t i = 0; i < perProducer; ++i) shared.publish({"count", 0, (int64_t(t) << 32) | i});
+        });
+    }
+    for (auto& th : threads) th.join();
+    TEST_PHASE1("Multi-producer dispatch delivers everything in producer order",
+                ordered && delivered == size_t(producers) * perProducer);
+}
+
+void testEventLogReplay() {
+    using brain_model::core::DeterministicEventBus;
+    using brain_model::core::EventLogReader;
+    using brain_model::core::EventLogWriter;
+    using brain_model::core::contracts::Event;
+    using brain_model::core::contracts::EventPayload;
+    const std::string path = "tests/temp/tmp_events.bin";
+    auto payloadFor = [](int i) -> EventPayload {
+        switch (i % 4) {
+            case 0: return int64_t(-i);
+            case 1: return i * 0.5;
+            case 2: return Symbol(i % 8 == 2 ? "AMYG_L" : "HIPP_R");
+            default: return std::array<float, 3>{float(i), 1.0f, -2.0f};
+        }
+    };
+
+    const int count = 10000;
+    DeterministicEventBus bus;
+    bus.subscribe("spike", [](const Event&) {});
+    TEST_PHASE1("Recording to a log opens the file", bus.start_recording_to(path));
+    for (int i = 0; i < count; ++i) bus.publish({i % 3 ? "spike" : "burst", uint64_t(i), payloadFor(i)});
+    bus.stop_recording();
+    TEST_PHASE1("File recording keeps nothing in memory", bus.get_recorded_history().empty() &&
+                std::filesystem::file_size(path) < size_t(count) * 12);
+
+    EventLogReader reader(path);
+    Event e;
+    int read = 0;
+    bool same = true;
+    while (reader.next(e)) {
+        same = same && e.type == (read % 3 ? "spike" : "burst") && e.timestamp_ms == uint64_t(read) && e.payload == payloadFor(read);
+        ++read;
+    }
+    TEST_PHASE1("Log round-trips every event", reader.is_open() && read == count && same &&
+                reader.checkpoint_count() == (count + EventLogWriter::kDefaultEventsPerCheckpoint - 1) / EventLogWriter::kDefaultEventsPerCheckpoint);
+
+    std::vector<uint64_t> replayed;
+    DeterministicEventBus player;
+    player.subscribe("spike", [&](const Event& ev) { replayed.push_back(ev.timestamp_ms); });
+    player.subscribe("burst", [&](const Event& ev) { replayed.push_back(ev.timestamp_ms); });
+    TEST_PHASE1("Replay seeks to a timestamp", player.replay_from(path, 9000) && replayed.size() == 1000 &&
+                replayed.front() == 9000 && replayed.back() == uint64_t(count - 1));
+
+    // A log cut short (no footer) is still readable up to the damage.
+    {
+        EventLogWriter writer(path, 100);
+        for (int i = 0; i < 1000; ++i) writer.append({"spike", uint64_t(i), payloadFor(i)});
+    }
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 600);
+    EventLogReader truncated(path);
+    truncated.seek(500);
+    int tail = 0;
+    while (truncated.next(e)) ++tail;
+    TEST_PHASE1("Truncated log rebuilds its index", truncated.is_open() && truncated.checkpoint_count() == 10 &&
+                tail > 400 && tail < 500);
+    std::filesystem::remove(path);
+}
+
+namespace {
+
+// Emits one overlay per tick carrying its seed and how many "a" overlays it could see.
+class ProbeSystem : public brain_model::core::contracts::ISimulationSystem {
+public:
+    ProbeSystem(std::string name, brain_model::core::contracts::SystemAccess access)
+        : m_name(std::move(name)), m_access(std::move(access)) {}
+    std::string name() const override { return m_name; }
+    brain_model::core::contracts::SystemAccess access() const override { return m_access; }
+    void update(brain_model::core::contracts::SystemContext& context) override {
+        size_t seen = context.overlays.get_active_overlays_for_entity("probe_a").size();
+        brain_model::core::contracts::OverlaySpec spec;
+        spec.id = m_name;
+        spec.anchor_entity_id = m_name == "a" ? "probe_a" : "probe";
+        spec.text = m_name + ":" + std::to_string(context.seed) + ":" + std::to_string(seen);
+        context.overlays.add_overlay(spec);
+    }
+
+private:
+    std::string m_name;
+    brain_model::core::contracts::SystemAccess m_access;
+};
+
+std::vector<std::string> runProbeScheduler(uint64_t seed, size_t threads, size_t& stages, uint32_t& steps) {
+    using namespace brain_model::core;
+    auto kernel = std::make_shared<SimulationKernel>();
+    auto overlays = std::make_shared<OverlayService>();
+    kernel->set_seed(seed);
+    kernel->resume();
+    SystemScheduler scheduler(kernel, overlays, nullptr, 16, threads);
+    scheduler.add_system(std::make_shared<ProbeSystem>("a", contracts::SystemAccess{{}, {"X"}}));
+    scheduler.add_system(std::make_shared<ProbeSystem>("b", contracts::SystemAccess{{"X"}, {}}));
+    for (int i = 0; i < 6; ++i) {
+        scheduler.add_system(std::make_shared<ProbeSystem>("c" + std::to_string(i), contracts::SystemAccess{{}, {"Y" + std::to_string(i)}}));
+    }
+    stages = scheduler.stage_count();
+    steps = scheduler.advance(40);
+    std::vector<std::string> texts;
+    for (const auto& spec : overlays->get_active_overlays_for_entity("probe")) texts.push_back(spec.text);
+    return texts;
+}
+
+// Adds one node per update, recording how many nodes it could read.
+class GraphProbeSystem : public brain_model::core::contracts::ISimulationSystem {
+public:
+    explicit GraphProbeSystem(std::string name) : m_name(std::move(name)) {}
+    std::string name() const override { return m_name; }
+    brain_model::core::contracts::SystemAccess access() const override { return {{}, {m_name}}; }
+    void update(brain_model::core::contracts::SystemContext& context) override {
+        brain_model::core::contracts::GraphNode node;
+        node.id = m_name + "@" + std::to_string(context.time_ms);
+        node.domain = "probe";
+        node.attributes["seen"] = static_cast<int>(context.store->find_nodes_by_domain("probe").size());
+        context.graph.add_node(node);
+    }
+
+private:
+    std::string m_name;
+};
+
+std::vector<std::string> runGraphProbeScheduler(size_t threads, uint32_t& version) {
+    using namespace brain_model::core;
+    auto kernel = std::make_shared<SimulationKernel>();
+    auto store = std::make_shared<ModelGraphStore>();
+    kernel->resume();
+    SystemScheduler scheduler(kernel, std::make_shared<OverlayService>(), store, 16, threads);
+    for (int i = 0; i < 6; ++i) scheduler.add_system(std::make_shared<GraphProbeSystem>("g" + std::to_string(i)));
+    scheduler.advance(48);
+    version = store->current_version();
+    std::vector<std::string> nodes;
+    for (uint32_t v = 0; v <= version; ++v) nodes.push_back(std::to_string(store->snapshot_at(v).node_count()));
+    for (const auto& node : store->find_nodes_by_domain("probe")) {
+        nodes.push_back(node.id + "=" + std::to_string(std::get<int>(node.attributes.at("seen"))));
+    }
+    return nodes;
+}
+
+} // namespace
+
+void testSystemScheduler() {
+    size_t stages = 0;
+    uint32_t steps = 0;
+    auto serial = runProbeScheduler(7, 1, stages, steps);
+    TEST_PHASE1("Conflicting systems are staged apart", stages == 2 && steps == 2 && serial.size() == 7);
+    TEST_PHASE1("Later stage sees earlier overlays", serial[6].rfind("b:", 0) == 0 && serial[6].back() == '1' &&
+                serial[0].rfind("c0:", 0) == 0);
+
+    size_t parallelStages = 0;
+    uint32_t parallelSteps = 0;
+    auto parallel = runProbeScheduler(7, 4, parallelStages, parallelSteps);
+    auto reseeded = runProbeScheduler(8, 4, parallelStages, parallelSteps);
+    TEST_PHASE1("Parallel run matches the serial run", parallel == serial && reseeded != serial);
+
+    uint32_t serialVersion = 0;
+    uint32_t parallelVersion = 0;
+    auto serialGraph = runGraphProbeScheduler(1, serialVersion);
+    auto parallelGraph = runGraphProbeScheduler(4, parallelVersion);
+    TEST_PHASE1("Store writes are applied per system after the stage", serialVersion == 18 &&
+                serialGraph.size() == 19 + 18 && serialGraph[1] == "1" &&
+                std::count(serialGraph.begin(), serialGraph.end(), "g0@16=0") == 1 &&
+                std::count(serialGraph.begin(), serialGraph.end(), "g5@48=12") == 1);
+    TEST_PHASE1("Parallel store writes match the serial run", parallelVersion == serialVersion && parallelGraph == serialGraph);
+
+    auto kernel = std::make_shared<brain_model::core::SimulationKernel>();
+    auto overlays = std::make_shared<brain_model::core::OverlayService>();
+    brain_model::app::IntegratedBrainModel brain(kernel, overlays);
+    brain.add_domain(std::make_shared<brain_model::domains::synapse::SynapseDomainPlugin>());
+    brain.add_domain(std::make_shared<brain_model::domains::dopamine::DopamineDomainPlugin>());
+    brain.add_domain(std::make_shared<brain_model::domains::emotion::EmotionDomainPlugin>());
+    TEST_PHASE1("Paused kernel runs no steps", brain.run_step(100) == 0);
+    kernel->resume();
+    bool ran = brain.run_step(20) == 1 && brain.scheduler().pending_ms() == 4;
+    const auto& stats = brain.scheduler().stats();
+    TEST_PHASE1("Domain systems are scheduled and timed", ran && stats.size() == 3 && stats[0].updates == 1 &&
+                stats[2].stage == 0 && !overlays->get_active_overlays_for_entity("synaptic_cleft").empty() &&
+                !overlays->get_active_overlays_for_entity("amygdala").empty());
+
+    auto overlayCount = [&] {
+        size_t n = 0;
+        for (const char* anchor : {"synaptic_cleft", "striatum_nodes", "ventral_tegmental_area", "limbic_system", "amygdala"}) {
+            n += overlays->get_active_overlays_for_entity(anchor).size();
+        }
+        return n;
+    };
+    size_t afterOne = overlayCount();
+    bool manySteps = brain.run_step(16 * 500) == 500;
+    TEST_PHASE1("Re-emitted overlays replace their previous spec", manySteps && afterOne == 6 && overlayCount() == afterOne);
+}
+
 void testModelVersioning() {
     BrainModel model;
     model.versionTag = "AAL3_v1";
@@ -95,6 +749,45 @@ void testHotReload() {
     TEST_PHASE1("Hot-Reload contains R2", repo.getModel().getRegion("R2") != nullptr);
 }
 
+void testIncrementalReloadChangeSet() {
+    auto& repo = ModelRepository::getInstance();
+    repo.clearAll();
+
+    std::ofstream tmp("tests/temp/tmp_atlas_diff.csv");
+    tmp << "REGION,A,Alpha,0,0,0,5\n";
+    tmp << "REGION,B,Beta,50,50,50,5\n";
+    tmp << "REGION,C,Gamma,-50,-50,-50,5\n";
+    tmp << "PATHWAY,P1,AB,A,B,0,1.0,0\n";
+    tmp.close();
+    repo.loadAtlas("tests/temp/tmp_atlas_diff.csv");
+
+    AtlasChangeSet seen;
+    int notifications = 0;
+    repo.addAtlasChangeListener([&](const AtlasChangeSet& c) { seen = c; ++notifications; });
+
+    // Unchanged file publishes nothing.
+    repo.reloadAtlas();
+    TEST_PHASE1("Reload without edits is silent", notifications == 0);
+
+    std::ofstream tmp2("tests/temp/tmp_atlas_diff.csv");
+    tmp2 << "REGION,A,Alpha,0,0,0,5\n";
+    tmp2 << "REGION,B,Beta,-80,80,0,5\n";
+    tmp2 << "REGION,D,Delta,20,20,20,5\n";
+    tmp2 << "PATHWAY,P1,AB,A,B,0,0.5,0\n";
+    tmp2.close();
+    repo.reloadAtlas();
+
+    const auto& model = repo.getModel();
+    TEST_PHASE1("Reload change set published", notifications == 1 && seen.modelVersion == model.getVersion());
+    TEST_PHASE1("Reload diff regions", seen.addedRegions == std::vector<RegionID>{"D"} &&
+                seen.removedRegions == std::vector<RegionID>{"C"} &&
+                seen.modifiedRegions == std::vector<RegionID>{"B"});
+    TEST_PHASE1("Reload diff pathways", seen.modifiedPathways.size() == 1 && seen.addedPathways.empty());
+    TEST_PHASE1("Moved region indexed at new position", model.findRegionAt({-80, 80, 0}) == "B");
+    TEST_PHASE1("Moved region gone from old position", model.findRegionAt({50, 50, 50}).empty());
+    TEST_PHASE1("Removed region unindexed", model.findRegionAt({-50, -50, -50}).empty());
+}
+
 void testProbabilisticMembership() {
     auto& repo = ModelRepository::getInstance();
 
@@ -116,15 +809,226 @@ void testProbabilisticMembership() {
 
 
 
+void testRegionBvhContainment() {
+    BrainModel model;
+    BrainRegion big;
+    big.id = "BIG";
+    big.center = {0, 0, 0};
+    big.radius = 50;
+    BrainRegion box;
+    box.id = "BOX";
+    box.center = {10, 10, 10};
+    box.radius = 20; // sphere reaches past the hull
+    box.convexHull = {{5, 5, 5}, {15, 5, 5}, {5, 15, 5}, {15, 15, 5},
+                      {5, 5, 15}, {15, 5, 15}, {5, 15, 15}, {15, 15, 15}, {10, 10, 15}};
+    BrainRegion flat = box;
+    flat.id = "FLAT";
+    flat.center = {-30, 0, 0};
+    flat.radius = 3;
+    flat.convexHull = {{-31, -1, 0}, {-29, -1, 0}, {-31, 1, 0}, {-29, 1, 0}}; // no volume
+    model.addRegions({big, box, flat});
+
+    TEST_PHASE1("Smallest containing region wins", model.findRegionAt({12, 8, 6}) == "BOX");
+    TEST_PHASE1("Hull is exact inside its sphere", model.findRegionAt({16, 10, 10}) == "BIG");
+    TEST_PHASE1("Flat hull falls back to sphere", model.findRegionAt({-30, 0, 2}) == "FLAT");
+    TEST_PHASE1("Outside every region", model.findRegionAt({90, 0, 0}).empty());
+    TEST_PHASE1("Point in convex hull", isPointInConvexHull({6, 14, 14}, box.convexHull) &&
+                !isPointInConvexHull({4.9f, 10, 10}, box.convexHull) && !isPointInConvexHull({0, 0, 0}, flat.convexHull));
+
+    model.removeRegion("BOX");
+    TEST_PHASE1("Hierarchy rebuilt after change", model.findRegionAt({12, 8, 6}) == "BIG");
+}
+
+void testSliceRasterizer() {
+    BrainModel model;
+    BrainRegion big;
+    big.id = "BIG";
+    big.center = {0, 0, 0};
+    big.radius = 60;
+    BrainRegion left = big;
+    left.id = "LEFT";
+    left.center = {-25, 10, 5};
+    left.radius = 22.5f;
+    BrainRegion box = big;
+    box.id = "BOX";
+    box.center = {10, 10, 10};
+    box.radius = 20;
+    box.convexHull = {{5, 5, 5}, {15, 5, 5}, {5, 15, 5}, {15, 15, 5},
+                      {5, 5, 15}, {15, 5, 15}, {5, 15, 15}, {15, 15, 15}};
+    BrainRegion wedge = big;
+    wedge.id = "WEDGE";
+    wedge.center = {30, -30, 0};
+    wedge.radius = 30;
+    wedge.convexHull = {{10, -50, -20}, {55, -40, -5}, {20, -5, 10}, {35, -35, 25}, {15, -20, -15}};
+    model.addRegions({big, left, box, wedge});
+
+    const int res = 160;
+    const float positions[] = {-7.3f, 0.0f, 9.0f, 12.5f};
+    const TextSlice::Plane planes[] = {TextSlice::Plane::Axial, TextSlice::Plane::Coronal,
+                                       TextSlice::Plane::Sagittal};
+    int mismatches = 0;
+    size_t painted = 0;
+    for (auto plane : planes) {
+        for (float pos : positions) {
+            TextCanvas canvas{res, res, std::vector<TextCell>(res * res)};
+            painted += SliceRasterizer::rasterize(*model.getRegionHierarchy(), plane, pos, 200.0f, canvas);
+            for (int y = 0; y < res; ++y) {
+                for (int x = 0; x < res; ++x) {
+                    float fx = (static_cast<float>(x) / res) * 200.0f - 100.0f;
+                    float fy = (static_cast<float>(y) / res) * 200.0f - 100.0f;
+                    Vec3 p = plane == TextSlice::Plane::Axial ? Vec3{fx, fy, pos}
+                           : plane == TextSlice::Plane::Coronal ? Vec3{fx, pos, fy} : Vec3{pos, fx, fy};
+                    const TextCell& cell = canvas.at(x, y);
+                    if (cell.regionId != model.findRegionAt(p) || cell.symbol != (cell.regionId.empty() ? '.' : '#')) {
+                        ++mismatches;
+                    }
+                }
+            }
+        }
+    }
+    TEST_PHASE1("Rasterized slices match point queries", mismatches == 0);
+    TEST_PHASE1("Rasterizer counts painted regions", painted > 12);
+
+    TextCanvas empty{res, res, std::vector<TextCell>(res * res)};
+    TEST_PHASE1("Slice beyond every region is empty",
+                SliceRasterizer::rasterize(*model.getRegionHierarchy(), TextSlice::Plane::Axial, 95.0f, 200.0f, empty) == 0 &&
+                empty.at(res / 2, res / 2).symbol == '.');
+}
+
+void testSliceCache() {
+    BrainModel model;
+    BrainRegion a;
+    a.id = "A";
+    a.regionCode = "AAA";
+    a.center = {0, 0, 0};
+    a.radius = 40;
+    BrainRegion b = a;
+    b.id = "B";
+    b.regionCode = "BBB";
+    b.center = {30, 10, 0};
+    b.radius = 15;
+    model.addRegions({a, b});
+
+    auto topology = createBrainTextTopology();
+    TextSlice first = topology->generateSlice(model, TextSlice::Plane::Axial, 0.0f, 100);
+    EncodedSlice encoded = EncodedSlice::encode(first);
+    TextSlice decoded = encoded.decode();
+    bool same = decoded.canvas.cells.size() == first.canvas.cells.size() && decoded.summary == first.summary;
+    for (size_t i = 0; same && i < first.canvas.cells.size(); ++i) {
+        same = decoded.canvas.cells[i].symbol == first.canvas.cells[i].symbol &&
+               decoded.canvas.cells[i].regionId == first.canvas.cells[i].regionId;
+    }
+    TEST_PHASE1("RLE slice round-trips", same);
+    TEST_PHASE1("RLE slice is smaller than its cells", encoded.runs.size() * 4 < first.canvas.cells.size());
+
+    TextSlice nearby = topology->generateSlice(model, TextSlice::Plane::Axial, 0.4f, 100);
+    TEST_PHASE1("Sub-pixel scrub reuses the cached slice",
+                topology->exportToPlainText(nearby) == topology->exportToPlainText(first) && nearby.position == 0.0f);
+
+    // Prefetched neighbors match slices built from scratch.
+    topology->precomputeSlices(model, TextSlice::Plane::Axial, 0.0f, 100, 3);
+    TextSlice prefetched = topology->generateSlice(model, TextSlice::Plane::Axial, 30.0f, 100);
+    TextSlice fresh = createBrainTextTopology()->generateSlice(model, TextSlice::Plane::Axial, 30.0f, 100);
+    TEST_PHASE1("Precomputed slice matches a fresh one",
+                topology->exportToPlainText(prefetched) == topology->exportToPlainText(fresh) &&
+                prefetched.summary == fresh.summary);
+
+    model.removeRegion("B");
+    TextSlice edited = topology->generateSlice(model, TextSlice::Plane::Axial, 0.0f, 100);
+    TEST_PHASE1("Model change invalidates cached slices", edited.summary != first.summary);
+
+    SliceCache cache(1u << 20);
+    SliceCache::Key key{1, TextSlice::Plane::Coronal, 0, 64};
+    for (int i = 0; i < 4; ++i) {
+        key.step = i;
+        cache.prefetch(key, [i] {
+            TextSlice s;
+            s.canvas = {64, 64, std::vector<TextCell>(64 * 64)};
+            s.canvas.at(i, i).symbol = '#';
+            return s;
+        });
+    }
+    cache.waitIdle();
+    TEST_PHASE1("Prefetch fills the cache", cache.size() == 4);
+    cache.setBudget(cache.footprint() / 2);
+    TextSlice out;
+    key.step = 0;
+    bool oldestEvicted = !cache.get(key, out);
+    key.step = 3;
+    TEST_PHASE1("Budget evicts least recently used slices",
+                cache.footprint() <= cache.budget() && oldestEvicted && cache.get(key, out) && out.canvas.at(3, 3).symbol == '#');
+}
+
+void testTopologyHashGrid() {
+    BrainModel model;
+    std::vector<BrainRegion> regions;
+    for (int i = 0; i < 3000; ++i) {
+        BrainRegion r;
+        r.id = "R" + std::to_string(i);
+        r.center = {static_cast<float>((i * 37) % 400) - 200.0f, static_cast<float>((i * 91) % 300) - 150.0f,
+                    static_cast<float>((i * 53) % 250) - 125.0f};
+        r.radius = (i % 17 == 0) ? 12.0f : 2.0f + (i % 5);
+        regions.push_back(r);
+    }
+    model.addRegions(regions);
+
+    auto indexer = createTopologyIndexer();
+    indexer->buildIndex(model);
+    int mismatches = 0;
+    size_t edges = 0;
+    for (const auto& [id, r1] : model.getRegions()) {
+        std::vector<RegionID> expected;
+        for (const auto& [otherId, r2] : model.getRegions()) {
+            if (otherId == id) continue;
+            float dx = r1.center.x - r2.center.x, dy = r1.center.y - r2.center.y, dz = r1.center.z - r2.center.z;
+            if (std::sqrt(dx * dx + dy * dy + dz * dz) < (r1.radius + r2.radius) * 1.2f) expected.push_back(otherId);
+        }
+        std::vector<RegionID> actual;
+        if (const RegionAdjacency* adjacency = indexer->getAdjacency(id)) {
+            for (const auto& e : adjacency->neighbors) actual.push_back(e.targetRegion);
+        }
+        std::sort(expected.begin(), expected.end());
+        std::sort(actual.begin(), actual.end());
+        if (expected != actual) ++mismatches;
+        edges += actual.size();
+    }
+    TEST_PHASE1("Hash grid adjacency matches pairwise scan", mismatches == 0 && edges > 0);
+    TEST_PHASE1("Unknown region has no adjacency", indexer->getAdjacency("missing") == nullptr);
+
+    auto topology = createBrainTextTopology();
+    auto around = topology->getNeighborhood(model, "R0");
+    TEST_PHASE1("Neighborhood reads the prebuilt index", around.size() == indexer->getAdjacency("R0")->neighbors.size());
+    model.removeRegion(around.empty() ? "R1" : around[0]);
+    TEST_PHASE1("Neighborhood follows model changes", topology->getNeighborhood(model, "R0").size() + (around.empty() ? 0 : 1) == around.size());
+}
+
 void runAll4Tests() {
     std::cout << "\n=== Running Phase 1 Enhancements Test Suite ===\n";
     testOctreeSubdivision();
+    testOctreeBulkBuild();
+    testFlatOctree();
+    testSpatialQueries();
+    testRegionBvhContainment();
+    testSliceRasterizer();
+    testSliceCache();
+    testTopologyHashGrid();
     testSplineInterpolationPoints();
+    testPathwayTessellator();
+    testSymbolInterning();
+    testModelGraphStoreVersions();
+    testModelGraphStoreHistory();
+    testModelGraphStoreTraversal();
+    testEventBusDispatch();
+    testEventLogReplay();
+    testSystemScheduler();
     testModelVersioning();
     testRegionHierarchyAccess();
     testSubjectMapping();
     testHotReload();
+    testIncrementalReloadChangeSet();
     testProbabilisticMembership();
+    testChunkedAtlasParse();
+    testAtlasBinaryCache();
 
 
     std::cout << "Phase 1 Results: " << testsPassed << " passed, " << testsFailed << " failed.\n";
@@ -1,6 +1,7 @@
 #include "test_logic.h"
 #include "testsuite2_logic.h"
 #include "testsuite3_logic.h"
+#include "testsuite4_logic.h"
 #include "dynamic_graph_tests.h"
 #include <iostream>
 
@@ -9,6 +10,7 @@ int main() {
     runAllTests();
     runAll2Tests();
     runAll3Tests();
+    runAll4Tests();
     runDynamicGraphTests();
     std::cout << "=== Unit Tests Completed ===\n";
     return 0;